@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the per-operation cost of constructing, connecting and starting a
+// small sender through exec's type-erased sender, compared to using the
+// concrete sender directly and to a with_hint sender whose hint matches or
+// misses the dynamic type.
+//
+// usage: benchmark.any_sender_dispatch [--filter=<text>] [--min-time=<secs>] [--json]
+
+#include <stdexec/execution.hpp>
+#include <exec/any_sender_of.hpp>
+
+#include "harness.hpp"
+
+#include <string>
+#include <utility>
+
+namespace ex = stdexec;
+
+namespace {
+  struct sink_receiver {
+    using is_receiver = void;
+    long* sum_;
+
+    friend void tag_invoke(ex::set_value_t, sink_receiver&& r, int v) noexcept {
+      *r.sum_ += v;
+    }
+
+    friend void tag_invoke(ex::set_stopped_t, sink_receiver&&) noexcept {
+    }
+
+    friend ex::empty_env tag_invoke(ex::get_env_t, const sink_receiver&) noexcept {
+      return {};
+    }
+  };
+
+  auto make_sender(int i) {
+    return ex::just(i) | ex::then([](int v) noexcept { return v + 1; });
+  }
+
+  auto make_other_sender(int i) {
+    return ex::just(i) | ex::then([](int v) noexcept { return v + 2; });
+  }
+
+  using sigs = ex::completion_signatures<ex::set_value_t(int), ex::set_stopped_t()>;
+  using any_sender_t = exec::any_receiver_ref<sigs>::any_sender<>;
+  using hinted_sender_t = any_sender_t::with_hint<decltype(make_sender(0))>;
+
+  // Stores every sender made by make in a Sender, then connects and starts it.
+  template <class Sender, class Make>
+  void add_benchmark(bench::suite& suite, std::string name, Make make) {
+    suite.add("any_sender_dispatch/" + std::move(name), [make](bench::state& state) {
+      long sum = 0;
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        Sender sndr = make(static_cast<int>(i));
+        auto op = ex::connect(std::move(sndr), sink_receiver{&sum});
+        ex::start(op);
+      }
+      bench::do_not_optimize(sum);
+    });
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::suite suite;
+  add_benchmark<decltype(make_sender(0))>(suite, "concrete", make_sender);
+  add_benchmark<any_sender_t>(suite, "any_sender", make_sender);
+  add_benchmark<hinted_sender_t>(suite, "with_hint:hit", make_sender);
+  add_benchmark<hinted_sender_t>(suite, "with_hint:miss", make_other_sender);
+  return suite.run(argc, argv);
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures how much of the halo exchange of a distributed stencil can be
+// hidden behind computation, in a single process.
+//
+// The grid of a 5-point Jacobi stencil is split by rows into "ranks", each of
+// which stores its rows plus a halo row above and below, as in
+// examples/nvexec/maxwell_distributed.cpp. Before a time step, every rank
+// needs the boundary rows of its neighbours in its halo rows. The exchange
+// runs on a separate "network" thread and only delivers the rows after a
+// given latency, which stands in for MPI or another transport.
+//
+// "sequential" waits for the exchange and then updates all the rows, like
+// the MPI_Waitall before each bulk in maxwell_distributed.cpp. "overlapped"
+// updates the interior rows, which do not read the halo, while the exchange
+// is in flight, and the two border rows of each rank once it has completed:
+//
+//   when_all(exchange, schedule(pool) | bulk(interior))
+//     | transfer(pool) | bulk(border)
+//
+// An operation is one time step and the throughput is reported in cells per
+// second.
+//
+// usage: benchmark.halo_exchange [--filter=<text>] [--threads=<n>] [--min-time=<secs>] [--json]
+//
+// --threads is the number of threads of the pool that runs the stencil.
+
+#include <stdexec/execution.hpp>
+#include <exec/single_thread_context.hpp>
+#include <exec/static_thread_pool.hpp>
+
+#include "harness.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ex = stdexec;
+
+namespace {
+  using clock = std::chrono::steady_clock;
+
+  // The rows of a grid of nx columns, split evenly across ranks. Each rank
+  // stores rows + 2 rows: its halo rows are the first and the last.
+  struct partitioned_grid {
+    std::size_t ranks;
+    std::size_t rows; // per rank
+    std::size_t nx;
+    std::vector<float> in;
+    std::vector<float> out;
+
+    partitioned_grid(std::size_t ranks, std::size_t rows, std::size_t nx)
+      : ranks{ranks}
+      , rows{rows}
+      , nx{nx}
+      , in((rows + 2) * nx * ranks)
+      , out((rows + 2) * nx * ranks) {
+      for (std::size_t i = 0; i < in.size(); ++i) {
+        in[i] = static_cast<float>(i % 17);
+      }
+    }
+
+    std::size_t cells() const noexcept {
+      return ranks * rows * nx;
+    }
+
+    // Row r of a rank, where rows 0 and rows + 1 are the halo.
+    float* row(std::vector<float>& field, std::size_t rank, std::size_t r) noexcept {
+      return field.data() + (rank * (rows + 2) + r) * nx;
+    }
+
+    // Copies the boundary rows of every rank into the halo rows of its
+    // neighbours. The grid is periodic.
+    void exchange() noexcept {
+      for (std::size_t rank = 0; rank < ranks; ++rank) {
+        const std::size_t above = (rank + ranks - 1) % ranks;
+        const std::size_t below = (rank + 1) % ranks;
+        std::memcpy(row(in, above, rows + 1), row(in, rank, 1), nx * sizeof(float));
+        std::memcpy(row(in, below, 0), row(in, rank, rows), nx * sizeof(float));
+      }
+    }
+
+    // Updates owned row r (in [1, rows]) of a rank.
+    void update(std::size_t rank, std::size_t r) noexcept {
+      const float* up = row(in, rank, r - 1);
+      const float* mid = row(in, rank, r);
+      const float* down = row(in, rank, r + 1);
+      float* dst = row(out, rank, r);
+      for (std::size_t x = 0; x < nx; ++x) {
+        const float left = mid[x == 0 ? nx - 1 : x - 1];
+        const float right = mid[x == nx - 1 ? 0 : x + 1];
+        dst[x] = 0.2f * (mid[x] + left + right + up[x] + down[x]);
+      }
+    }
+
+    // The updates by bulk index: all owned rows, the rows that do not read
+    // the halo, and the two rows next to the halo.
+    auto update_all() noexcept {
+      return [this](std::size_t i) noexcept {
+        update(i / rows, 1 + i % rows);
+      };
+    }
+
+    auto update_interior() noexcept {
+      return [this](std::size_t i) noexcept {
+        update(i / (rows - 2), 2 + i % (rows - 2));
+      };
+    }
+
+    auto update_border() noexcept {
+      return [this](std::size_t i) noexcept {
+        update(i / 2, i % 2 == 0 ? 1 : rows);
+      };
+    }
+  };
+
+  // Sends the halo rows over a simulated link: the rows arrive latency after
+  // the exchange is started. The link delivers on its own thread, so the
+  // exchange does not occupy a thread of the pool while in flight.
+  auto
+    exchange(exec::single_thread_context& link, partitioned_grid& grid, clock::duration latency) {
+    return ex::just() //
+         | ex::let_value([&link, &grid, latency] {
+             const clock::time_point arrival = clock::now() + latency;
+             return ex::schedule(link.get_scheduler()) | ex::then([&grid, arrival] {
+                      std::this_thread::sleep_until(arrival);
+                      grid.exchange();
+                    });
+           });
+  }
+
+  template <class Scheduler>
+  void step_sequential(
+    Scheduler sched,
+    exec::single_thread_context& link,
+    partitioned_grid& grid,
+    clock::duration latency) {
+    ex::sync_wait(
+      exchange(link, grid, latency) //
+      | ex::transfer(sched)         //
+      | ex::bulk(grid.ranks * grid.rows, grid.update_all()));
+    std::swap(grid.in, grid.out);
+  }
+
+  template <class Scheduler>
+  void step_overlapped(
+    Scheduler sched,
+    exec::single_thread_context& link,
+    partitioned_grid& grid,
+    clock::duration latency) {
+    ex::sync_wait(
+      ex::when_all(
+        exchange(link, grid, latency),
+        ex::schedule(sched) | ex::bulk(grid.ranks * (grid.rows - 2), grid.update_interior()))
+      | ex::transfer(sched) //
+      | ex::bulk(grid.ranks * 2, grid.update_border()));
+    std::swap(grid.in, grid.out);
+  }
+
+  // Both flows have to compute the same values.
+  bool flows_agree(exec::static_thread_pool::scheduler sched, exec::single_thread_context& link) {
+    partitioned_grid a{3, 5, 8};
+    partitioned_grid b{3, 5, 8};
+    for (int i = 0; i < 4; ++i) {
+      step_sequential(sched, link, a, clock::duration{});
+      step_overlapped(sched, link, b, clock::duration{});
+    }
+    for (std::size_t rank = 0; rank < a.ranks; ++rank) {
+      for (std::size_t r = 1; r <= a.rows; ++r) {
+        if (std::memcmp(a.row(a.in, rank, r), b.row(b.in, rank, r), a.nx * sizeof(float)) != 0) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+}
+
+int main(int argc, char** argv) {
+  using namespace std::chrono_literals;
+
+  const std::size_t threads = bench::suite::max_threads(argc, argv);
+  exec::static_thread_pool pool{static_cast<std::uint32_t>(threads)};
+  exec::single_thread_context link;
+  auto sched = pool.get_scheduler();
+
+  if (!flows_agree(sched, link)) {
+    std::fprintf(stderr, "halo_exchange: the overlapped flow computes different values\n");
+    return 1;
+  }
+
+  // 8 ranks of 128 rows of 1024 cells: about a millisecond per step on one
+  // core, against link latencies from negligible to comparable.
+  constexpr std::size_t ranks = 8;
+  constexpr std::size_t rows = 128;
+  constexpr std::size_t nx = 1024;
+  partitioned_grid grid{ranks, rows, nx};
+
+  bench::suite suite;
+  for (auto [latency, label]: {std::pair{10us, "10us"}, {100us, "100us"}, {500us, "500us"}}) {
+    const std::string suffix = "/latency:" + std::string(label);
+    const clock::duration delay = latency;
+
+    suite.add("halo_exchange/sequential" + suffix, [&, delay](bench::state& state) {
+      state.items_per_op = grid.cells();
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        step_sequential(sched, link, grid, delay);
+      }
+    });
+
+    suite.add("halo_exchange/overlapped" + suffix, [&, delay](bench::state& state) {
+      state.items_per_op = grid.cells();
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        step_overlapped(sched, link, grid, delay);
+      }
+    });
+  }
+
+  return suite.run(argc, argv);
+}
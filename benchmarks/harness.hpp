@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+// A small self-contained benchmark harness. Each benchmark body runs a given
+// number of operations; the harness calibrates the number so that a run
+// takes at least --min-time seconds and reports the wall-clock time and the
+// number of global operator new calls per operation. Benchmarks registered
+// with add_threaded are run on 1, 2, 4, ... up to --threads threads at once,
+// in which case the time per operation is the wall-clock time divided by the
+// number of operations each thread performed. A body that processes a known
+// number of items per operation can set state::items_per_op to have the
+// throughput reported in items per second as well, and any other statistic
+// of a run, such as a latency percentile, can be added to state::counters.
+//
+// This header replaces the global operator new and delete to count
+// allocations, so it must be included by exactly one translation unit of a
+// benchmark executable.
+//
+// Command line options understood by suite::run:
+//   --filter=<text>     only run benchmarks whose name contains <text>
+//   --threads=<n>       largest thread count for threaded benchmarks
+//   --min-time=<secs>   minimum duration of a measured run (default 0.2)
+//   --json              print the results as JSON instead of a table
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bench {
+  inline std::atomic<std::size_t> allocation_count{0};
+
+  // Prevents the compiler from optimizing away the computation of value.
+  template <class T>
+  inline void do_not_optimize(const T& value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+  }
+
+  struct state {
+    std::size_t iterations;   // operations to perform on this thread
+    std::size_t thread_index; // in [0, threads)
+    std::size_t threads;      // threads running the body concurrently
+    std::size_t items_per_op = 0;
+    // Reported with the result, as set by the body on thread 0 in the last run.
+    std::vector<std::pair<std::string, double>> counters{};
+  };
+
+  struct result {
+    std::string name;
+    std::size_t threads;
+    std::size_t iterations;
+    double ns_per_op;
+    double allocs_per_op;
+    double items_per_second; // 0 unless the body set state::items_per_op
+    std::vector<std::pair<std::string, double>> counters;
+  };
+
+  class suite {
+    struct benchmark {
+      std::string name;
+      std::function<void(state&)> body;
+      bool threaded;
+    };
+
+    std::vector<benchmark> benchmarks_;
+
+    struct options {
+      std::string filter;
+      std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+      double min_time = 0.2;
+      bool json = false;
+    };
+
+    static bool parse(int argc, char** argv, options& opts) {
+      for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&](std::string_view prefix) -> const char* {
+          return arg.substr(0, prefix.size()) == prefix ? argv[i] + prefix.size() : nullptr;
+        };
+        if (const char* v = value("--filter=")) {
+          opts.filter = v;
+        } else if (const char* v = value("--threads=")) {
+          opts.max_threads = std::max<std::size_t>(1, std::strtoul(v, nullptr, 10));
+        } else if (const char* v = value("--min-time=")) {
+          opts.min_time = std::strtod(v, nullptr);
+        } else if (arg == "--json") {
+          opts.json = true;
+        } else {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    struct measurement {
+      double ns;
+      std::size_t allocs;
+      std::size_t items_per_op;
+      std::vector<std::pair<std::string, double>> counters;
+    };
+
+    // Runs body on the given number of threads at once and returns the
+    // elapsed wall-clock time in nanoseconds along with the number of
+    // allocations made by the bodies.
+    static measurement measure(const benchmark& b, std::size_t threads, std::size_t iterations) {
+      std::atomic<std::size_t> ready{0};
+      std::atomic<bool> go{false};
+      std::vector<std::thread> workers;
+      workers.reserve(threads - 1);
+      for (std::size_t t = 1; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+          state s{iterations, t, threads};
+          ready.fetch_add(1);
+          while (!go.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+          }
+          b.body(s);
+        });
+      }
+      while (ready.load() != threads - 1) {
+        std::this_thread::yield();
+      }
+      state s{iterations, 0, threads};
+      std::size_t allocs = allocation_count.load();
+      auto start = std::chrono::steady_clock::now();
+      go.store(true, std::memory_order_release);
+      b.body(s);
+      for (auto& worker: workers) {
+        worker.join();
+      }
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      allocs = allocation_count.load() - allocs;
+      return {
+        static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+        allocs,
+        s.items_per_op,
+        std::move(s.counters)};
+    }
+
+    static result run_one(const benchmark& b, std::size_t threads, double min_time) {
+      const double min_ns = min_time * 1e9;
+      std::size_t iterations = 1;
+      while (true) {
+        auto [ns, allocs, items_per_op, counters] = measure(b, threads, iterations);
+        if (ns >= min_ns || iterations >= (std::size_t{1} << 40)) {
+          double ops = static_cast<double>(iterations);
+          double items = static_cast<double>(items_per_op) * ops * static_cast<double>(threads);
+          return {
+            b.name,
+            threads,
+            iterations,
+            ns / ops,
+            static_cast<double>(allocs) / (ops * threads),
+            ns > 0 ? items * 1e9 / ns : 0.0,
+            std::move(counters)};
+        }
+        // Aim slightly past the minimum time, growing at most tenfold per step.
+        double scale = ns > 0 ? std::min(10.0, 1.2 * min_ns / ns) : 10.0;
+        iterations = std::max(iterations + 1, static_cast<std::size_t>(iterations * scale));
+      }
+    }
+
+    static void print_table_header() {
+      std::printf(
+        "%-48s %8s %12s %12s %12s %12s\n",
+        "benchmark",
+        "threads",
+        "iterations",
+        "ns/op",
+        "allocs/op",
+        "items/s");
+    }
+
+    static void print_table_row(const result& r) {
+      char items[32] = "-";
+      if (r.items_per_second > 0) {
+        std::snprintf(items, sizeof(items), "%.4g", r.items_per_second);
+      }
+      std::printf(
+        "%-48s %8zu %12zu %12.2f %12.2f %12s",
+        r.name.c_str(),
+        r.threads,
+        r.iterations,
+        r.ns_per_op,
+        r.allocs_per_op,
+        items);
+      for (const auto& [name, value]: r.counters) {
+        std::printf(" %s=%.4g", name.c_str(), value);
+      }
+      std::printf("\n");
+      std::fflush(stdout);
+    }
+
+    static void print_json(const std::vector<result>& results) {
+      char date[64];
+      std::time_t now = std::time(nullptr);
+      std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+      std::printf("{\n  \"context\": {\n");
+      std::printf("    \"date\": \"%s\",\n", date);
+      std::printf("    \"num_cpus\": %u\n", std::thread::hardware_concurrency());
+      std::printf("  },\n  \"benchmarks\": [");
+      for (std::size_t i = 0; i < results.size(); ++i) {
+        const result& r = results[i];
+        std::printf(
+          "%s\n    {\"name\": \"%s/threads:%zu\", \"run_name\": \"%s\", \"threads\": %zu, "
+          "\"iterations\": %zu, \"real_time\": %.4f, \"time_unit\": \"ns\", "
+          "\"allocs_per_op\": %.4f",
+          i == 0 ? "" : ",",
+          r.name.c_str(),
+          r.threads,
+          r.name.c_str(),
+          r.threads,
+          r.iterations,
+          r.ns_per_op,
+          r.allocs_per_op);
+        if (r.items_per_second > 0) {
+          std::printf(", \"items_per_second\": %.4f", r.items_per_second);
+        }
+        for (const auto& [name, value]: r.counters) {
+          std::printf(", \"%s\": %.4f", name.c_str(), value);
+        }
+        std::printf("}");
+      }
+      std::printf("\n  ]\n}\n");
+    }
+
+   public:
+    // Registers a benchmark that runs on one thread. body must perform
+    // state::iterations operations.
+    suite& add(std::string name, std::function<void(state&)> body) {
+      benchmarks_.push_back({std::move(name), std::move(body), false});
+      return *this;
+    }
+
+    // Registers a benchmark that is run concurrently on 1 up to --threads
+    // threads. Each thread calls body with its own state.
+    suite& add_threaded(std::string name, std::function<void(state&)> body) {
+      benchmarks_.push_back({std::move(name), std::move(body), true});
+      return *this;
+    }
+
+    // The largest thread count given with --threads, or the number of
+    // hardware threads. Benchmarks that create their own thread pools use it
+    // to size them before calling run.
+    static std::size_t max_threads(int argc, char** argv) {
+      options opts;
+      parse(argc, argv, opts);
+      return opts.max_threads;
+    }
+
+    int run(int argc, char** argv) {
+      options opts;
+      if (!parse(argc, argv, opts)) {
+        std::fprintf(
+          stderr,
+          "usage: %s [--filter=<text>] [--threads=<n>] [--min-time=<secs>] [--json]\n",
+          argv[0]);
+        return EXIT_FAILURE;
+      }
+      std::vector<result> results;
+      if (!opts.json) {
+        print_table_header();
+      }
+      for (const benchmark& b: benchmarks_) {
+        if (b.name.find(opts.filter) == std::string::npos) {
+          continue;
+        }
+        std::vector<std::size_t> thread_counts{1};
+        if (b.threaded) {
+          for (std::size_t n = 2; n < opts.max_threads; n *= 2) {
+            thread_counts.push_back(n);
+          }
+          if (opts.max_threads > 1) {
+            thread_counts.push_back(opts.max_threads);
+          }
+        }
+        for (std::size_t threads: thread_counts) {
+          results.push_back(run_one(b, threads, opts.min_time));
+          if (!opts.json) {
+            print_table_row(results.back());
+          }
+        }
+      }
+      if (opts.json) {
+        print_json(results);
+      }
+      return EXIT_SUCCESS;
+    }
+  };
+} // namespace bench
+
+////////////////////////////////////////////////////////////////////////////////
+// Global allocation counting
+void* operator new(std::size_t size) {
+  bench::allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+  bench::allocation_count.fetch_add(1, std::memory_order_relaxed);
+  std::size_t alignment = static_cast<std::size_t>(align);
+  std::size_t rounded = (std::max<std::size_t>(size, 1) + alignment - 1) / alignment * alignment;
+  if (void* p = std::aligned_alloc(alignment, rounded)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+// GCC sees through the replaced operators when they are inlined and reports
+// the std::free of memory from operator new as a mismatch.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,484 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Runs the image server of examples/server_theme/split_bulk.cpp under load,
+// with real image processing, to show the cost of the framework in a
+// server-shaped workload.
+//
+// The server handles two kinds of requests on a static_thread_pool, with the
+// senders of the example:
+//
+//   /edge_detect  split the decoded image, run the Canny, Sobel and Prewitt
+//                 edge detectors on it in parallel with when_all, and encode
+//                 the three results
+//   /multi_blur   decode four images, blur them in parallel with a bulk in a
+//                 let_value, and encode the results
+//
+// The images are synthetic grayscale images and the filters are 3x3 and 5x5
+// convolutions. A closed-loop load generator keeps a given number of
+// requests in flight: it spawns that many requests into an async_scope, and
+// every completed request spawns the next one until all requests have been
+// issued. The requests alternate between the two routes.
+//
+// An operation is one request, so the throughput is reported in requests
+// per second. The latency of a request is measured from its spawn to its
+// response and reported as the percentiles p50_us, p90_us and p99_us, and
+// max_us, all in microseconds.
+//
+// usage: benchmark.image_server [--filter=<text>] [--threads=<n>] [--min-time=<secs>] [--json]
+//
+// --threads is the number of threads of the pool that runs the server. A run
+// issues as many requests as fit in --min-time, which limits the number that
+// can be in flight at once; raise --min-time for the large in_flight values
+// on slow machines.
+
+#include <stdexec/execution.hpp>
+#include <exec/async_scope.hpp>
+#include <exec/static_thread_pool.hpp>
+
+#include "harness.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex = stdexec;
+
+namespace {
+  using clock = std::chrono::steady_clock;
+
+  struct image {
+    std::size_t width = 0;
+    std::size_t height = 0;
+    std::vector<float> pixels;
+
+    image() = default;
+
+    image(std::size_t width, std::size_t height)
+      : width{width}
+      , height{height}
+      , pixels(width * height) {
+    }
+
+    float& operator()(std::size_t x, std::size_t y) noexcept {
+      return pixels[y * width + x];
+    }
+
+    float operator()(std::size_t x, std::size_t y) const noexcept {
+      return pixels[y * width + x];
+    }
+
+    // The pixel at (x, y), where coordinates past the border are clamped.
+    float clamped(std::ptrdiff_t x, std::ptrdiff_t y) const noexcept {
+      x = std::clamp<std::ptrdiff_t>(x, 0, static_cast<std::ptrdiff_t>(width) - 1);
+      y = std::clamp<std::ptrdiff_t>(y, 0, static_cast<std::ptrdiff_t>(height) - 1);
+      return (*this)(static_cast<std::size_t>(x), static_cast<std::size_t>(y));
+    }
+  };
+
+  // A scene of overlapping discs on a gradient, with some noise, so that
+  // the edge detectors find edges of all orientations.
+  image make_synthetic_image(std::size_t size, std::uint32_t seed) {
+    image img{size, size};
+    std::uint32_t state = seed * 2654435761u + 1;
+    auto next = [&state] {
+      state = state * 1664525u + 1013904223u;
+      return static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+    };
+    const float s = static_cast<float>(size);
+    std::array<std::array<float, 4>, 6> discs; // x, y, radius, intensity
+    for (auto& d: discs) {
+      d = {next() * s, next() * s, (0.05f + 0.2f * next()) * s, next()};
+    }
+    for (std::size_t y = 0; y < size; ++y) {
+      for (std::size_t x = 0; x < size; ++x) {
+        float v = 0.5f * static_cast<float>(x + y) / (2 * s);
+        for (const auto& [cx, cy, r, intensity]: discs) {
+          const float dx = static_cast<float>(x) - cx;
+          const float dy = static_cast<float>(y) - cy;
+          if (dx * dx + dy * dy < r * r) {
+            v = intensity;
+          }
+        }
+        img(x, y) = v + 0.02f * next();
+      }
+    }
+    return img;
+  }
+
+  using kernel3 = std::array<std::array<float, 3>, 3>;
+
+  constexpr kernel3 sobel_x{{{-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1}}};
+  constexpr kernel3 sobel_y{{{-1, -2, -1}, {0, 0, 0}, {1, 2, 1}}};
+  constexpr kernel3 prewitt_x{{{-1, 0, 1}, {-1, 0, 1}, {-1, 0, 1}}};
+  constexpr kernel3 prewitt_y{{{-1, -1, -1}, {0, 0, 0}, {1, 1, 1}}};
+
+  float convolve_at(const image& img, const kernel3& k, std::size_t x, std::size_t y) noexcept {
+    float sum = 0;
+    for (std::ptrdiff_t j = -1; j <= 1; ++j) {
+      for (std::ptrdiff_t i = -1; i <= 1; ++i) {
+        sum += k[j + 1][i + 1]
+             * img.clamped(static_cast<std::ptrdiff_t>(x) + i, static_cast<std::ptrdiff_t>(y) + j);
+      }
+    }
+    return sum;
+  }
+
+  // The magnitude of the gradient given by a pair of derivative kernels.
+  image gradient_magnitude(const image& img, const kernel3& kx, const kernel3& ky) {
+    image out{img.width, img.height};
+    for (std::size_t y = 0; y < img.height; ++y) {
+      for (std::size_t x = 0; x < img.width; ++x) {
+        out(x, y) = std::hypot(convolve_at(img, kx, x, y), convolve_at(img, ky, x, y));
+      }
+    }
+    return out;
+  }
+
+  // A 5x5 Gaussian blur, as a horizontal and a vertical pass of the binomial
+  // kernel 1 4 6 4 1.
+  image gaussian_blur(const image& img) {
+    constexpr std::array<float, 5> k{1 / 16.f, 4 / 16.f, 6 / 16.f, 4 / 16.f, 1 / 16.f};
+    image tmp{img.width, img.height};
+    image out{img.width, img.height};
+    for (std::size_t y = 0; y < img.height; ++y) {
+      for (std::size_t x = 0; x < img.width; ++x) {
+        float sum = 0;
+        for (std::ptrdiff_t i = -2; i <= 2; ++i) {
+          sum += k[i + 2] * img.clamped(static_cast<std::ptrdiff_t>(x) + i, y);
+        }
+        tmp(x, y) = sum;
+      }
+    }
+    for (std::size_t y = 0; y < img.height; ++y) {
+      for (std::size_t x = 0; x < img.width; ++x) {
+        float sum = 0;
+        for (std::ptrdiff_t j = -2; j <= 2; ++j) {
+          sum += k[j + 2] * tmp.clamped(x, static_cast<std::ptrdiff_t>(y) + j);
+        }
+        out(x, y) = sum;
+      }
+    }
+    return out;
+  }
+
+  // Canny: smooth, take the Sobel gradient, keep the local maxima along the
+  // gradient direction, and keep the strong edges plus the weak ones that
+  // touch a strong one.
+  image apply_canny(const image& img) {
+    constexpr float low = 0.1f;
+    constexpr float high = 0.3f;
+    const image smooth = gaussian_blur(img);
+    image gx{img.width, img.height};
+    image gy{img.width, img.height};
+    image magnitude{img.width, img.height};
+    for (std::size_t y = 0; y < img.height; ++y) {
+      for (std::size_t x = 0; x < img.width; ++x) {
+        gx(x, y) = convolve_at(smooth, sobel_x, x, y);
+        gy(x, y) = convolve_at(smooth, sobel_y, x, y);
+        magnitude(x, y) = std::hypot(gx(x, y), gy(x, y));
+      }
+    }
+    image thin{img.width, img.height};
+    for (std::size_t y = 0; y < img.height; ++y) {
+      for (std::size_t x = 0; x < img.width; ++x) {
+        // The neighbours along the gradient, rounded to one of 4 directions.
+        const float ax = std::abs(gx(x, y));
+        const float ay = std::abs(gy(x, y));
+        std::ptrdiff_t dx = 0;
+        std::ptrdiff_t dy = 0;
+        if (ay <= 0.4142f * ax) {
+          dx = 1;
+        } else if (ax <= 0.4142f * ay) {
+          dy = 1;
+        } else {
+          dx = 1;
+          dy = (gx(x, y) > 0) == (gy(x, y) > 0) ? 1 : -1;
+        }
+        const auto sx = static_cast<std::ptrdiff_t>(x);
+        const auto sy = static_cast<std::ptrdiff_t>(y);
+        const float m = magnitude(x, y);
+        const bool is_max = m >= magnitude.clamped(sx + dx, sy + dy)
+                         && m >= magnitude.clamped(sx - dx, sy - dy);
+        thin(x, y) = is_max ? m : 0.0f;
+      }
+    }
+    image edges{img.width, img.height};
+    for (std::size_t y = 0; y < img.height; ++y) {
+      for (std::size_t x = 0; x < img.width; ++x) {
+        const float m = thin(x, y);
+        bool edge = m >= high;
+        if (!edge && m >= low) {
+          for (std::ptrdiff_t j = -1; j <= 1 && !edge; ++j) {
+            for (std::ptrdiff_t i = -1; i <= 1 && !edge; ++i) {
+              const float neighbour = thin.clamped(
+                static_cast<std::ptrdiff_t>(x) + i, static_cast<std::ptrdiff_t>(y) + j);
+              edge = neighbour >= high;
+            }
+          }
+        }
+        edges(x, y) = edge ? 1.0f : 0.0f;
+      }
+    }
+    return edges;
+  }
+
+  image apply_sobel(const image& img) {
+    return gradient_magnitude(img, sobel_x, sobel_y);
+  }
+
+  image apply_prewitt(const image& img) {
+    return gradient_magnitude(img, prewitt_x, prewitt_y);
+  }
+
+  image apply_blur(const image& img) {
+    return gaussian_blur(img);
+  }
+
+  enum class route {
+    edge_detect,
+    multi_blur
+  };
+
+  // The body of a request is a set of images, which the handlers decode,
+  // i.e. copy, before they process them.
+  struct http_request {
+    route route_;
+    const std::vector<image>* body_;
+  };
+
+  struct http_response {
+    int status_code_;
+    double body_; // the sum of the pixels of the resulting images
+  };
+
+  image extract_image(const http_request& req) {
+    return req.body_->front();
+  }
+
+  std::vector<image> extract_images(const http_request& req) {
+    return *req.body_;
+  }
+
+  double encode(const image& img) noexcept {
+    double sum = 0;
+    for (float v: img.pixels) {
+      sum += v;
+    }
+    return sum;
+  }
+
+  http_response img3_to_response(const image& img1, const image& img2, const image& img3) {
+    return {200, encode(img1) + encode(img2) + encode(img3)};
+  }
+
+  http_response imgvec_to_response(const std::vector<image>& imgs) {
+    double sum = 0;
+    for (const image& img: imgs) {
+      sum += encode(img);
+    }
+    return {200, sum};
+  }
+
+  // The handlers of split_bulk.cpp, where every detector and every blur runs
+  // as a task of its own on the pool.
+  template <class Scheduler>
+  auto handle_edge_detection_request(Scheduler sched, http_request req) {
+    auto img = ex::split(ex::just(req) | ex::then(extract_image));
+    return ex::when_all(
+             img | ex::transfer(sched) | ex::then(apply_canny),
+             img | ex::transfer(sched) | ex::then(apply_sobel),
+             img | ex::transfer(sched) | ex::then(apply_prewitt))
+         | ex::then(img3_to_response);
+  }
+
+  template <class Scheduler>
+  auto handle_multi_blur_request(Scheduler sched, http_request req) {
+    return ex::just(req) //
+         | ex::then(extract_images)
+         | ex::let_value([sched](std::vector<image>& imgs) {
+             const std::size_t img_count = imgs.size();
+             return ex::transfer_just(sched, std::move(imgs))
+                  | ex::bulk(img_count, [](std::size_t i, std::vector<image>& imgs) {
+                      imgs[i] = apply_blur(imgs[i]);
+                    });
+           })
+         | ex::then(imgvec_to_response);
+  }
+
+  // The request bodies of an image size.
+  struct workload {
+    std::vector<image> edge_detect_body;
+    std::vector<image> multi_blur_body;
+
+    explicit workload(std::size_t size)
+      : edge_detect_body{make_synthetic_image(size, 0)} {
+      for (std::uint32_t i = 1; i <= 4; ++i) {
+        multi_blur_body.push_back(make_synthetic_image(size, i));
+      }
+    }
+  };
+
+  // Issues a number of requests with at most in_flight of them outstanding.
+  class load_generator {
+    exec::static_thread_pool::scheduler sched_;
+    const workload& workload_;
+    std::size_t total_;
+    exec::async_scope scope_;
+    std::atomic<std::size_t> issued_{0};
+    std::atomic<std::size_t> failures_{0};
+    std::vector<clock::duration> latencies_;
+    std::vector<double> checksums_;
+
+    void record(std::size_t i, clock::time_point start, const http_response& resp) noexcept {
+      latencies_[i] = clock::now() - start;
+      checksums_[i] = resp.body_;
+      if (resp.status_code_ != 200) {
+        failures_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    template <class Sender>
+    void spawn(std::size_t i, Sender&& sndr) {
+      const clock::time_point start = clock::now();
+      scope_.spawn(
+        ex::on(sched_, (Sender&&) sndr)
+        | ex::upon_error([](std::exception_ptr) noexcept { return http_response{500, 0}; })
+        | ex::then([this, i, start](const http_response& resp) noexcept {
+            record(i, start, resp);
+            issue_next();
+          }));
+    }
+
+    void issue_next() {
+      const std::size_t i = issued_.fetch_add(1, std::memory_order_relaxed);
+      if (i >= total_) {
+        return;
+      }
+      if (i % 2 == 0) {
+        http_request req{route::edge_detect, &workload_.edge_detect_body};
+        spawn(i, handle_edge_detection_request(sched_, req));
+      } else {
+        http_request req{route::multi_blur, &workload_.multi_blur_body};
+        spawn(i, handle_multi_blur_request(sched_, req));
+      }
+    }
+
+   public:
+    load_generator(
+      exec::static_thread_pool::scheduler sched,
+      const workload& workload,
+      std::size_t total)
+      : sched_{sched}
+      , workload_{workload}
+      , total_{total}
+      , latencies_(total)
+      , checksums_(total) {
+    }
+
+    void run(std::size_t in_flight) {
+      for (std::size_t i = 0; i < std::min(in_flight, total_); ++i) {
+        issue_next();
+      }
+      ex::sync_wait(scope_.on_empty());
+    }
+
+    std::size_t failures() const noexcept {
+      return failures_.load();
+    }
+
+    const std::vector<double>& checksums() const noexcept {
+      return checksums_;
+    }
+
+    // The latency below which the given fraction of the requests completed, in
+    // microseconds.
+    std::vector<double> latency_percentiles_us(const std::vector<double>& fractions) {
+      std::sort(latencies_.begin(), latencies_.end());
+      std::vector<double> result;
+      for (double f: fractions) {
+        const auto rank = static_cast<std::size_t>(f * static_cast<double>(latencies_.size() - 1));
+        result.push_back(std::chrono::duration<double, std::micro>(latencies_[rank]).count());
+      }
+      return result;
+    }
+  };
+
+  // The handlers have to compute the same responses as when the filters are
+  // applied directly.
+  bool responses_are_correct(exec::static_thread_pool::scheduler sched) {
+    const workload w{24};
+    load_generator load{sched, w, 8};
+    load.run(4);
+    const image& img = w.edge_detect_body.front();
+    const double edge_detect =
+      encode(apply_canny(img)) + encode(apply_sobel(img)) + encode(apply_prewitt(img));
+    double multi_blur = 0;
+    for (const image& blurred: w.multi_blur_body) {
+      multi_blur += encode(apply_blur(blurred));
+    }
+    for (std::size_t i = 0; i < load.checksums().size(); ++i) {
+      if (load.checksums()[i] != (i % 2 == 0 ? edge_detect : multi_blur)) {
+        return false;
+      }
+    }
+    return load.failures() == 0;
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t threads = bench::suite::max_threads(argc, argv);
+  exec::static_thread_pool pool{static_cast<std::uint32_t>(threads)};
+  auto sched = pool.get_scheduler();
+
+  if (!responses_are_correct(sched)) {
+    std::fprintf(stderr, "image_server: the handlers compute wrong responses\n");
+    return 1;
+  }
+
+  // Thumbnails, where the framework is a good part of the cost of a request,
+  // and larger images, where the filters dominate.
+  bench::suite suite;
+  for (std::size_t size: {32, 128}) {
+    for (std::size_t in_flight: {1, 64, 1024, 4096}) {
+      suite.add(
+        "image_server/size:" + std::to_string(size) + "/in_flight:" + std::to_string(in_flight),
+        [sched, size, in_flight, w = std::make_shared<workload>(size)](bench::state& state) {
+          state.items_per_op = 1;
+          load_generator load{sched, *w, state.iterations};
+          load.run(in_flight);
+          const std::vector<double> us = load.latency_percentiles_us({0.5, 0.9, 0.99, 1.0});
+          state.counters = {
+            {"p50_us", us[0]}, {"p90_us", us[1]}, {"p99_us", us[2]}, {"max_us", us[3]}};
+          if (load.failures() != 0) {
+            state.counters.emplace_back("failures", static_cast<double>(load.failures()));
+          }
+        });
+    }
+  }
+
+  return suite.run(argc, argv);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Reports the size of let_value operation states next to the sizes of the
+// predecessor and successor operation states they embed, so that changes to
+// the per-connection memory of let_value can be tracked. The sizes are
+// reported as counters of a benchmark that connects and starts the pipeline.
+//
+// usage: benchmark.let_op_size [--filter=<text>] [--min-time=<secs>] [--json]
+
+#include <stdexec/execution.hpp>
+#include <exec/when_any.hpp>
+
+#include "harness.hpp"
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace {
+  namespace ex = stdexec;
+
+  struct sink_receiver {
+    using is_receiver = void;
+
+    template <class... As>
+    friend void tag_invoke(ex::set_value_t, sink_receiver&&, As&&...) noexcept {
+    }
+
+    template <class E>
+    friend void tag_invoke(ex::set_error_t, sink_receiver&&, E&&) noexcept {
+    }
+
+    friend void tag_invoke(ex::set_stopped_t, sink_receiver&&) noexcept {
+    }
+
+    friend ex::empty_env tag_invoke(ex::get_env_t, const sink_receiver&) noexcept {
+      return {};
+    }
+  };
+
+  template <class Sender>
+  using op_t = ex::connect_result_t<Sender, sink_receiver>;
+
+  using payload_t = std::array<char, 256>;
+
+  // Values are the value types the predecessor made by make_pred can
+  // complete with.
+  template <class... Values, class MakePred, class Fun>
+  void add_benchmark(bench::suite& suite, std::string name, MakePred make_pred, Fun fun) {
+    using pred_t = std::invoke_result_t<MakePred&>;
+    using let_op_t = op_t<decltype(ex::let_value(std::declval<pred_t>(), std::declval<Fun>()))>;
+    const std::size_t pred_size = sizeof(op_t<pred_t>);
+    const std::size_t succ_size =
+      std::max({sizeof(op_t<std::invoke_result_t<Fun&, Values&>>)...});
+
+    suite.add("let_value/" + std::move(name), [=](bench::state& state) {
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        auto op = ex::connect(ex::let_value(make_pred(), fun), sink_receiver{});
+        ex::start(op);
+        bench::do_not_optimize(op);
+      }
+      state.counters = {
+        {"let_op_bytes", sizeof(let_op_t)},
+        {"pred_op_bytes", pred_size},
+        {"succ_op_bytes", succ_size},
+        {"pred+succ_bytes", pred_size + succ_size},
+      };
+    });
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::suite suite;
+
+  add_benchmark<int>(
+    suite, "just->just", [] { return ex::just(1); }, [](int n) { return ex::just(n); });
+
+  add_benchmark<int>(
+    suite,
+    "large_pred->large_succ",
+    [] {
+      return ex::just(payload_t{}) //
+           | ex::then([](const payload_t& p) { return (int) p.size(); });
+    },
+    [](int n) {
+      return ex::just(payload_t{}) | ex::then([n](const payload_t&) { return n; });
+    });
+
+  add_benchmark<int, double>(
+    suite,
+    "when_any->large_succ",
+    [] { return exec::when_any(ex::just(1), ex::just(2.0)); },
+    [](auto x) {
+      return ex::just(payload_t{}) | ex::then([x](const payload_t&) { return x; });
+    });
+
+  return suite.run(argc, argv);
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Runs the FDTD stencil of the Maxwell examples (examples/nvexec/maxwell) on
+// the CPU, for several grid sizes, schedulers and thread counts. An operation
+// is one time step, i.e. an update of the magnetic field of every cell
+// followed by an update of the electric field, and the throughput is reported
+// in cells per second. The kernel is bandwidth-bound on large grids, which
+// makes it a realistic check of the dispatch and barrier costs of a
+// scheduler.
+//
+// Every scheduler runs the step as two bulks, once with a sync_wait per step
+// ("bulk") and once with all the steps of an operation in one repeat_n
+// ("repeat_n"). inline_scheduler gives the single-threaded baseline, and
+// exec::multi_pool_context splits the bulks across a pool per NUMA node. When
+// built with TBB, tbbexec::tbb_thread_pool and std::execution::par are
+// measured as well.
+//
+// usage: benchmark.maxwell [--filter=<text>] [--threads=<n>] [--min-time=<secs>] [--json]
+//
+// --threads bounds the number of threads of the thread pools, which are
+// measured with 1, 2, 4, ... up to that many threads. Use --filter to select
+// e.g. a grid size ("N:512") or a scheduler ("static_thread_pool:8/").
+
+#include <stdexec/execution.hpp>
+#include <exec/inline_scheduler.hpp>
+#include <exec/multi_pool_context.hpp>
+#include <exec/repeat_n.hpp>
+#include <exec/static_thread_pool.hpp>
+
+#if STDEXEC_BENCHMARK_TBB
+#include <tbbexec/tbb_thread_pool.hpp>
+#endif
+
+#if STDEXEC_BENCHMARK_TBB || (__has_include(<execution>) && !defined(__GLIBCXX__))
+// libstdc++ needs TBB for its parallel algorithms.
+#include <algorithm>
+#include <execution>
+#define STDEXEC_BENCHMARK_STDPAR 1
+#endif
+
+#include "../examples/nvexec/maxwell/common.cuh"
+#include "harness.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ex = stdexec;
+
+namespace {
+  // An initialized grid, shared by the benchmarks of a size.
+  struct problem {
+    grid_t grid;
+    fields_accessor accessor;
+    float dt;
+    time_storage_t time{false};
+
+    explicit problem(std::size_t n)
+      : grid{n, false}
+      , accessor{grid.accessor()}
+      , dt{calculate_dt(accessor.dx, accessor.dy)} {
+      *time.get() = 0.0f;
+      auto initializer = grid_initializer(dt, accessor);
+      for (std::size_t i = 0; i < accessor.cells; ++i) {
+        initializer(i);
+      }
+    }
+  };
+
+  // Only the grid of the running benchmark is kept, so that the large ones
+  // fit in memory.
+  class problems {
+    std::unique_ptr<problem> problem_;
+
+   public:
+    problem& get(std::size_t n) {
+      if (!problem_ || problem_->grid.n != n) {
+        problem_.reset();
+        problem_ = std::make_unique<problem>(n);
+      }
+      return *problem_;
+    }
+  };
+
+  template <class Scheduler>
+  void add_scheduler_benchmarks(
+    bench::suite& suite,
+    problems& grids,
+    const std::string& name,
+    Scheduler sched,
+    const std::vector<std::size_t>& sizes) {
+    for (std::size_t n: sizes) {
+      const std::string suffix = "/N:" + std::to_string(n);
+
+      suite.add("maxwell/" + name + "/bulk" + suffix, [&grids, sched, n](bench::state& state) {
+        problem& p = grids.get(n);
+        state.items_per_op = p.accessor.cells;
+        for (std::size_t i = 0; i < state.iterations; ++i) {
+          ex::sync_wait(
+            ex::schedule(sched) //
+            | ex::bulk(p.accessor.cells, update_h(p.accessor))
+            | ex::bulk(p.accessor.cells, update_e(p.time.get(), p.dt, p.accessor)));
+        }
+      });
+
+      suite.add("maxwell/" + name + "/repeat_n" + suffix, [&grids, sched, n](bench::state& state) {
+        problem& p = grids.get(n);
+        state.items_per_op = p.accessor.cells;
+        ex::sync_wait(
+          ex::schedule(sched)
+          | exec::repeat_n(
+            state.iterations,
+            ex::bulk(p.accessor.cells, update_h(p.accessor))
+              | ex::bulk(p.accessor.cells, update_e(p.time.get(), p.dt, p.accessor))));
+      });
+    }
+  }
+
+#if STDEXEC_BENCHMARK_STDPAR
+  void add_stdpar_benchmarks(
+    bench::suite& suite,
+    problems& grids,
+    const std::vector<std::size_t>& sizes) {
+    for (std::size_t n: sizes) {
+      suite.add(
+        "maxwell/std::execution::par/for_each/N:" + std::to_string(n),
+        [&grids, n](bench::state& state) {
+          problem& p = grids.get(n);
+          state.items_per_op = p.accessor.cells;
+          // The cells are numbered by their position in one of the fields.
+          float* first = p.accessor.get(field_id::er);
+          float* last = first + p.accessor.cells;
+          auto h = update_h(p.accessor);
+          auto e = update_e(p.time.get(), p.dt, p.accessor);
+          for (std::size_t i = 0; i < state.iterations; ++i) {
+            std::for_each(std::execution::par, first, last, [&](float& cell) {
+              h(static_cast<std::size_t>(&cell - first));
+            });
+            std::for_each(std::execution::par, first, last, [&](float& cell) {
+              e(static_cast<std::size_t>(&cell - first));
+            });
+          }
+        });
+    }
+  }
+#endif
+}
+
+int main(int argc, char** argv) {
+  // From a grid that fits in the L2 cache to one that only fits in memory.
+  const std::vector<std::size_t> sizes{128, 512, 2048};
+
+  std::vector<std::size_t> thread_counts;
+  const std::size_t threads = bench::suite::max_threads(argc, argv);
+  for (std::size_t t = 1; t < threads; t *= 2) {
+    thread_counts.push_back(t);
+  }
+  thread_counts.push_back(threads);
+
+  bench::suite suite;
+  problems grids;
+
+  add_scheduler_benchmarks(suite, grids, "inline_scheduler", exec::inline_scheduler{}, sizes);
+
+  std::vector<std::unique_ptr<exec::static_thread_pool>> pools;
+  for (std::size_t t: thread_counts) {
+    pools.push_back(std::make_unique<exec::static_thread_pool>(static_cast<std::uint32_t>(t)));
+    add_scheduler_benchmarks(
+      suite,
+      grids,
+      "static_thread_pool:" + std::to_string(t),
+      pools.back()->get_scheduler(),
+      sizes);
+  }
+
+  // One pool per NUMA node, splitting each bulk across the nodes.
+  exec::multi_pool_context numa_pools;
+  add_scheduler_benchmarks(
+    suite,
+    grids,
+    "multi_pool_context:" + std::to_string(numa_pools.pool_count()) + "x"
+      + std::to_string(numa_pools.available_parallelism()),
+    numa_pools.get_scheduler(),
+    sizes);
+
+#if STDEXEC_BENCHMARK_TBB
+  std::vector<std::unique_ptr<tbbexec::tbb_thread_pool>> tbb_pools;
+  for (std::size_t t: thread_counts) {
+    tbb_pools.push_back(std::make_unique<tbbexec::tbb_thread_pool>(static_cast<int>(t)));
+    add_scheduler_benchmarks(
+      suite,
+      grids,
+      "tbb_thread_pool:" + std::to_string(t),
+      tbb_pools.back()->get_scheduler(),
+      sizes);
+  }
+#endif
+
+#if STDEXEC_BENCHMARK_STDPAR
+  add_stdpar_benchmarks(suite, grids, sizes);
+#endif
+
+  return suite.run(argc, argv);
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the per-operation cost of the basic sender/receiver primitives:
+// connect and start, then chains, when_all, split, ensure_started,
+// sync_wait, scheduling and bulk on static_thread_pool and, where available,
+// io_uring_context timers. See harness.hpp for the command line options;
+// pass --json to get output that can be diffed across versions.
+//
+// usage: benchmark.primitives [--filter=<text>] [--threads=<n>] [--min-time=<secs>] [--json]
+
+#include <stdexec/execution.hpp>
+#include <exec/repeat_n.hpp>
+#include <exec/static_thread_pool.hpp>
+
+#if __has_include(<linux/io_uring.h>)
+#include <exec/linux/io_uring_context.hpp>
+#define STDEXEC_BENCHMARK_IO_URING 1
+#endif
+
+#include "harness.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <thread>
+
+namespace ex = stdexec;
+
+namespace {
+  struct sink_receiver {
+    using is_receiver = void;
+    long* sum_;
+
+    template <class... Ts>
+    friend void tag_invoke(ex::set_value_t, sink_receiver&& r, Ts&&... ts) noexcept {
+      ((*r.sum_ += static_cast<long>(ts)), ...);
+    }
+
+    template <class E>
+    friend void tag_invoke(ex::set_error_t, sink_receiver&&, E&&) noexcept {
+      std::terminate();
+    }
+
+    friend void tag_invoke(ex::set_stopped_t, sink_receiver&&) noexcept {
+    }
+
+    friend ex::empty_env tag_invoke(ex::get_env_t, const sink_receiver&) noexcept {
+      return {};
+    }
+  };
+
+  // Connects and starts every sender made by make on the calling thread.
+  template <class Make>
+  auto connect_and_start(Make make) {
+    return [make](bench::state& state) {
+      long sum = 0;
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        auto op = ex::connect(make(static_cast<int>(i)), sink_receiver{&sum});
+        ex::start(op);
+      }
+      bench::do_not_optimize(sum);
+    };
+  }
+
+  void add_inline_benchmarks(bench::suite& suite) {
+    suite.add("connect_start/just", connect_and_start([](int i) { return ex::just(i); }));
+
+    suite.add("connect_start/then_chain:4", connect_and_start([](int i) {
+                return ex::just(i)                                 //
+                     | ex::then([](int v) noexcept { return v + 1; }) //
+                     | ex::then([](int v) noexcept { return v * 2; }) //
+                     | ex::then([](int v) noexcept { return v - 1; }) //
+                     | ex::then([](int v) noexcept { return v / 2; });
+              }));
+
+    suite.add("connect_start/when_all:3", connect_and_start([](int i) {
+                return ex::when_all(ex::just(i), ex::just(i + 1), ex::just(i + 2));
+              }));
+
+    suite.add("connect_start/split", connect_and_start([](int i) { //
+                return ex::split(ex::just(i));
+              }));
+
+    suite.add("connect_start/ensure_started", connect_and_start([](int i) {
+                return ex::ensure_started(ex::just(i));
+              }));
+
+    suite.add("sync_wait/just", [](bench::state& state) {
+      long sum = 0;
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        auto [v] = ex::sync_wait(ex::just(static_cast<int>(i))).value();
+        sum += v;
+      }
+      bench::do_not_optimize(sum);
+    });
+  }
+
+  void add_thread_pool_benchmarks(bench::suite& suite, exec::static_thread_pool& pool) {
+    // Every calling thread round-trips through the shared pool.
+    suite.add_threaded("static_thread_pool/schedule", [&pool](bench::state& state) {
+      auto sched = pool.get_scheduler();
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        ex::sync_wait(ex::schedule(sched));
+      }
+    });
+
+    suite.add_threaded("static_thread_pool/bulk:64", [&pool](bench::state& state) {
+      auto sched = pool.get_scheduler();
+      std::atomic<long> sum{0};
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        ex::sync_wait(
+          ex::schedule(sched) //
+          | ex::bulk(64, [&](int k) noexcept { sum.fetch_add(k, std::memory_order_relaxed); }));
+      }
+      bench::do_not_optimize(sum);
+    });
+
+    // Two consecutive bulks, which the pool runs as a single dispatch.
+    suite.add_threaded("static_thread_pool/bulk_chain:2x64", [&pool](bench::state& state) {
+      auto sched = pool.get_scheduler();
+      std::atomic<long> sum{0};
+      auto add = [&](int k) noexcept {
+        sum.fetch_add(k, std::memory_order_relaxed);
+      };
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        ex::sync_wait(ex::schedule(sched) | ex::bulk(64, add) | ex::bulk(64, add));
+      }
+      bench::do_not_optimize(sum);
+    });
+
+    // Sixteen iterations of a bulk, which the pool runs as a single dispatch.
+    suite.add_threaded("static_thread_pool/repeat_n:16x64", [&pool](bench::state& state) {
+      auto sched = pool.get_scheduler();
+      std::atomic<long> sum{0};
+      auto add = [&](int k) noexcept {
+        sum.fetch_add(k, std::memory_order_relaxed);
+      };
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        ex::sync_wait(ex::schedule(sched) | exec::repeat_n(16, ex::bulk(64, add)));
+      }
+      bench::do_not_optimize(sum);
+    });
+  }
+
+#if STDEXEC_BENCHMARK_IO_URING
+  void add_io_uring_benchmarks(bench::suite& suite, exec::io_uring_context& context) {
+    suite.add_threaded("io_uring_context/schedule", [&context](bench::state& state) {
+      auto sched = context.get_scheduler();
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        ex::sync_wait(ex::schedule(sched));
+      }
+    });
+
+    suite.add_threaded("io_uring_context/schedule_after:0", [&context](bench::state& state) {
+      auto sched = context.get_scheduler();
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        ex::sync_wait(exec::schedule_after(sched, std::chrono::nanoseconds(0)));
+      }
+    });
+  }
+#endif
+}
+
+int main(int argc, char** argv) {
+  bench::suite suite;
+  add_inline_benchmarks(suite);
+
+  exec::static_thread_pool pool{std::max(1u, std::thread::hardware_concurrency())};
+  add_thread_pool_benchmarks(suite, pool);
+
+#if STDEXEC_BENCHMARK_IO_URING
+  // The kernel may not permit io_uring, e.g. inside a container.
+  std::optional<exec::io_uring_context> context;
+  std::optional<std::thread> io_thread;
+  try {
+    context.emplace();
+    io_thread.emplace([&] { context->run_until_stopped(); });
+    add_io_uring_benchmarks(suite, *context);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "skipping io_uring_context benchmarks: %s\n", e.what());
+  }
+#endif
+
+  int status = suite.run(argc, argv);
+
+#if STDEXEC_BENCHMARK_IO_URING
+  if (io_thread) {
+    context->request_stop();
+    io_thread->join();
+  }
+#endif
+  return status;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares exec::sort and exec::stable_partition on static_thread_pool with
+// the sequential std::sort and std::stable_partition, for several sizes and
+// thread counts. When built with TBB, std::execution::par is measured as
+// well. The input is the same random permutation of keys for every
+// benchmark of a size; an operation copies it and then sorts or partitions
+// the copy, so all results include the same copy. The throughput is
+// reported in elements per second.
+//
+// usage: benchmark.sort [--filter=<text>] [--threads=<n>] [--min-time=<secs>] [--json]
+//
+// --threads bounds the number of threads of the pools, which are measured
+// with 1, 2, 4, ... up to that many threads.
+
+#include <stdexec/execution.hpp>
+#include <exec/sort.hpp>
+#include <exec/static_thread_pool.hpp>
+
+#if STDEXEC_BENCHMARK_TBB || (__has_include(<execution>) && !defined(__GLIBCXX__))
+// libstdc++ needs TBB for its parallel algorithms.
+#include <execution>
+#define STDEXEC_BENCHMARK_STDPAR 1
+#endif
+
+#include "harness.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ex = stdexec;
+
+namespace {
+  // The random inputs, shared by the benchmarks of a size.
+  class inputs {
+    std::map<std::size_t, std::vector<std::uint64_t>> inputs_;
+
+   public:
+    const std::vector<std::uint64_t>& get(std::size_t n) {
+      std::vector<std::uint64_t>& v = inputs_[n];
+      if (v.size() != n) {
+        std::mt19937_64 gen{n};
+        v.resize(n);
+        std::generate(v.begin(), v.end(), gen);
+      }
+      return v;
+    }
+  };
+
+  bool is_odd(std::uint64_t i) noexcept {
+    return i % 2 != 0;
+  }
+
+  template <class Sort>
+  void add_benchmark(bench::suite& suite, inputs& in, std::string name, std::size_t n, Sort sort) {
+    suite.add(std::move(name) + "/N:" + std::to_string(n), [&in, n, sort](bench::state& state) {
+      const std::vector<std::uint64_t>& input = in.get(n);
+      std::vector<std::uint64_t> v(n);
+      state.items_per_op = n;
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        std::copy(input.begin(), input.end(), v.begin());
+        sort(v);
+      }
+      bench::do_not_optimize(v.data());
+    });
+  }
+
+  void add_sequential_benchmarks(bench::suite& suite, inputs& in, std::size_t n) {
+    add_benchmark(suite, in, "sort/std::sort", n, [](std::vector<std::uint64_t>& v) {
+      std::sort(v.begin(), v.end());
+    });
+    add_benchmark(
+      suite, in, "stable_partition/std::stable_partition", n, [](std::vector<std::uint64_t>& v) {
+        std::stable_partition(v.begin(), v.end(), is_odd);
+      });
+  }
+
+  void add_pool_benchmarks(
+    bench::suite& suite,
+    inputs& in,
+    std::size_t n,
+    std::size_t threads,
+    exec::static_thread_pool::scheduler sched) {
+    const std::string pool = "/static_thread_pool:" + std::to_string(threads);
+    add_benchmark(suite, in, "sort/exec::sort" + pool, n, [sched](std::vector<std::uint64_t>& v) {
+      ex::sync_wait(exec::sort(sched, v));
+    });
+    add_benchmark(
+      suite,
+      in,
+      "stable_partition/exec::stable_partition" + pool,
+      n,
+      [sched](std::vector<std::uint64_t>& v) {
+        ex::sync_wait(exec::stable_partition(sched, v, is_odd));
+      });
+  }
+
+#if STDEXEC_BENCHMARK_STDPAR
+  void add_stdpar_benchmarks(bench::suite& suite, inputs& in, std::size_t n) {
+    add_benchmark(
+      suite, in, "sort/std::sort/std::execution::par", n, [](std::vector<std::uint64_t>& v) {
+        std::sort(std::execution::par, v.begin(), v.end());
+      });
+    add_benchmark(
+      suite,
+      in,
+      "stable_partition/std::stable_partition/std::execution::par",
+      n,
+      [](std::vector<std::uint64_t>& v) {
+        std::stable_partition(std::execution::par, v.begin(), v.end(), is_odd);
+      });
+  }
+#endif
+}
+
+int main(int argc, char** argv) {
+  // From an input that fits in the L2 cache to one that only fits in memory.
+  const std::vector<std::size_t> sizes{1 << 15, 1 << 20, 1 << 23};
+
+  std::vector<std::size_t> thread_counts;
+  const std::size_t threads = bench::suite::max_threads(argc, argv);
+  for (std::size_t t = 1; t < threads; t *= 2) {
+    thread_counts.push_back(t);
+  }
+  thread_counts.push_back(threads);
+
+  std::vector<std::unique_ptr<exec::static_thread_pool>> pools;
+  for (std::size_t t: thread_counts) {
+    pools.push_back(std::make_unique<exec::static_thread_pool>(static_cast<std::uint32_t>(t)));
+  }
+
+  bench::suite suite;
+  inputs in;
+  for (std::size_t n: sizes) {
+    add_sequential_benchmarks(suite, in, n);
+    for (std::size_t i = 0; i < pools.size(); ++i) {
+      add_pool_benchmarks(suite, in, n, thread_counts[i], pools[i]->get_scheduler());
+    }
+#if STDEXEC_BENCHMARK_STDPAR
+    add_stdpar_benchmarks(suite, in, n);
+#endif
+  }
+
+  return suite.run(argc, argv);
+}
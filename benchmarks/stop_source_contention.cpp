@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the cost of registering and deregistering in_place_stop_callbacks
+// on a single in_place_stop_source that is shared by all threads, as happens
+// when many operations nested in one scope observe the same stop token. An
+// operation registers two callbacks and deregisters them again, in reverse
+// order ("nested") or in the order of registration ("interleaved"), and the
+// throughput is reported in callbacks per second.
+//
+// usage: benchmark.stop_source_contention
+//          [--filter=<text>] [--threads=<n>] [--min-time=<secs>] [--json]
+
+#include <stdexec/stop_token.hpp>
+
+#include "harness.hpp"
+
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace {
+  struct noop_fn {
+    void operator()() const noexcept {
+    }
+  };
+
+  using callback_t = stdexec::in_place_stop_callback<noop_fn>;
+
+  enum class pattern {
+    nested,      // deregistered in reverse order of registration
+    interleaved, // the first callback registered is deregistered first
+  };
+
+  void add_benchmark(
+    bench::suite& suite,
+    const stdexec::in_place_stop_source& source,
+    std::string name,
+    pattern p) {
+    // Every thread registers its callbacks with the same source.
+    suite.add_threaded("stop_source/" + std::move(name), [&source, p](bench::state& state) {
+      state.items_per_op = 2;
+      for (std::size_t i = 0; i < state.iterations; ++i) {
+        std::optional<callback_t> outer{std::in_place, source.get_token(), noop_fn{}};
+        std::optional<callback_t> inner{std::in_place, source.get_token(), noop_fn{}};
+        if (p == pattern::interleaved) {
+          outer.reset();
+        }
+      }
+    });
+  }
+}
+
+int main(int argc, char** argv) {
+  stdexec::in_place_stop_source source;
+  bench::suite suite;
+  add_benchmark(suite, source, "nested", pattern::nested);
+  add_benchmark(suite, source, "interleaved", pattern::interleaved);
+  return suite.run(argc, argv);
+}
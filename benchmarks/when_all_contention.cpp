@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures when_all with N children that complete at the same time on N
+// different threads, which all write their values and decrement the count of
+// the one operation state.
+//
+// Each child is completed by a dedicated worker thread that polls a mailbox,
+// so an operation costs little more than the completions themselves. The
+// children of "padded" advertise a completion scheduler, for which when_all
+// pads their value slots and its count to separate cache lines; the
+// otherwise identical children of "packed" do not, so their slots share
+// cache lines.
+//
+// usage: benchmark.when_all_contention [--filter=<text>] [--min-time=<secs>] [--json]
+//
+// The workers poll, so the results are only meaningful with at least N + 1
+// cores.
+
+#include <stdexec/execution.hpp>
+#include <exec/inline_scheduler.hpp>
+
+#include "harness.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ex = stdexec;
+
+namespace {
+  // The value of a child, large enough to fill a good part of a cache line.
+  using payload = std::array<std::uint64_t, 4>;
+
+  struct completion_base {
+    void (*complete_)(completion_base*, std::uint64_t) noexcept;
+  };
+
+  // Where a child publishes its started operation for its worker.
+  struct alignas(64) mailbox {
+    std::atomic<completion_base*> op_{nullptr};
+  };
+
+  class workers {
+    std::vector<std::unique_ptr<mailbox>> boxes_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stop_{false};
+
+   public:
+    explicit workers(std::size_t n) {
+      for (std::size_t i = 0; i < n; ++i) {
+        boxes_.push_back(std::make_unique<mailbox>());
+      }
+      for (std::size_t i = 0; i < n; ++i) {
+        threads_.emplace_back([this, box = boxes_[i].get(), i] {
+          std::uint64_t value = i;
+          while (!stop_.load(std::memory_order_relaxed)) {
+            if (completion_base* op = box->op_.exchange(nullptr, std::memory_order_acquire)) {
+              op->complete_(op, value++);
+            } else {
+              std::this_thread::yield();
+            }
+          }
+        });
+      }
+    }
+
+    ~workers() {
+      stop_.store(true);
+      for (std::thread& thread: threads_) {
+        thread.join();
+      }
+    }
+
+    std::size_t size() const noexcept {
+      return boxes_.size();
+    }
+
+    mailbox* box(std::size_t i) const noexcept {
+      return boxes_[i].get();
+    }
+  };
+
+  // Only the workers of the running benchmark are kept, so that idle workers
+  // do not compete for the cores.
+  class worker_sets {
+    std::unique_ptr<workers> workers_;
+
+   public:
+    const workers& get(std::size_t n) {
+      if (!workers_ || workers_->size() != n) {
+        workers_.reset();
+        workers_ = std::make_unique<workers>(n);
+      }
+      return *workers_;
+    }
+  };
+
+  struct scheduler_env {
+    friend exec::inline_scheduler tag_invoke(
+      ex::get_completion_scheduler_t<ex::set_value_t>,
+      const scheduler_env&) noexcept {
+      return {};
+    }
+  };
+
+  // Completes with a payload on the worker that polls its mailbox. With
+  // AdvertiseScheduler, its environment has a completion scheduler.
+  template <bool AdvertiseScheduler>
+  struct remote_sender {
+    using is_sender = void;
+    using completion_signatures = ex::completion_signatures<ex::set_value_t(payload)>;
+
+    mailbox* box_;
+
+    template <class Receiver>
+    struct operation : completion_base {
+      Receiver rcvr_;
+      mailbox* box_;
+
+      operation(Receiver rcvr, mailbox* box)
+        : completion_base{&complete}
+        , rcvr_{std::move(rcvr)}
+        , box_{box} {
+      }
+
+      static void complete(completion_base* base, std::uint64_t value) noexcept {
+        auto* self = static_cast<operation*>(base);
+        ex::set_value(std::move(self->rcvr_), payload{value, value + 1, value + 2, value + 3});
+      }
+
+      friend void tag_invoke(ex::start_t, operation& self) noexcept {
+        self.box_->op_.store(&self, std::memory_order_release);
+      }
+    };
+
+    template <class Receiver>
+    friend operation<Receiver> tag_invoke(ex::connect_t, remote_sender self, Receiver rcvr) {
+      return {std::move(rcvr), self.box_};
+    }
+
+    friend auto tag_invoke(ex::get_env_t, const remote_sender&) noexcept {
+      if constexpr (AdvertiseScheduler) {
+        return scheduler_env{};
+      } else {
+        return ex::empty_env{};
+      }
+    }
+  };
+
+  struct done_receiver {
+    using is_receiver = void;
+    std::atomic<bool>* done_;
+    std::uint64_t* sum_;
+
+    template <class... Payloads>
+    friend void tag_invoke(ex::set_value_t, done_receiver&& self, Payloads&&... ps) noexcept {
+      *self.sum_ += (ps[0] + ...);
+      self.done_->store(true, std::memory_order_release);
+    }
+
+    friend void tag_invoke(ex::set_stopped_t, done_receiver&&) noexcept {
+    }
+
+    friend ex::empty_env tag_invoke(ex::get_env_t, const done_receiver&) noexcept {
+      return {};
+    }
+  };
+
+  template <bool AdvertiseScheduler, std::size_t... Is>
+  void run_when_all(bench::state& state, const workers& w, std::index_sequence<Is...>) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < state.iterations; ++i) {
+      std::atomic<bool> done{false};
+      auto op = ex::connect(
+        ex::when_all(remote_sender<AdvertiseScheduler>{w.box(Is)}...),
+        done_receiver{&done, &sum});
+      ex::start(op);
+      while (!done.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+    }
+    bench::do_not_optimize(sum);
+  }
+
+  template <std::size_t N>
+  void add_benchmarks(bench::suite& suite, worker_sets& sets) {
+    const std::string suffix = "/children:" + std::to_string(N);
+    suite.add("when_all/packed" + suffix, [&sets](bench::state& state) {
+      run_when_all<false>(state, sets.get(N), std::make_index_sequence<N>{});
+    });
+    suite.add("when_all/padded" + suffix, [&sets](bench::state& state) {
+      run_when_all<true>(state, sets.get(N), std::make_index_sequence<N>{});
+    });
+  }
+}
+
+int main(int argc, char** argv) {
+  worker_sets sets;
+  bench::suite suite;
+  add_benchmarks<2>(suite, sets);
+  add_benchmarks<4>(suite, sets);
+  add_benchmarks<8>(suite, sets);
+  return suite.run(argc, argv);
+}
@@ -0,0 +1,448 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../../stdexec/__detail/__config.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+
+// When STDEXEC_SCHEDULER_TRACING is defined to a nonzero value, the execution
+// contexts in exec record when each of their tasks was enqueued, when it
+// started running and when it finished. See exec/scheduler_tracing.hpp for
+// how to read the recorded data. Otherwise the recording compiles away. The
+// macro must have the same value in every translation unit of a program.
+#ifndef STDEXEC_SCHEDULER_TRACING
+#define STDEXEC_SCHEDULER_TRACING 0
+#endif
+
+namespace exec {
+  namespace __tracing {
+    inline std::uint64_t __now() noexcept {
+      return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+    }
+
+    // A single-writer counter. Only the thread that owns it adds to it, so
+    // the update needs no read-modify-write, but other threads may read it.
+    class __relaxed_counter {
+      std::atomic<std::uint64_t> __value_{0};
+
+     public:
+      void __add(std::uint64_t __n) noexcept {
+        __value_.store(__value_.load(std::memory_order_relaxed) + __n, std::memory_order_relaxed);
+      }
+
+      void __raise(std::uint64_t __n) noexcept {
+        if (__n > __value_.load(std::memory_order_relaxed)) {
+          __value_.store(__n, std::memory_order_relaxed);
+        }
+      }
+
+      void __reset() noexcept {
+        __value_.store(0, std::memory_order_relaxed);
+      }
+
+      std::uint64_t __get() const noexcept {
+        return __value_.load(std::memory_order_relaxed);
+      }
+    };
+
+    inline void __add(std::uint64_t& __counter, std::uint64_t __n) noexcept {
+      __counter += __n;
+    }
+
+    inline void __add(__relaxed_counter& __counter, std::uint64_t __n) noexcept {
+      __counter.__add(__n);
+    }
+
+    inline void __raise(std::uint64_t& __counter, std::uint64_t __n) noexcept {
+      __counter = __n > __counter ? __n : __counter;
+    }
+
+    inline void __raise(__relaxed_counter& __counter, std::uint64_t __n) noexcept {
+      __counter.__raise(__n);
+    }
+
+    inline std::uint64_t __get(std::uint64_t __counter) noexcept {
+      return __counter;
+    }
+
+    inline std::uint64_t __get(const __relaxed_counter& __counter) noexcept {
+      return __counter.__get();
+    }
+
+    // Histogram buckets in the style of HdrHistogram: every power of two is
+    // split into 16 linear sub-buckets, which bounds the relative error of a
+    // recorded value by 1/16. Values of 2^48 ns (about three days) and more
+    // share the last bucket.
+    inline constexpr std::uint32_t __sub_bucket_bits = 4;
+    inline constexpr std::uint32_t __sub_bucket_count = 1u << __sub_bucket_bits;
+    inline constexpr std::uint32_t __max_exponent = 48;
+    inline constexpr std::size_t __bucket_count = //
+      (__max_exponent - __sub_bucket_bits + 1) * __sub_bucket_count;
+
+    inline constexpr std::size_t __bucket_index(std::uint64_t __value) noexcept {
+      __value = __value < (std::uint64_t{1} << __max_exponent)
+                ? __value
+                : (std::uint64_t{1} << __max_exponent) - 1;
+      if (__value < __sub_bucket_count) {
+        return static_cast<std::size_t>(__value);
+      }
+      const std::uint32_t __exp = static_cast<std::uint32_t>(std::bit_width(__value)) - 1;
+      const std::uint32_t __shift = __exp - __sub_bucket_bits;
+      return (__exp - __sub_bucket_bits + 1) * __sub_bucket_count
+           + static_cast<std::size_t>((__value >> __shift) & (__sub_bucket_count - 1));
+    }
+
+    // The smallest value that falls into the bucket at __index.
+    inline constexpr std::uint64_t __bucket_lower_bound(std::size_t __index) noexcept {
+      if (__index < __sub_bucket_count) {
+        return __index;
+      }
+      const std::size_t __shift = __index / __sub_bucket_count - 1;
+      const std::uint64_t __sub = __index % __sub_bucket_count;
+      return (__sub_bucket_count + __sub) << __shift;
+    }
+
+    // The largest value that falls into the bucket at __index.
+    inline constexpr std::uint64_t __bucket_upper_bound(std::size_t __index) noexcept {
+      return __index + 1 < __bucket_count ? __bucket_lower_bound(__index + 1) - 1 : UINT64_MAX;
+    }
+
+    template <class _Counter>
+    class __basic_histogram {
+      template <class>
+      friend class __basic_histogram;
+
+      std::array<_Counter, __bucket_count> __buckets_{};
+      _Counter __count_{};
+      _Counter __sum_{};
+      _Counter __max_{};
+
+     public:
+      // Adds a value, typically a duration in nanoseconds.
+      void record(std::uint64_t __value) noexcept {
+        __tracing::__add(__buckets_[__tracing::__bucket_index(__value)], 1);
+        __tracing::__add(__count_, 1);
+        __tracing::__add(__sum_, __value);
+        __tracing::__raise(__max_, __value);
+      }
+
+      // Adds all values recorded by another histogram.
+      template <class _OtherCounter>
+      void merge(const __basic_histogram<_OtherCounter>& __other) noexcept {
+        for (std::size_t __i = 0; __i < __bucket_count; ++__i) {
+          __tracing::__add(__buckets_[__i], __tracing::__get(__other.__buckets_[__i]));
+        }
+        __tracing::__add(__count_, __tracing::__get(__other.__count_));
+        __tracing::__add(__sum_, __tracing::__get(__other.__sum_));
+        __tracing::__raise(__max_, __tracing::__get(__other.__max_));
+      }
+
+      void reset() noexcept {
+        *this = __basic_histogram{};
+      }
+
+      std::uint64_t count() const noexcept {
+        return __tracing::__get(__count_);
+      }
+
+      std::uint64_t sum() const noexcept {
+        return __tracing::__get(__sum_);
+      }
+
+      std::uint64_t max() const noexcept {
+        return __tracing::__get(__max_);
+      }
+
+      double mean() const noexcept {
+        const std::uint64_t __n = count();
+        return __n == 0 ? 0.0 : static_cast<double>(sum()) / static_cast<double>(__n);
+      }
+
+      // The smallest value v such that at least the given fraction (between
+      // 0 and 1) of the recorded values are no greater than v, up to the
+      // precision of the buckets. Returns 0 if nothing was recorded.
+      std::uint64_t percentile(double __fraction) const noexcept {
+        const std::uint64_t __n = count();
+        if (__n == 0) {
+          return 0;
+        }
+        __fraction = __fraction < 0.0 ? 0.0 : (__fraction > 1.0 ? 1.0 : __fraction);
+        std::uint64_t __rank = static_cast<std::uint64_t>(
+          std::ceil(__fraction * static_cast<double>(__n)));
+        __rank = __rank == 0 ? 1 : __rank;
+        std::uint64_t __seen = 0;
+        for (std::size_t __i = 0; __i < __bucket_count; ++__i) {
+          __seen += __tracing::__get(__buckets_[__i]);
+          if (__seen >= __rank) {
+            const std::uint64_t __upper = __tracing::__bucket_upper_bound(__i);
+            return __upper < max() ? __upper : max();
+          }
+        }
+        return max();
+      }
+    };
+
+    template <>
+    inline void __basic_histogram<__relaxed_counter>::reset() noexcept {
+      for (__relaxed_counter& __bucket: __buckets_) {
+        __bucket.__reset();
+      }
+      __count_.__reset();
+      __sum_.__reset();
+      __max_.__reset();
+    }
+
+    struct __event {
+      const char* __scheduler_;
+      std::uint64_t __enqueued_;
+      std::uint64_t __started_;
+      std::uint64_t __finished_;
+    };
+
+    struct __event_chunk {
+      static constexpr std::size_t __capacity = 1024;
+      std::array<__event, __capacity> __events_;
+      std::atomic<std::size_t> __size_{0};
+      std::atomic<__event_chunk*> __next_{nullptr};
+    };
+
+    struct __scheduler_slot {
+      const char* __scheduler_;
+      __basic_histogram<__relaxed_counter> __queue_delay_{};
+      __basic_histogram<__relaxed_counter> __execution_{};
+    };
+
+    inline bool __same_scheduler(const char* __lhs, const char* __rhs) noexcept {
+      return __lhs == __rhs || std::strcmp(__lhs, __rhs) == 0;
+    }
+
+    // Everything one thread has recorded. Only that thread writes to it;
+    // other threads may read it at any time. A log outlives its thread so
+    // that the tasks of a joined thread pool can still be reported.
+    struct __thread_log {
+      static constexpr std::size_t __max_schedulers = 8;
+
+      std::uint32_t __index_;
+      __thread_log* __next_ = nullptr;
+      std::array<std::atomic<__scheduler_slot*>, __max_schedulers> __slots_{};
+      std::atomic<__event_chunk*> __first_chunk_{nullptr};
+      __event_chunk* __last_chunk_ = nullptr;
+      __relaxed_counter __n_events_{};
+      __relaxed_counter __n_dropped_{};
+
+      explicit __thread_log(std::uint32_t __index) noexcept
+        : __index_(__index) {
+      }
+
+      ~__thread_log() {
+        for (std::atomic<__scheduler_slot*>& __slot: __slots_) {
+          delete __slot.load(std::memory_order_relaxed);
+        }
+        __event_chunk* __chunk = __first_chunk_.load(std::memory_order_relaxed);
+        while (__chunk) {
+          delete std::exchange(__chunk, __chunk->__next_.load(std::memory_order_relaxed));
+        }
+      }
+
+      __scheduler_slot* __slot_for(const char* __scheduler) noexcept {
+        for (std::atomic<__scheduler_slot*>& __slot: __slots_) {
+          __scheduler_slot* __current = __slot.load(std::memory_order_relaxed);
+          if (__current == nullptr) {
+            __current = new (std::nothrow) __scheduler_slot{__scheduler};
+            __slot.store(__current, std::memory_order_release);
+            return __current;
+          }
+          if (__tracing::__same_scheduler(__current->__scheduler_, __scheduler)) {
+            return __current;
+          }
+        }
+        return nullptr;
+      }
+
+      void __append(const __event& __ev, std::size_t __limit) noexcept {
+        if (__n_events_.__get() >= __limit) {
+          __n_dropped_.__add(1);
+          return;
+        }
+        __event_chunk* __chunk = __last_chunk_;
+        if (
+          __chunk == nullptr
+          || __chunk->__size_.load(std::memory_order_relaxed) == __event_chunk::__capacity) {
+          // Chunks are kept across a reset, so reuse the next one if there is one.
+          __event_chunk* __next = __chunk ? __chunk->__next_.load(std::memory_order_relaxed)
+                                          : __first_chunk_.load(std::memory_order_relaxed);
+          if (__next == nullptr) {
+            __next = new (std::nothrow) __event_chunk;
+            if (__next == nullptr) {
+              __n_dropped_.__add(1);
+              return;
+            }
+            (__chunk ? __chunk->__next_ : __first_chunk_).store(__next, std::memory_order_release);
+          }
+          __chunk = __last_chunk_ = __next;
+        }
+        const std::size_t __size = __chunk->__size_.load(std::memory_order_relaxed);
+        __chunk->__events_[__size] = __ev;
+        __chunk->__size_.store(__size + 1, std::memory_order_release);
+        __n_events_.__add(1);
+      }
+
+      void __reset() noexcept {
+        for (std::atomic<__scheduler_slot*>& __slot: __slots_) {
+          if (__scheduler_slot* __current = __slot.load(std::memory_order_acquire)) {
+            __current->__queue_delay_.reset();
+            __current->__execution_.reset();
+          }
+        }
+        for (__event_chunk* __chunk = __first_chunk_.load(std::memory_order_acquire); __chunk;
+             __chunk = __chunk->__next_.load(std::memory_order_acquire)) {
+          __chunk->__size_.store(0, std::memory_order_relaxed);
+        }
+        __last_chunk_ = nullptr;
+        __n_events_.__reset();
+        __n_dropped_.__reset();
+      }
+    };
+
+    class __registry {
+      std::atomic<__thread_log*> __logs_{nullptr};
+      std::atomic<std::uint32_t> __n_threads_{0};
+      const std::uint64_t __epoch_ = __tracing::__now();
+
+      __thread_log* __register_thread() noexcept {
+        auto* __log = new (std::nothrow)
+          __thread_log{__n_threads_.fetch_add(1, std::memory_order_relaxed)};
+        if (__log) {
+          __thread_log* __head = __logs_.load(std::memory_order_relaxed);
+          do {
+            __log->__next_ = __head;
+          } while (!__logs_.compare_exchange_weak(__head, __log, std::memory_order_acq_rel));
+        }
+        return __log;
+      }
+
+     public:
+      std::atomic<std::size_t> __event_limit_{std::size_t{1} << 16};
+
+      __registry() = default;
+      __registry(__registry&&) = delete;
+
+      ~__registry() {
+        __thread_log* __log = __logs_.load(std::memory_order_acquire);
+        while (__log) {
+          delete std::exchange(__log, __log->__next_);
+        }
+      }
+
+      std::uint64_t __epoch() const noexcept {
+        return __epoch_;
+      }
+
+      // The log of the calling thread, or nullptr if it could not be allocated.
+      __thread_log* __local() noexcept {
+        thread_local __thread_log* __log = __register_thread();
+        return __log;
+      }
+
+      template <class _Fn>
+      void __for_each_log(_Fn __fn) const {
+        for (__thread_log* __log = __logs_.load(std::memory_order_acquire); __log;
+             __log = __log->__next_) {
+          __fn(*__log);
+        }
+      }
+    };
+
+    inline __registry __the_registry{};
+
+    inline void __record(
+      const char* __scheduler,
+      std::uint64_t __enqueued,
+      std::uint64_t __started,
+      std::uint64_t __finished) noexcept {
+      __thread_log* __log = __the_registry.__local();
+      if (__log == nullptr) {
+        return;
+      }
+      if (__scheduler_slot* __slot = __log->__slot_for(__scheduler)) {
+        __slot->__queue_delay_.record(__started - __enqueued);
+        __slot->__execution_.record(__finished - __started);
+      }
+      __log->__append(
+        __event{__scheduler, __enqueued, __started, __finished},
+        __the_registry.__event_limit_.load(std::memory_order_relaxed));
+    }
+
+    // A base for the tasks of an execution context that remembers when the
+    // task was enqueued. It is empty unless tracing is enabled.
+    struct __traced_task {
+#if STDEXEC_SCHEDULER_TRACING
+      std::uint64_t __enqueued_ = 0;
+#endif
+
+      void __mark_enqueued() noexcept {
+#if STDEXEC_SCHEDULER_TRACING
+        __enqueued_ = __tracing::__now();
+#endif
+      }
+    };
+
+    // Records a task that runs for the lifetime of this object. Construct it
+    // right before the task is executed, since executing the task may
+    // destroy it. Tasks that were never marked as enqueued are not recorded.
+    class __task_scope {
+#if STDEXEC_SCHEDULER_TRACING
+      const char* __scheduler_;
+      std::uint64_t __enqueued_;
+      std::uint64_t __started_;
+#endif
+
+     public:
+      __task_scope(
+        [[maybe_unused]] const char* __scheduler,
+        [[maybe_unused]] __traced_task& __task) noexcept
+#if STDEXEC_SCHEDULER_TRACING
+        : __scheduler_(__scheduler)
+        , __enqueued_(std::exchange(__task.__enqueued_, 0))
+        , __started_(__enqueued_ ? __tracing::__now() : 0)
+#endif
+      {
+      }
+
+      __task_scope(__task_scope&&) = delete;
+
+      ~__task_scope() {
+#if STDEXEC_SCHEDULER_TRACING
+        if (__enqueued_ != 0) {
+          __tracing::__record(__scheduler_, __enqueued_, __started_, __tracing::__now());
+        }
+#endif
+      }
+    };
+  } // namespace __tracing
+} // namespace exec
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../stdexec/__detail/__allocation_hooks.hpp"
+
+namespace exec {
+  /////////////////////////////////////////////////////////////////////////////
+  // set_allocation_hook(hook)
+  //
+  // Installs a function that is called before every allocation made by
+  // stdexec and exec, e.g. for the shared state of split and ensure_started,
+  // the operations spawned on an async_scope, the tasks of a bulk operation
+  // on static_thread_pool, type-erased senders that do not fit their inline
+  // storage and the frames of exec::task. The hook receives the name of the
+  // allocating algorithm and the size of the allocation, and may be called
+  // concurrently from several threads. Returns the previously installed
+  // hook; pass nullptr to uninstall it.
+  //
+  // The hook is only called if STDEXEC_ALLOCATION_HOOKS is defined to a
+  // nonzero value for the whole program.
+  using allocation_hook_t = stdexec::__allocation_hook_t;
+
+  inline allocation_hook_t set_allocation_hook(allocation_hook_t __hook) noexcept {
+    return stdexec::__allocation_hook.exchange(__hook, std::memory_order_acq_rel);
+  }
+} // namespace exec
@@ -19,8 +19,30 @@
 #include "./sequence_senders.hpp"
 
 #include <cstddef>
+#include <memory>
+#include <utility>
+#include <variant>
 
 namespace exec {
+  /////////////////////////////////////////////////////////////////////////////
+  // any_storage<_InlineSize, _Allocator, _OperationInlineSize>
+  //
+  // Storage policy of a type-erased sender. A sender whose size is at most
+  // _InlineSize bytes, or an operation state whose size is at most
+  // _OperationInlineSize bytes, is stored inline. Larger objects are allocated
+  // with _Allocator. If the environment of the connected receiver provides an
+  // allocator that _Allocator can be constructed from, operation states are
+  // allocated with that one instead of a default constructed _Allocator.
+  template <
+    std::size_t _InlineSize = 3 * sizeof(void*),
+    class _Allocator = std::allocator<std::byte>,
+    std::size_t _OperationInlineSize = _InlineSize>
+  struct any_storage {
+    static constexpr std::size_t inline_size = _InlineSize;
+    static constexpr std::size_t operation_inline_size = _OperationInlineSize;
+    using allocator_type = _Allocator;
+  };
+
   namespace __any {
     using namespace stdexec;
 
@@ -227,8 +249,10 @@ namespace exec {
       return &__null_storage_vtbl<_ParentVTable, _StorageCPOs...>;
     }
 
+    // Inline so that every translation unit agrees on the address, which is
+    // what __storage::__t::__holds compares against.
     template <class _Storage, class _Tp, class _ParentVTable, class... _StorageCPOs>
-    static const __storage_vtable<_ParentVTable, _StorageCPOs...> __storage_vtbl{
+    inline const __storage_vtable<_ParentVTable, _StorageCPOs...> __storage_vtbl{
       {*__create_vtable(__mtype<_ParentVTable>{}, __mtype<_Tp>{})},
       {__storage_vfun_fn<_Storage, _Tp>{}((_StorageCPOs*) nullptr)}...};
 
@@ -264,6 +288,7 @@ namespace exec {
         }
        public:
         using __id = __immovable_storage;
+        using __allocator_t = _Allocator;
 
         __t() = default;
 
@@ -290,6 +315,22 @@ namespace exec {
           }
         }
 
+        template <class _Tp, class... _Args>
+          requires __callable<__create_vtable_t, __mtype<_Vtable>, __mtype<_Tp>>
+        __t(
+          std::allocator_arg_t,
+          const _Allocator& __alloc,
+          std::in_place_type_t<_Tp>,
+          _Args&&... __args)
+          : __vtable_{__get_vtable_of_type<_Tp>()}
+          , __allocator_{__alloc} {
+          if constexpr (__is_small<_Tp>) {
+            __construct_small<_Tp>((_Args&&) __args...);
+          } else {
+            __construct_large<_Tp>((_Args&&) __args...);
+          }
+        }
+
         ~__t() {
           __reset();
         }
@@ -323,6 +364,10 @@ namespace exec {
         void __construct_large(_As&&... __args) {
           using _Alloc = typename std::allocator_traits<_Allocator>::template rebind_alloc<_Tp>;
           _Alloc __alloc{__allocator_};
+          if constexpr (__is_instance_of<_Allocator, std::allocator>) {
+            // Other allocators report the allocations that they make themselves.
+            stdexec::__trace_allocation("any_sender", sizeof(_Tp));
+          }
           _Tp* __pointer = std::allocator_traits<_Alloc>::allocate(__alloc, 1);
           try {
             std::allocator_traits<_Alloc>::construct(__alloc, __pointer, (_As&&) __args...);
@@ -412,6 +457,19 @@ namespace exec {
         }
       }
 
+      template <__not_decays_to<__t> _Tp>
+        requires __callable<__create_vtable_t, __mtype<_Vtable>, __mtype<__decay_t<_Tp>>>
+      __t(std::allocator_arg_t, const _Allocator& __alloc, _Tp&& __object)
+        : __vtable_{__get_vtable_of_type<_Tp>()}
+        , __allocator_{__alloc} {
+        using _Dp = __decay_t<_Tp>;
+        if constexpr (__is_small<_Dp>) {
+          __construct_small<_Dp>((_Tp&&) __object);
+        } else {
+          __construct_large<_Dp>((_Tp&&) __object);
+        }
+      }
+
       template <class _Tp, class... _Args>
         requires __callable<__create_vtable_t, __mtype<_Vtable>, __mtype<_Tp>>
       __t(std::in_place_type_t<_Tp>, _Args&&... __args)
@@ -425,7 +483,8 @@ namespace exec {
 
       __t(const __t& __other)
         requires(_Copyable)
-      {
+        : __allocator_{std::allocator_traits<_Allocator>::select_on_container_copy_construction(
+          __other.__allocator_)} {
         (*__other.__vtable_)(__copy_construct, this, __other);
       }
 
@@ -436,12 +495,21 @@ namespace exec {
         return *this = std::move(tmp);
       }
 
-      __t(__t&& __other) noexcept {
+      __t(__t&& __other) noexcept
+        : __allocator_{__other.__allocator_} {
         (*__other.__vtable_)(__move_construct, this, (__t&&) __other);
       }
 
       __t& operator=(__t&& __other) noexcept {
         __reset();
+        // A heap allocated object changes hands together with the allocator
+        // that has to free it.
+        if constexpr (std::is_copy_assignable_v<_Allocator>) {
+          __allocator_ = __other.__allocator_;
+        } else {
+          std::destroy_at(&__allocator_);
+          std::construct_at(&__allocator_, __other.__allocator_);
+        }
         (*__other.__vtable_)(__move_construct, this, (__t&&) __other);
         return *this;
       }
@@ -464,6 +532,12 @@ namespace exec {
         return __object_pointer_;
       }
 
+      // Whether the stored object is of type _Tp.
+      template <class _Tp>
+      bool __holds() const noexcept {
+        return __vtable_ == __get_vtable_of_type<_Tp>();
+      }
+
      private:
       template <class _Tp, class... _As>
       void __construct_small(_As&&... __args) {
@@ -479,6 +553,10 @@ namespace exec {
       void __construct_large(_As&&... __args) {
         using _Alloc = typename std::allocator_traits<_Allocator>::template rebind_alloc<_Tp>;
         _Alloc __alloc{__allocator_};
+        if constexpr (__is_instance_of<_Allocator, std::allocator>) {
+          // Other allocators report the allocations that they make themselves.
+          stdexec::__trace_allocation("any_sender", sizeof(_Tp));
+        }
         _Tp* __pointer = std::allocator_traits<_Alloc>::allocate(__alloc, 1);
         try {
           std::allocator_traits<_Alloc>::construct(__alloc, __pointer, (_As&&) __args...);
@@ -756,8 +834,28 @@ namespace exec {
       }
     };
 
+    template <class _Allocator, std::size_t _InlineSize>
+    using __immovable_operation_storage_t = stdexec::__t<
+      __immovable_storage<__operation_vtable, _Allocator, alignof(std::max_align_t), _InlineSize>>;
+
     using __immovable_operation_storage = __immovable_storage_t<__operation_vtable>;
 
+    template <class _Env, class _Allocator>
+    concept __env_with_allocator_for = //
+      __callable<get_allocator_t, const _Env&>
+      && constructible_from<_Allocator, __call_result_t<get_allocator_t, const _Env&>>;
+
+    // Returns the allocator of the receiver's environment if it is usable for
+    // allocating type-erased operation states, or a default constructed one.
+    template <class _Allocator, class _Env>
+    _Allocator __allocator_from_env(const _Env& __env) noexcept {
+      if constexpr (__env_with_allocator_for<_Env, _Allocator>) {
+        return _Allocator(get_allocator(__env));
+      } else {
+        return _Allocator{};
+      }
+    }
+
     template <class _Sigs, class _Queries>
     using __receiver_ref = __mapply<__mbind_front<__q<__rec::__ref>, _Sigs>, _Queries>;
 
@@ -829,7 +927,7 @@ namespace exec {
     template <class _ReceiverId>
     using __stoppable_receiver_t = stdexec::__t<__stoppable_receiver<_ReceiverId>>;
 
-    template <class _ReceiverId, bool>
+    template <class _ReceiverId, bool, class _Storage = __immovable_operation_storage>
     struct __operation {
       using _Receiver = stdexec::__t<_ReceiverId>;
 
@@ -841,12 +939,14 @@ namespace exec {
         __t(_Sender&& __sender, _Receiver&& __receiver)
           : __operation_base<_Receiver>{static_cast<_Receiver&&>(__receiver)}
           , __rec_{this}
-          , __storage_{__sender.__connect(__rec_)} {
+          , __storage_{__sender.__connect(
+              __rec_,
+              __allocator_from_env<typename _Storage::__allocator_t>(get_env(this->__rcvr_)))} {
         }
 
        private:
         __stoppable_receiver_t<_ReceiverId> __rec_;
-        __immovable_operation_storage __storage_{};
+        _Storage __storage_{};
 
         friend void tag_invoke(start_t, __t& __self) noexcept {
           __self.__on_stop_.emplace(
@@ -858,8 +958,8 @@ namespace exec {
       };
     };
 
-    template <class _ReceiverId>
-    struct __operation<_ReceiverId, false> {
+    template <class _ReceiverId, class _Storage>
+    struct __operation<_ReceiverId, false, _Storage> {
       using _Receiver = stdexec::__t<_ReceiverId>;
 
       class __t {
@@ -869,12 +969,14 @@ namespace exec {
         template <class _Sender>
         __t(_Sender&& __sender, _Receiver&& __receiver)
           : __rec_{static_cast<_Receiver&&>(__receiver)}
-          , __storage_{__sender.__connect(__rec_)} {
+          , __storage_{__sender.__connect(
+              __rec_,
+              __allocator_from_env<typename _Storage::__allocator_t>(get_env(__rec_)))} {
         }
 
        private:
         STDEXEC_NO_UNIQUE_ADDRESS _Receiver __rec_;
-        __immovable_operation_storage __storage_{};
+        _Storage __storage_{};
 
         friend void tag_invoke(start_t, __t& __self) noexcept {
           STDEXEC_ASSERT(__self.__storage_.__get_vtable()->__start_);
@@ -901,11 +1003,18 @@ namespace exec {
       }
     };
 
-    template <class _Sigs, class _SenderQueries = __types<>, class _ReceiverQueries = __types<>>
+    template <
+      class _Sigs,
+      class _SenderQueries = __types<>,
+      class _ReceiverQueries = __types<>,
+      class _Storage = any_storage<>>
     struct __sender {
       using __receiver_ref_t = __receiver_ref<_Sigs, _ReceiverQueries>;
       static constexpr bool __with_in_place_stop_token =
         __v<__mapply<__mall_of<__q<__is_not_stop_token_query_v>>, _ReceiverQueries>>;
+      using __allocator_t = typename _Storage::allocator_type;
+      using __operation_storage_t =
+        __immovable_operation_storage_t<__allocator_t, _Storage::operation_inline_size>;
 
       class __vtable : public __query_vtable<_SenderQueries> {
        public:
@@ -915,19 +1024,19 @@ namespace exec {
           return *this;
         }
 
-        __immovable_operation_storage (*__connect_)(void*, __receiver_ref_t);
+        __operation_storage_t (*__connect_)(void*, __receiver_ref_t, const __allocator_t&);
        private:
         template <sender_to<__receiver_ref_t> _Sender>
         friend const __vtable*
           tag_invoke(__create_vtable_t, __mtype<__vtable>, __mtype<_Sender>) noexcept {
           static const __vtable __vtable_{
             {*__create_vtable(__mtype<__query_vtable<_SenderQueries>>{}, __mtype<_Sender>{})},
-            [](void* __object_pointer, __receiver_ref_t __receiver)
-              -> __immovable_operation_storage {
+            [](void* __object_pointer, __receiver_ref_t __receiver, const __allocator_t& __alloc)
+              -> __operation_storage_t {
               _Sender& __sender = *static_cast<_Sender*>(__object_pointer);
               using __op_state_t = connect_result_t<_Sender, __receiver_ref_t>;
-              return __immovable_operation_storage{
-                std::in_place_type<__op_state_t>, __conv{[&] {
+              return __operation_storage_t{
+                std::allocator_arg, __alloc, std::in_place_type<__op_state_t>, __conv{[&] {
                   return stdexec::connect((_Sender&&) __sender, (__receiver_ref_t&&) __receiver);
                 }}};
             }};
@@ -972,20 +1081,46 @@ namespace exec {
           : __storage_{(_Sender&&) __sndr} {
         }
 
-        __immovable_operation_storage __connect(__receiver_ref_t __receiver) {
+        template <__not_decays_to<__t> _Sender>
+          requires sender_to<_Sender, __receiver_ref<_Sigs, _ReceiverQueries>>
+        __t(std::allocator_arg_t, const __allocator_t& __alloc, _Sender&& __sndr)
+          : __storage_{std::allocator_arg, __alloc, (_Sender&&) __sndr} {
+        }
+
+        __operation_storage_t __connect(__receiver_ref_t __receiver, const __allocator_t& __alloc) {
           return __storage_.__get_vtable()->__connect_(
-            __storage_.__get_object_pointer(), (__receiver_ref_t&&) __receiver);
+            __storage_.__get_object_pointer(), (__receiver_ref_t&&) __receiver, __alloc);
         }
 
         explicit operator bool() const noexcept {
           return __get_object_pointer(__storage_) != nullptr;
         }
 
+        template <class _Sender>
+        bool __holds() const noexcept {
+          return __storage_.template __holds<_Sender>();
+        }
+
+        template <class _Sender>
+        _Sender& __get() noexcept {
+          STDEXEC_ASSERT(__holds<_Sender>());
+          return *static_cast<_Sender*>(__storage_.__get_object_pointer());
+        }
+
        private:
-        __unique_storage_t<__vtable> __storage_;
+        stdexec::__t<__storage<
+          __vtable,
+          __allocator_t,
+          false,
+          alignof(std::max_align_t),
+          _Storage::inline_size>>
+          __storage_;
 
         template <receiver_of<_Sigs> _Rcvr>
-        friend stdexec::__t<__operation<stdexec::__id<__decay_t<_Rcvr>>, __with_in_place_stop_token>>
+        friend stdexec::__t<__operation<
+          stdexec::__id<__decay_t<_Rcvr>>,
+          __with_in_place_stop_token,
+          __operation_storage_t>>
           tag_invoke(connect_t, __t&& __self, _Rcvr&& __rcvr) {
           return {(__t&&) __self, (_Rcvr&&) __rcvr};
         }
@@ -996,6 +1131,65 @@ namespace exec {
       };
     };
 
+    // The operation state of a sender that was erased with hints. If the erased
+    // sender holds one of the hinted types it is connected directly to the
+    // receiver, so that start and the completions are ordinary calls that the
+    // compiler can inline. Otherwise it falls back to the type-erased connect.
+    template <class _ReceiverId, class _Base, class... _Hints>
+    struct __hinted_operation {
+      using _Receiver = stdexec::__t<_ReceiverId>;
+
+      class __t : __immovable {
+        using __erased_op_t = connect_result_t<_Base, _Receiver>;
+        using __indices = std::index_sequence_for<_Hints..., _Base>;
+
+        std::variant<std::monostate, connect_result_t<_Hints, _Receiver>..., __erased_op_t> __op_{};
+
+        template <std::size_t _Ip, class _Hint>
+        bool __try_connect(_Base& __sndr, _Receiver& __rcvr) {
+          if (!__sndr.template __holds<_Hint>()) {
+            return false;
+          }
+          __op_.template emplace<_Ip + 1>(__conv{[&] {
+            return stdexec::connect(
+              static_cast<_Hint&&>(__sndr.template __get<_Hint>()),
+              static_cast<_Receiver&&>(__rcvr));
+          }});
+          return true;
+        }
+
+        template <std::size_t... _Is>
+        void __connect(_Base& __sndr, _Receiver& __rcvr, std::index_sequence<_Is...>) {
+          if (!(__try_connect<_Is, _Hints>(__sndr, __rcvr) || ...)) {
+            __op_.template emplace<sizeof...(_Hints) + 1>(__conv{[&] {
+              return stdexec::connect(
+                static_cast<_Base&&>(__sndr), static_cast<_Receiver&&>(__rcvr));
+            }});
+          }
+        }
+
+        template <std::size_t... _Is>
+        void __start(std::index_sequence<_Is...>) noexcept {
+          // A chain of index checks rather than std::visit, which would
+          // dispatch through a table of function pointers again.
+          (void) ((__op_.index() == _Is + 1
+                   && (stdexec::start(*std::get_if<_Is + 1>(&__op_)), true))
+                  || ...);
+        }
+
+       public:
+        using __id = __hinted_operation;
+
+        __t(_Base&& __sndr, _Receiver&& __rcvr) {
+          __connect(__sndr, __rcvr, std::index_sequence_for<_Hints...>{});
+        }
+
+        friend void tag_invoke(start_t, __t& __self) noexcept {
+          __self.__start(__indices{});
+        }
+      };
+    };
+
     template <class _ScheduleSender, class _SchedulerQueries = __types<>>
     class __scheduler {
      public:
@@ -1102,13 +1296,18 @@ namespace exec {
       : __receiver_(__receiver) {
     }
 
-    template <auto... _SenderQueries>
-    class any_sender {
-      using __sender_base = stdexec::__t<
-        __any::__sender<_Completions, queries<_SenderQueries...>, queries<_ReceiverQueries...>>>;
+    // A type-erased sender whose storage is described by _Storage, see
+    // any_storage.
+    template <class _Storage, auto... _SenderQueries>
+    class basic_any_sender {
+      using __sender_base = stdexec::__t<__any::__sender<
+        _Completions,
+        queries<_SenderQueries...>,
+        queries<_ReceiverQueries...>,
+        _Storage>>;
       __sender_base __sender_;
 
-      template <class _Tag, stdexec::__decays_to<any_sender> Self, class... _As>
+      template <class _Tag, stdexec::__decays_to<basic_any_sender> Self, class... _As>
         requires stdexec::tag_invocable< _Tag, stdexec::__copy_cvref_t<Self, __sender_base>, _As...>
       friend auto tag_invoke(_Tag, Self&& __self, _As&&... __as) noexcept(
         std::is_nothrow_invocable_v< _Tag, stdexec::__copy_cvref_t<Self, __sender_base>, _As...>) {
@@ -1117,14 +1316,80 @@ namespace exec {
      public:
       using is_sender = void;
       using completion_signatures = typename __sender_base::completion_signatures;
+      using allocator_type = typename _Storage::allocator_type;
 
-      template <stdexec::__not_decays_to<any_sender> _Sender>
+      template <class _NewStorage>
+      using with_storage = basic_any_sender<_NewStorage, _SenderQueries...>;
+
+      // A basic_any_sender that is expected to hold one of the _Hints most of
+      // the time. Connecting it checks the dynamic type against the hints and,
+      // on a match, connects the concrete sender directly to the receiver,
+      // bypassing the vtable for connect, start and the completions. Senders of
+      // other types are handled exactly like basic_any_sender.
+      template <class... _Hints>
+      class with_hint {
+        basic_any_sender __sender_;
+
+        template <class _Tag, stdexec::__decays_to<with_hint> Self, class... _As>
+          requires stdexec::
+            tag_invocable< _Tag, stdexec::__copy_cvref_t<Self, basic_any_sender>, _As...>
+          friend auto tag_invoke(_Tag, Self&& __self, _As&&... __as) noexcept(
+            std::is_nothrow_invocable_v<
+              _Tag,
+              stdexec::__copy_cvref_t<Self, basic_any_sender>,
+              _As...>) {
+          return stdexec::tag_invoke(_Tag{}, ((Self&&) __self).__sender_, (_As&&) __as...);
+        }
+
+        template <class _Receiver>
+        using __operation_t = stdexec::__t<__any::__hinted_operation<
+          stdexec::__id<stdexec::__decay_t<_Receiver>>,
+          __sender_base,
+          _Hints...>>;
+
+        template <stdexec::same_as<with_hint> _Self, class _Receiver>
+          requires stdexec::receiver_of<stdexec::__decay_t<_Receiver>, completion_signatures>
+                && (stdexec::sender_to<_Hints, stdexec::__decay_t<_Receiver>> && ...)
+        friend auto tag_invoke(stdexec::connect_t, _Self&& __self, _Receiver&& __rcvr)
+          -> __operation_t<_Receiver> {
+          return {static_cast<_Self&&>(__self).__base(), static_cast<_Receiver&&>(__rcvr)};
+        }
+
+        __sender_base&& __base() && noexcept {
+          return static_cast<__sender_base&&>(__sender_.__sender_);
+        }
+
+       public:
+        using is_sender = void;
+        using completion_signatures = typename basic_any_sender::completion_signatures;
+
+        template <stdexec::__not_decays_to<with_hint> _Sender>
+          requires stdexec::constructible_from<basic_any_sender, _Sender>
+        with_hint(_Sender&& __sender) noexcept(
+          stdexec::__nothrow_constructible_from<basic_any_sender, _Sender>)
+          : __sender_((_Sender&&) __sender) {
+        }
+
+        template <stdexec::__not_decays_to<with_hint> _Sender>
+          requires stdexec::constructible_from<basic_any_sender, _Sender>
+        with_hint(std::allocator_arg_t, const allocator_type& __alloc, _Sender&& __sender)
+          : __sender_(std::allocator_arg, __alloc, (_Sender&&) __sender) {
+        }
+      };
+
+      template <stdexec::__not_decays_to<basic_any_sender> _Sender>
         requires stdexec::sender_to<_Sender, __receiver_base>
-      any_sender(_Sender&& __sender) noexcept(
+      basic_any_sender(_Sender&& __sender) noexcept(
         stdexec::__nothrow_constructible_from<__sender_base, _Sender>)
         : __sender_((_Sender&&) __sender) {
       }
 
+      template <stdexec::__not_decays_to<basic_any_sender> _Sender>
+        requires stdexec::sender_to<_Sender, __receiver_base>
+      basic_any_sender(std::allocator_arg_t, const allocator_type& __alloc, _Sender&& __sender)
+        : __sender_(std::allocator_arg, __alloc, (_Sender&&) __sender) {
+      }
+
       template <auto... _SchedulerQueries>
       class any_scheduler {
         using __schedule_completions = stdexec::__concat_completion_signatures_t<
@@ -1183,5 +1448,8 @@ namespace exec {
           operator==(const any_scheduler& __self, const any_scheduler& __other) noexcept = default;
       };
     };
+
+    template <auto... _SenderQueries>
+    using any_sender = basic_any_sender<any_storage<>, _SenderQueries...>;
   };
 } // namespace exec
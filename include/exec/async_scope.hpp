@@ -698,12 +698,14 @@ namespace exec {
         // start is noexcept so we can assume that the operation will complete
         // after this, which means we can rely on its self-ownership to ensure
         // that it is eventually deleted
+        stdexec::__trace_allocation("async_scope::spawn", sizeof(__op_t));
         stdexec::start(*new __op_t{nest((_Sender&&) __sndr), (_Env&&) __env, &__impl_});
       }
 
       template <__movable_value _Env = empty_env, sender_in<__env_t<_Env>> _Sender>
       __future_t<_Sender, _Env> spawn_future(_Sender&& __sndr, _Env __env = {}) {
         using __state_t = __future_state<nest_result_t<_Sender>, _Env>;
+        stdexec::__trace_allocation("async_scope::spawn_future", sizeof(__state_t));
         auto __state = std::make_unique<__state_t>(
           nest((_Sender&&) __sndr), (_Env&&) __env, &__impl_);
         stdexec::start(__state->__op_);
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../stdexec/execution.hpp"
+
+namespace exec {
+  /////////////////////////////////////////////////////////////////////////////
+  // bulk_chunked(sndr, shape, fun)
+  //
+  // Like bulk, except that fun is invoked as fun(begin, end, values...) with
+  // contiguous ranges [begin, end) of the indices in [0, shape), so that it
+  // can process a whole range in one call, e.g. with a vectorized loop. The
+  // ranges cover every index exactly once; how they are chosen is up to the
+  // scheduler.
+  //
+  // bulk_chunked is a bulk whose function calls fun with ranges of a single
+  // index, so schedulers run it wherever they run bulk. A scheduler that
+  // knows about chunked functions can instead pass its partition of the
+  // shape directly; static_thread_pool gives each of its tasks one range.
+  namespace __bulk_chunked {
+    using namespace stdexec;
+
+    template <class _Shape, class _Fun>
+    struct __chunk_fn {
+      _Fun __fun_;
+
+      template <class... _As>
+        requires __callable<_Fun&, _Shape, _Shape, _As&...>
+      void operator()(_Shape __i, _As&... __as) //
+        noexcept(__nothrow_callable<_Fun&, _Shape, _Shape, _As&...>) {
+        __fun_(__i, static_cast<_Shape>(__i + 1), __as...);
+      }
+
+      // Calls the function once with the range [begin, end).
+      template <class... _As>
+      void __run_range(_Shape __begin, _Shape __end, _As&... __as) //
+        noexcept(__nothrow_callable<_Fun&, _Shape, _Shape, _As&...>) {
+        __fun_(__begin, __end, __as...);
+      }
+    };
+
+    template <class _Fun>
+    inline constexpr bool __is_chunk_fn = false;
+
+    template <class _Shape, class _Fun>
+    inline constexpr bool __is_chunk_fn<__chunk_fn<_Shape, _Fun>> = true;
+
+    struct bulk_chunked_t {
+      template <sender _Sender, integral _Shape, __movable_value _Fun>
+      auto operator()(_Sender&& __sndr, _Shape __shape, _Fun __fun) const {
+        return stdexec::bulk(
+          (_Sender&&) __sndr, __shape, __chunk_fn<_Shape, _Fun>{(_Fun&&) __fun});
+      }
+
+      template <integral _Shape, class _Fun>
+      __binder_back<bulk_chunked_t, _Shape, _Fun> operator()(_Shape __shape, _Fun __fun) const {
+        return {{}, {}, {(_Shape&&) __shape, (_Fun&&) __fun}};
+      }
+    };
+  } // namespace __bulk_chunked
+
+  using __bulk_chunked::bulk_chunked_t;
+  inline constexpr bulk_chunked_t bulk_chunked{};
+} // namespace exec
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../stdexec/execution.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace exec {
+  // The order in which bulk_tiled numbers the tiles of its extents.
+  enum class tile_order {
+    // Row-major over the grid of tiles: the last dimension varies fastest.
+    row_major,
+    // Z-order over the grid of tiles, which keeps consecutive tiles close in
+    // every dimension.
+    morton
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  // bulk_tiled(sndr, extents, tile, fun [, order])
+  //
+  // A bulk over the multi-dimensional index space [0, extents[0]) x ... x
+  // [0, extents[Rank - 1]), which calls fun(i0, ..., iRank-1, values...) for
+  // every point. The space is cut into tiles of the given size, which should
+  // be chosen so that the data a tile touches fits in cache; a tile size of 0
+  // stands for the whole extent. The points of a tile are visited row-major.
+  //
+  //   sndr | exec::bulk_tiled(std::array{ny, nx}, std::array{32, 256},
+  //                           [](int y, int x) { ... });
+  //
+  // bulk_tiled is a bulk over the tiles, numbered in the requested order, so
+  // it runs wherever bulk does. static_thread_pool hands each of its tasks a
+  // contiguous run of tile numbers, which with tile_order::morton is also a
+  // compact region of the index space.
+  namespace __bulk_tiled {
+    using namespace stdexec;
+
+    template <class _Index, std::size_t _Rank>
+    using __coords_t = std::array<_Index, _Rank>;
+
+    template <class _Index, std::size_t>
+    using __index_t = _Index;
+
+    template <class _Fun, class _Index, class _Indices, class... _As>
+    inline constexpr bool __callable_at = false;
+
+    template <class _Fun, class _Index, std::size_t... _Is, class... _As>
+    inline constexpr bool __callable_at<_Fun, _Index, std::index_sequence<_Is...>, _As...> =
+      __callable<_Fun&, __index_t<_Index, _Is>..., _As&...>;
+
+    template <class _Fun, class _Index, class _Indices, class... _As>
+    inline constexpr bool __nothrow_callable_at = false;
+
+    template <class _Fun, class _Index, std::size_t... _Is, class... _As>
+    inline constexpr bool __nothrow_callable_at<_Fun, _Index, std::index_sequence<_Is...>, _As...> =
+      __nothrow_callable<_Fun&, __index_t<_Index, _Is>..., _As&...>;
+
+    template <std::size_t _Rank, class _Index>
+    std::uint64_t __morton_code(const __coords_t<_Index, _Rank>& __coords) noexcept {
+      std::uint64_t __code = 0;
+      for (std::size_t __bit = 0; __bit * _Rank < 64; ++__bit) {
+        for (std::size_t __dim = 0; __dim < _Rank && __bit * _Rank + __dim < 64; ++__dim) {
+          const auto __value = static_cast<std::uint64_t>(__coords[__dim]);
+          __code |= ((__value >> __bit) & 1u) << (__bit * _Rank + (_Rank - 1 - __dim));
+        }
+      }
+      return __code;
+    }
+
+    // The coordinates of tile number __t of a row-major grid of tiles.
+    template <std::size_t _Rank, class _Index>
+    __coords_t<_Index, _Rank>
+      __row_major_tile(_Index __t, const __coords_t<_Index, _Rank>& __n_tiles) noexcept {
+      __coords_t<_Index, _Rank> __tile{};
+      for (std::size_t __dim = _Rank; __dim-- > 0;) {
+        __tile[__dim] = static_cast<_Index>(__t % __n_tiles[__dim]);
+        __t = static_cast<_Index>(__t / __n_tiles[__dim]);
+      }
+      return __tile;
+    }
+
+    template <class _Index, std::size_t _Rank, class _Fun>
+    struct __tile_fn {
+      using __coords = __coords_t<_Index, _Rank>;
+      using __indices = std::make_index_sequence<_Rank>;
+
+      __coords __extents_;
+      __coords __tile_;
+      __coords __n_tiles_;
+      // The coordinates of the tiles in Z-order, or null for row-major order.
+      std::shared_ptr<const std::vector<__coords>> __order_;
+      _Fun __fun_;
+
+      template <std::size_t _Dim, class... _As>
+      void __visit(const __coords& __begin, const __coords& __end, __coords& __at, _As&... __as) {
+        for (__at[_Dim] = __begin[_Dim]; __at[_Dim] < __end[_Dim]; ++__at[_Dim]) {
+          if constexpr (_Dim + 1 == _Rank) {
+            [&]<std::size_t... _Is>(std::index_sequence<_Is...>) {
+              __fun_(__at[_Is]..., __as...);
+            }(__indices{});
+          } else {
+            __visit<_Dim + 1>(__begin, __end, __at, __as...);
+          }
+        }
+      }
+
+      template <class... _As>
+        requires __callable_at<_Fun, _Index, __indices, _As...>
+      void operator()(_Index __t, _As&... __as) //
+        noexcept(__nothrow_callable_at<_Fun, _Index, __indices, _As...>) {
+        const __coords __tile = __order_ ? (*__order_)[static_cast<std::size_t>(__t)]
+                                         : __bulk_tiled::__row_major_tile<_Rank>(__t, __n_tiles_);
+        __coords __begin;
+        __coords __end;
+        for (std::size_t __dim = 0; __dim < _Rank; ++__dim) {
+          __begin[__dim] = static_cast<_Index>(__tile[__dim] * __tile_[__dim]);
+          __end[__dim] =
+            std::min(static_cast<_Index>(__begin[__dim] + __tile_[__dim]), __extents_[__dim]);
+        }
+        __coords __at;
+        __visit<0>(__begin, __end, __at, __as...);
+      }
+    };
+
+    struct bulk_tiled_t {
+      template <sender _Sender, integral _Index, std::size_t _Rank, __movable_value _Fun>
+      auto operator()(
+        _Sender&& __sndr,
+        std::array<_Index, _Rank> __extents,
+        std::array<_Index, _Rank> __tile,
+        _Fun __fun,
+        tile_order __order = tile_order::row_major) const {
+        static_assert(_Rank > 0, "bulk_tiled needs at least one dimension");
+        using __fn_t = __tile_fn<_Index, _Rank, _Fun>;
+        using __coords = __coords_t<_Index, _Rank>;
+        __coords __n_tiles;
+        _Index __count = 1;
+        for (std::size_t __dim = 0; __dim < _Rank; ++__dim) {
+          if (__tile[__dim] <= 0 || __tile[__dim] > __extents[__dim]) {
+            __tile[__dim] = std::max(__extents[__dim], _Index{1});
+          }
+          __n_tiles[__dim] =
+            static_cast<_Index>((__extents[__dim] + __tile[__dim] - 1) / __tile[__dim]);
+          __count = static_cast<_Index>(__count * __n_tiles[__dim]);
+        }
+        std::shared_ptr<const std::vector<__coords>> __tiles;
+        if (__order == tile_order::morton && __count > 1) {
+          auto __sorted = std::make_shared<std::vector<__coords>>();
+          __trace_allocation("bulk_tiled", static_cast<std::size_t>(__count) * sizeof(__coords));
+          __sorted->reserve(static_cast<std::size_t>(__count));
+          for (_Index __t = 0; __t < __count; ++__t) {
+            __sorted->push_back(__bulk_tiled::__row_major_tile<_Rank>(__t, __n_tiles));
+          }
+          std::stable_sort(
+            __sorted->begin(), __sorted->end(), [](const __coords& __a, const __coords& __b) {
+              return __bulk_tiled::__morton_code<_Rank>(__a)
+                   < __bulk_tiled::__morton_code<_Rank>(__b);
+            });
+          __tiles = std::move(__sorted);
+        }
+        return stdexec::bulk(
+          (_Sender&&) __sndr,
+          __count,
+          __fn_t{__extents, __tile, __n_tiles, std::move(__tiles), (_Fun&&) __fun});
+      }
+
+      template <integral _Index, std::size_t _Rank, class _Fun>
+      __binder_back<
+        bulk_tiled_t,
+        std::array<_Index, _Rank>,
+        std::array<_Index, _Rank>,
+        _Fun,
+        tile_order>
+        operator()(
+          std::array<_Index, _Rank> __extents,
+          std::array<_Index, _Rank> __tile,
+          _Fun __fun,
+          tile_order __order = tile_order::row_major) const {
+        return {{}, {}, {__extents, __tile, (_Fun&&) __fun, __order}};
+      }
+    };
+  } // namespace __bulk_tiled
+
+  using __bulk_tiled::bulk_tiled_t;
+  inline constexpr bulk_tiled_t bulk_tiled{};
+} // namespace exec
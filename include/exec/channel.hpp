@@ -0,0 +1,619 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../stdexec/execution.hpp"
+#include "../stdexec/__detail/__intrusive_queue.hpp"
+#include "sequence_senders.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace exec {
+  /////////////////////////////////////////////////////////////////////////////
+  // channel<T>
+  //
+  // A bounded multi-producer multi-consumer channel. send(value) returns a
+  // sender that completes once the value has been stored in the channel; it
+  // suspends while the channel is full. receive() returns a sequence sender
+  // that emits the values of the channel until it has been closed and
+  // drained. Every value is received by exactly one consumer. Sends and
+  // receives that find room or a value do not take a lock.
+  namespace __channel {
+    using namespace stdexec;
+
+    template <class _Ty>
+    struct __send_waiter : __immovable {
+      using __complete_fn = void(__send_waiter*, bool) noexcept;
+
+      __send_waiter* __next_ = nullptr;
+      __complete_fn* __complete_ = nullptr;
+      _Ty* __value_ = nullptr;
+      std::atomic<bool> __cancelled_{false};
+
+      // Called with true once the value has been taken by the channel and with
+      // false if the channel was closed or the send was cancelled.
+      void __complete(bool __accepted) noexcept {
+        __complete_(this, __accepted);
+      }
+    };
+
+    template <class _Ty>
+    struct __recv_waiter : __immovable {
+      using __complete_fn = void(__recv_waiter*) noexcept;
+
+      __recv_waiter* __next_ = nullptr;
+      __complete_fn* __complete_ = nullptr;
+      std::optional<_Ty> __value_{};
+      std::atomic<bool> __cancelled_{false};
+
+      // Called once __value_ has been filled or the channel has been closed.
+      void __complete() noexcept {
+        __complete_(this);
+      }
+    };
+
+    template <class _Item, _Item* _Item::*_Next>
+    bool __remove(__intrusive_queue<_Next>& __queue, _Item* __item) noexcept {
+      bool __found = false;
+      __intrusive_queue<_Next> __rest{};
+      while (!__queue.empty()) {
+        _Item* __front = __queue.pop_front();
+        if (__front == __item) {
+          __found = true;
+        } else {
+          __rest.push_back(__front);
+        }
+      }
+      __queue = std::move(__rest);
+      return __found;
+    }
+
+    // The values are stored in a bounded ring buffer in which every cell has
+    // a sequence number that tells whether it is free or holds a value for a
+    // given position, so that producers and consumers only synchronize on the
+    // cells and the two positions. The mutex only guards the queues of the
+    // operations that wait for room or for a value.
+    //
+    // A waiting operation enqueues itself, sets its bit in __flags_ and then
+    // tries again; an operation that pushed or popped a value without the
+    // lock reads __flags_ afterwards. Both are separated by a sequentially
+    // consistent fence, so at least one of them sees the other: either the
+    // waiter finds the new value or room, or the other operation finds the
+    // waiter and serves it under the lock.
+    template <class _Ty>
+    struct __state : __immovable {
+      static_assert(
+        std::is_nothrow_move_constructible_v<_Ty>,
+        "The value type of a channel must be nothrow move constructible.");
+
+      // The bits of __flags_.
+      static constexpr unsigned __closed = 1;
+      static constexpr unsigned __waiting_senders = 2;
+      static constexpr unsigned __waiting_receivers = 4;
+
+      struct __cell {
+        // __seq_ == 2 * position: free for the value at position.
+        // __seq_ == 2 * position + 1: holds the value at position.
+        // (Doubling keeps both states apart for a capacity of one.)
+        std::atomic<std::size_t> __seq_;
+        std::optional<_Ty> __value_;
+      };
+
+      using __senders_t = __intrusive_queue<&__send_waiter<_Ty>::__next_>;
+      using __receivers_t = __intrusive_queue<&__recv_waiter<_Ty>::__next_>;
+
+      explicit __state(std::size_t __capacity)
+        : __cells_(__capacity == 0 ? nullptr : new __cell[__capacity])
+        , __capacity_(__capacity) {
+        stdexec::__trace_allocation("channel", __capacity * sizeof(__cell));
+        for (std::size_t __i = 0; __i < __capacity_; ++__i) {
+          __cells_[__i].__seq_.store(2 * __i, std::memory_order_relaxed);
+        }
+      }
+
+      ~__state() {
+        std::unique_lock __guard{__mutex_};
+        STDEXEC_ASSERT(__senders_.empty());
+        STDEXEC_ASSERT(__receivers_.empty());
+      }
+
+      bool __try_push_(_Ty& __value) noexcept {
+        if (__capacity_ == 0) {
+          return false;
+        }
+        std::size_t __pos = __push_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+          __cell& __c = __cells_[__pos % __capacity_];
+          const std::size_t __seq = __c.__seq_.load(std::memory_order_acquire);
+          if (__seq == 2 * __pos) {
+            if (__push_pos_.compare_exchange_weak(__pos, __pos + 1, std::memory_order_relaxed)) {
+              __c.__value_.emplace(static_cast<_Ty&&>(__value));
+              __c.__seq_.store(2 * __pos + 1, std::memory_order_release);
+              return true;
+            }
+          } else if (static_cast<std::ptrdiff_t>(__seq - 2 * __pos) < 0) {
+            // The cell still holds the value of the previous round.
+            return false;
+          } else {
+            __pos = __push_pos_.load(std::memory_order_relaxed);
+          }
+        }
+      }
+
+      bool __try_pop_(std::optional<_Ty>& __out) noexcept {
+        if (__capacity_ == 0) {
+          return false;
+        }
+        std::size_t __pos = __pop_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+          __cell& __c = __cells_[__pos % __capacity_];
+          const std::size_t __seq = __c.__seq_.load(std::memory_order_acquire);
+          if (__seq == 2 * __pos + 1) {
+            if (__pop_pos_.compare_exchange_weak(__pos, __pos + 1, std::memory_order_relaxed)) {
+              __out.emplace(std::move(*__c.__value_));
+              __c.__value_.reset();
+              __c.__seq_.store(2 * (__pos + __capacity_), std::memory_order_release);
+              return true;
+            }
+          } else if (static_cast<std::ptrdiff_t>(__seq - (2 * __pos + 1)) < 0) {
+            // The value has not been pushed (completely) yet.
+            return false;
+          } else {
+            __pos = __pop_pos_.load(std::memory_order_relaxed);
+          }
+        }
+      }
+
+      // Serves the waiters after a value was pushed or popped without the lock,
+      // if any of the given kind have been enqueued.
+      void __notify_(unsigned __waiting) noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (__flags_.load(std::memory_order_relaxed) & __waiting) {
+          std::unique_lock __guard{__mutex_};
+          __settle_(__guard);
+        }
+      }
+
+      // Enqueues a waiter and sets its bit in __flags_ before the waiter tries
+      // again in __settle_. Must be called with the mutex held.
+      template <class _Queue, class _Waiter>
+      void __enqueue_(_Queue& __queue, _Waiter* __waiter, unsigned __waiting) noexcept {
+        __queue.push_back(__waiter);
+        __flags_.fetch_or(__waiting, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+      }
+
+      // Moves the values of waiting producers into the buffer and the values
+      // of the buffer to waiting consumers for as long as that is possible,
+      // then releases the lock and completes the operations that were served.
+      // Returns true if __self was served; it is not completed.
+      bool __settle_(
+        std::unique_lock<std::mutex>& __guard,
+        __recv_waiter<_Ty>* __self = nullptr) noexcept {
+        __senders_t __rejected{};
+        __senders_t __accepted{};
+        __receivers_t __served{};
+        const bool __is_closed = __flags_.load(std::memory_order_relaxed) & __closed;
+        if (__is_closed) {
+          __rejected = std::move(__senders_);
+        }
+        for (bool __progress = true; __progress;) {
+          __progress = false;
+          while (!__senders_.empty()) {
+            __send_waiter<_Ty>* __sender = __senders_.pop_front();
+            if (!__try_push_(*__sender->__value_)) {
+              __senders_.push_front(__sender);
+              break;
+            }
+            __accepted.push_back(__sender);
+            __progress = true;
+          }
+          while (!__receivers_.empty()) {
+            __recv_waiter<_Ty>* __receiver = __receivers_.pop_front();
+            if (!__try_pop_(__receiver->__value_)) {
+              __receivers_.push_front(__receiver);
+              break;
+            }
+            __served.push_back(__receiver);
+            __progress = true;
+          }
+          // An unbuffered channel hands values over directly.
+          while (__capacity_ == 0 && !__senders_.empty() && !__receivers_.empty()) {
+            __send_waiter<_Ty>* __sender = __senders_.pop_front();
+            __recv_waiter<_Ty>* __receiver = __receivers_.pop_front();
+            __receiver->__value_.emplace(std::move(*__sender->__value_));
+            __accepted.push_back(__sender);
+            __served.push_back(__receiver);
+          }
+        }
+        if (__is_closed) {
+          // The buffer is empty, so the remaining consumers are done.
+          __served.append(std::move(__receivers_));
+        }
+        unsigned __idle = 0;
+        if (__senders_.empty()) {
+          __idle |= __waiting_senders;
+        }
+        if (__receivers_.empty()) {
+          __idle |= __waiting_receivers;
+        }
+        __flags_.fetch_and(~__idle, std::memory_order_relaxed);
+        __guard.unlock();
+
+        while (!__rejected.empty()) {
+          __rejected.pop_front()->__complete(false);
+        }
+        while (!__accepted.empty()) {
+          __accepted.pop_front()->__complete(true);
+        }
+        bool __self_served = false;
+        while (!__served.empty()) {
+          __recv_waiter<_Ty>* __receiver = __served.pop_front();
+          if (__receiver == __self) {
+            __self_served = true;
+          } else {
+            __receiver->__complete();
+          }
+        }
+        return __self_served;
+      }
+
+      void __send(__send_waiter<_Ty>* __sender) noexcept {
+        if (
+          !(__flags_.load(std::memory_order_acquire) & __closed)
+          && !__sender->__cancelled_.load(std::memory_order_relaxed)
+          && __try_push_(*__sender->__value_)) {
+          __notify_(__waiting_receivers);
+          __sender->__complete(true);
+          return;
+        }
+        std::unique_lock __guard{__mutex_};
+        if (
+          (__flags_.load(std::memory_order_relaxed) & __closed)
+          || __sender->__cancelled_.load(std::memory_order_relaxed)) {
+          __guard.unlock();
+          __sender->__complete(false);
+          return;
+        }
+        __enqueue_(__senders_, __sender, __waiting_senders);
+        __settle_(__guard);
+      }
+
+      // Fills the value of the receiver and returns true if a value is
+      // available or the channel is closed. Otherwise, the receiver is
+      // enqueued and completed once either is the case.
+      bool __try_receive(__recv_waiter<_Ty>* __receiver) noexcept {
+        if (__receiver->__cancelled_.load(std::memory_order_relaxed)) {
+          return true;
+        }
+        if (__try_pop_(__receiver->__value_)) {
+          __notify_(__waiting_senders);
+          return true;
+        }
+        std::unique_lock __guard{__mutex_};
+        if (__receiver->__cancelled_.load(std::memory_order_relaxed)) {
+          return true;
+        }
+        __enqueue_(__receivers_, __receiver, __waiting_receivers);
+        return __settle_(__guard, __receiver);
+      }
+
+      bool __cancel_send(__send_waiter<_Ty>* __sender) noexcept {
+        std::unique_lock __guard{__mutex_};
+        __sender->__cancelled_.store(true, std::memory_order_relaxed);
+        return __channel::__remove(__senders_, __sender);
+      }
+
+      bool __cancel_receive(__recv_waiter<_Ty>* __receiver) noexcept {
+        std::unique_lock __guard{__mutex_};
+        __receiver->__cancelled_.store(true, std::memory_order_relaxed);
+        return __channel::__remove(__receivers_, __receiver);
+      }
+
+      void __close() noexcept {
+        std::unique_lock __guard{__mutex_};
+        __flags_.fetch_or(__closed, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        __settle_(__guard);
+      }
+
+      std::unique_ptr<__cell[]> __cells_;
+      std::size_t __capacity_;
+      alignas(64) std::atomic<std::size_t> __push_pos_{0};
+      alignas(64) std::atomic<std::size_t> __pop_pos_{0};
+      alignas(64) std::atomic<unsigned> __flags_{0};
+      std::mutex __mutex_{};
+      __senders_t __senders_{};
+      __receivers_t __receivers_{};
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // channel::send implementation
+    template <class _Ty, class _ReceiverId>
+    struct __send_operation {
+      using _Receiver = stdexec::__t<_ReceiverId>;
+
+      struct __t : __send_waiter<_Ty> {
+        using __id = __send_operation;
+
+        struct __on_stop {
+          __t* __op_;
+
+          void operator()() const noexcept {
+            if (__op_->__chan_->__cancel_send(__op_)) {
+              __op_->__complete(false);
+            }
+          }
+        };
+
+        using __on_stop_t =
+          typename stop_token_of_t<env_of_t<_Receiver>&>::template callback_type<__on_stop>;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _Receiver __rcvr_;
+        __state<_Ty>* __chan_;
+        _Ty __val_;
+        std::optional<__on_stop_t> __on_stop_{};
+
+        __t(_Receiver __rcvr, __state<_Ty>* __chan, _Ty __val)
+          : __send_waiter<_Ty>{{}, nullptr, &__completed, &__val_}
+          , __rcvr_(static_cast<_Receiver&&>(__rcvr))
+          , __chan_(__chan)
+          , __val_(static_cast<_Ty&&>(__val)) {
+        }
+
+        static void __completed(__send_waiter<_Ty>* __base, bool __accepted) noexcept {
+          __t* __self = static_cast<__t*>(__base);
+          __self->__on_stop_.reset();
+          if (__accepted) {
+            stdexec::set_value(static_cast<_Receiver&&>(__self->__rcvr_));
+          } else {
+            stdexec::set_stopped(static_cast<_Receiver&&>(__self->__rcvr_));
+          }
+        }
+
+        friend void tag_invoke(start_t, __t& __self) noexcept {
+          __self.__on_stop_.emplace(
+            stdexec::get_stop_token(stdexec::get_env(__self.__rcvr_)), __on_stop{&__self});
+          __self.__chan_->__send(&__self);
+        }
+      };
+    };
+
+    template <class _Ty>
+    struct __send_sender {
+      struct __t {
+        using __id = __send_sender;
+        using is_sender = void;
+        using completion_signatures =
+          stdexec::completion_signatures<set_value_t(), set_stopped_t()>;
+
+        __state<_Ty>* __chan_;
+        _Ty __val_;
+
+        template <__decays_to<__t> _Self, receiver_of<completion_signatures> _Receiver>
+        friend auto tag_invoke(connect_t, _Self&& __self, _Receiver __rcvr)
+          -> stdexec::__t<__send_operation<_Ty, stdexec::__id<_Receiver>>> {
+          return {static_cast<_Receiver&&>(__rcvr), __self.__chan_, static_cast<_Self&&>(__self).__val_};
+        }
+
+        friend empty_env tag_invoke(get_env_t, const __t&) noexcept {
+          return {};
+        }
+      };
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // channel::receive implementation
+    template <class _Op>
+    struct __next_receiver {
+      struct __t {
+        using __id = __next_receiver;
+        using is_receiver = void;
+        _Op* __op_;
+
+        template <same_as<set_value_t> _SetValue, same_as<__t> _Self>
+        friend void tag_invoke(_SetValue, _Self&& __self) noexcept {
+          __self.__op_->__delivered(false);
+        }
+
+        template <same_as<set_stopped_t> _SetStopped, same_as<__t> _Self>
+        friend void tag_invoke(_SetStopped, _Self&& __self) noexcept {
+          __self.__op_->__delivered(true);
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend auto tag_invoke(_GetEnv, const _Self& __self) noexcept
+          -> env_of_t<typename _Op::__receiver_type> {
+          return stdexec::get_env(__self.__op_->__rcvr_);
+        }
+      };
+    };
+
+    template <class _Ty>
+    using __item_sender_t = __call_result_t<decltype(just), _Ty>;
+
+    template <class _Ty, class _ReceiverId>
+    struct __receive_operation {
+      using _Receiver = stdexec::__t<_ReceiverId>;
+
+      struct __t : __recv_waiter<_Ty> {
+        using __id = __receive_operation;
+        using __receiver_type = _Receiver;
+        using __next_receiver_t = stdexec::__t<__next_receiver<__t>>;
+
+        struct __on_stop {
+          __t* __op_;
+
+          void operator()() const noexcept {
+            if (__op_->__chan_->__cancel_receive(__op_)) {
+              __op_->__complete();
+            }
+          }
+        };
+
+        using __on_stop_t =
+          typename stop_token_of_t<env_of_t<_Receiver>&>::template callback_type<__on_stop>;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _Receiver __rcvr_;
+        __state<_Ty>* __chan_;
+        std::optional<__on_stop_t> __on_stop_{};
+        bool __stopped_{false};
+        // 0: idle, 1: starting a delivery, 2: the delivery has completed
+        std::atomic<int> __delivery_{0};
+        std::optional<connect_result_t<__next_sender_of_t<_Receiver, __item_sender_t<_Ty>>, __next_receiver_t>>
+          __next_op_{};
+
+        __t(_Receiver __rcvr, __state<_Ty>* __chan)
+          : __recv_waiter<_Ty>{{}, nullptr, &__received}
+          , __rcvr_(static_cast<_Receiver&&>(__rcvr))
+          , __chan_(__chan) {
+        }
+
+        static void __received(__recv_waiter<_Ty>* __base) noexcept {
+          __t* __self = static_cast<__t*>(__base);
+          if (__self->__deliver()) {
+            __self->__pump();
+          }
+        }
+
+        // Receives values until one of them completes asynchronously.
+        void __pump() noexcept {
+          while (__chan_->__try_receive(this)) {
+            if (!__deliver()) {
+              return;
+            }
+          }
+        }
+
+        // Returns true if the value was delivered synchronously and the next
+        // value can be received.
+        bool __deliver() noexcept {
+          if (!this->__value_ || __stopped_) {
+            __finish();
+            return false;
+          }
+          __delivery_.store(1, std::memory_order_relaxed);
+          try {
+            auto& __op = __next_op_.emplace(__conv{[&] {
+              return stdexec::connect(
+                exec::set_next(__rcvr_, just(std::move(*this->__value_))), __next_receiver_t{this});
+            }});
+            this->__value_.reset();
+            stdexec::start(__op);
+          } catch (...) {
+            this->__value_.reset();
+            __stopped_ = true;
+            __finish();
+            return false;
+          }
+          if (__delivery_.exchange(0, std::memory_order_acq_rel) != 2) {
+            // The delivery completes on another thread, which resumes receiving.
+            return false;
+          }
+          if (__stopped_) {
+            __finish();
+            return false;
+          }
+          return true;
+        }
+
+        void __delivered(bool __stop) noexcept {
+          __stopped_ = __stop;
+          if (__delivery_.exchange(2, std::memory_order_acq_rel) == 0) {
+            if (__stopped_) {
+              __finish();
+            } else {
+              __pump();
+            }
+          }
+        }
+
+        void __finish() noexcept {
+          __on_stop_.reset();
+          if (this->__cancelled_.load(std::memory_order_relaxed)) {
+            stdexec::set_stopped(static_cast<_Receiver&&>(__rcvr_));
+          } else {
+            stdexec::set_value(static_cast<_Receiver&&>(__rcvr_));
+          }
+        }
+
+        friend void tag_invoke(start_t, __t& __self) noexcept {
+          __self.__on_stop_.emplace(
+            stdexec::get_stop_token(stdexec::get_env(__self.__rcvr_)), __on_stop{&__self});
+          __self.__pump();
+        }
+      };
+    };
+
+    template <class _Ty>
+    struct __receive_sender {
+      struct __t {
+        using __id = __receive_sender;
+        using is_sender = sequence_tag;
+        using completion_signatures =
+          stdexec::completion_signatures<set_value_t(_Ty), set_stopped_t()>;
+
+        __state<_Ty>* __chan_;
+
+        template <__decays_to<__t> _Self, receiver _Receiver>
+          requires sequence_receiver_of<_Receiver, completion_signatures>
+                && receiver_of<_Receiver, stdexec::completion_signatures<set_value_t(), set_stopped_t()>>
+        friend auto tag_invoke(subscribe_t, _Self&& __self, _Receiver __rcvr)
+          -> stdexec::__t<__receive_operation<_Ty, stdexec::__id<_Receiver>>> {
+          return {static_cast<_Receiver&&>(__rcvr), __self.__chan_};
+        }
+
+        friend empty_env tag_invoke(get_env_t, const __t&) noexcept {
+          return {};
+        }
+      };
+    };
+
+    template <class _Ty>
+    class channel : __immovable {
+     public:
+      using value_type = _Ty;
+
+      // A channel with a capacity of zero hands every value directly from a
+      // producer to a consumer.
+      explicit channel(std::size_t __capacity)
+        : __state_(__capacity) {
+      }
+
+      [[nodiscard]] auto send(_Ty __value) -> stdexec::__t<__send_sender<_Ty>> {
+        return {&__state_, static_cast<_Ty&&>(__value)};
+      }
+
+      [[nodiscard]] auto receive() -> stdexec::__t<__receive_sender<_Ty>> {
+        return {&__state_};
+      }
+
+      // Pending and future sends complete with set_stopped. Consumers complete
+      // once they have received the values that are left in the channel.
+      void close() noexcept {
+        __state_.__close();
+      }
+
+     private:
+      __state<_Ty> __state_;
+    };
+  } // namespace __channel
+
+  using __channel::channel;
+} // namespace exec
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../stdexec/execution.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace exec {
+  /////////////////////////////////////////////////////////////////////////////
+  // ensure_started_into: like stdexec::ensure_started, but the shared state of
+  // the eagerly started operation lives in caller-provided storage instead of
+  // on the heap.
+  namespace __eager {
+    using namespace stdexec;
+
+    template <class _Ty>
+    class __storage_ptr;
+
+    // The shared state and its reference count, as they are laid out in an
+    // eager_storage. Once the last reference is dropped, the storage can be
+    // reused.
+    template <class _Ty>
+    struct __control_block {
+      alignas(_Ty) unsigned char __value_[sizeof(_Ty)];
+      std::atomic<unsigned long> __refcount_{0};
+      std::atomic<bool> __engaged_{false};
+
+      __control_block() = default;
+      STDEXEC_IMMOVABLE(__control_block);
+
+      _Ty& __value() noexcept {
+        return *std::launder(reinterpret_cast<_Ty*>(__value_));
+      }
+
+      template <class... _Us>
+      __storage_ptr<_Ty> __construct(_Us&&... __us) {
+        // Initialize the count before the value, whose constructor takes
+        // references with __intrusive_from_this():
+        __refcount_.store(1u, std::memory_order_relaxed);
+        __engaged_.store(true, std::memory_order_relaxed);
+        try {
+          ::new ((void*) __value_) _Ty((_Us&&) __us...);
+        } catch (...) {
+          __engaged_.store(false, std::memory_order_relaxed);
+          throw;
+        }
+        return __storage_ptr<_Ty>{this};
+      }
+
+      void __addref() noexcept {
+        __refcount_.fetch_add(1u, std::memory_order_relaxed);
+      }
+
+      void __release() noexcept {
+        if (1u == __refcount_.fetch_sub(1u, std::memory_order_acq_rel)) {
+          __value().~_Ty();
+          __engaged_.store(false, std::memory_order_release);
+        }
+      }
+    };
+
+    // Like __intrusive_ptr, but the value is not deleted when the last
+    // reference goes away; its storage is handed back to the eager_storage.
+    template <class _Ty>
+    class __storage_ptr {
+      __control_block<_Ty>* __block_{nullptr};
+
+     public:
+      __storage_ptr() = default;
+
+      explicit __storage_ptr(__control_block<_Ty>* __block) noexcept
+        : __block_(__block) {
+      }
+
+      __storage_ptr(__storage_ptr&& __that) noexcept
+        : __block_(std::exchange(__that.__block_, nullptr)) {
+      }
+
+      __storage_ptr(const __storage_ptr& __that) noexcept
+        : __block_(__that.__block_) {
+        if (__block_) {
+          __block_->__addref();
+        }
+      }
+
+      __storage_ptr& operator=(__storage_ptr __that) noexcept {
+        std::swap(__block_, __that.__block_);
+        return *this;
+      }
+
+      ~__storage_ptr() {
+        if (__block_) {
+          __block_->__release();
+        }
+      }
+
+      void reset() noexcept {
+        operator=({});
+      }
+
+      _Ty* get() const noexcept {
+        return &__block_->__value();
+      }
+
+      _Ty* operator->() const noexcept {
+        return &__block_->__value();
+      }
+
+      _Ty& operator*() const noexcept {
+        return __block_->__value();
+      }
+
+      bool operator==(std::nullptr_t) const noexcept {
+        return __block_ == nullptr;
+      }
+    };
+
+    template <class _Ty>
+    struct __enable_from_this {
+      __storage_ptr<_Ty> __intrusive_from_this() noexcept {
+        static_assert(0 == offsetof(__control_block<_Ty>, __value_));
+        auto* __block = reinterpret_cast<__control_block<_Ty>*>(static_cast<_Ty*>(this));
+        __block->__addref();
+        return __storage_ptr<_Ty>{__block};
+      }
+    };
+
+    // The storage policy of stdexec::ensure_started's shared state.
+    struct __caller_storage {
+      template <class _Ty>
+      using __pointer_t = __storage_ptr<_Ty>;
+
+      template <class _Ty>
+      using __enable_from_this_t = __enable_from_this<_Ty>;
+    };
+
+    template <class _Sender, class _Env>
+    using __sh_state_t = __ensure_started::
+      __sh_state_t<__cvref_id<_Sender>, stdexec::__id<_Env>, __caller_storage>;
+
+    struct ensure_started_into_t;
+  } // namespace __eager
+
+  // The number of bytes needed to hold the eagerly started operation of a
+  // sender of type _Sender started with the environment _Env.
+  template <class _Sender, class _Env = stdexec::empty_env>
+  inline constexpr std::size_t eager_state_size_v = sizeof(__eager::__sh_state_t<_Sender, _Env>);
+
+  // Caller-owned storage for the shared state of ensure_started_into. The
+  // storage can be reused once the previous operation has completed and its
+  // sender (or the operation it was connected to) has been destroyed. It must
+  // outlive both.
+  template <class _Sender, class _Env = stdexec::empty_env>
+  class eager_storage {
+    friend struct __eager::ensure_started_into_t;
+
+    __eager::__control_block<__eager::__sh_state_t<_Sender, _Env>> __block_{};
+
+   public:
+    static constexpr std::size_t size = eager_state_size_v<_Sender, _Env>;
+
+    eager_storage() = default;
+    STDEXEC_IMMOVABLE(eager_storage);
+
+    ~eager_storage() {
+      STDEXEC_ASSERT(!in_use());
+    }
+
+    bool in_use() const noexcept {
+      return __block_.__engaged_.load(std::memory_order_acquire);
+    }
+  };
+
+  namespace __eager {
+    struct ensure_started_into_t {
+      template <sender _Sender, class _Env>
+        requires sender_in<_Sender, __ensure_started::__env_t<_Env>> && move_constructible<_Sender>
+      auto operator()(_Sender __sndr, eager_storage<_Sender, _Env>& __storage, _Env __env) const {
+        STDEXEC_ASSERT(!__storage.in_use());
+        using __state_t = __sh_state_t<_Sender, _Env>;
+        return make_sender_expr<__ensure_started::__ensure_started_t>(
+          __ensure_started::__data<__state_t>{
+            __storage.__block_.__construct((_Sender&&) __sndr, (_Env&&) __env)});
+      }
+
+      template <sender _Sender>
+        requires sender_in<_Sender, __ensure_started::__env_t<empty_env>>
+              && move_constructible<_Sender>
+      auto operator()(_Sender __sndr, eager_storage<_Sender, empty_env>& __storage) const {
+        return (*this)((_Sender&&) __sndr, __storage, empty_env{});
+      }
+
+      template <class _Sender, class _Env>
+      __binder_back<ensure_started_into_t, eager_storage<_Sender, _Env>&>
+        operator()(eager_storage<_Sender, _Env>& __storage) const {
+        return {{}, {}, {__storage}};
+      }
+
+      template <class _Sender, class _Env>
+      __binder_back<ensure_started_into_t, eager_storage<_Sender, _Env>&, _Env>
+        operator()(eager_storage<_Sender, _Env>& __storage, _Env __env) const {
+        return {{}, {}, {__storage, (_Env&&) __env}};
+      }
+    };
+  } // namespace __eager
+
+  using __eager::ensure_started_into_t;
+  inline constexpr ensure_started_into_t ensure_started_into{};
+} // namespace exec
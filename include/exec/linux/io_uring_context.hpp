@@ -27,6 +27,7 @@
 #include "../__detail/__atomic_intrusive_queue.hpp"
 #include "../__detail/__atomic_ref.hpp"
 #include "../__detail/__bit_cast.hpp"
+#include "../__detail/__scheduler_tracing.hpp"
 
 #include "./safe_file_descriptor.hpp"
 #include "./memory_mapped_region.hpp"
@@ -142,7 +143,9 @@ namespace exec {
 
     // This is the base class for all io operations.
     // It provides the vtable and the next pointer for the intrusive queues.
-    struct __task : stdexec::__immovable {
+    struct __task
+      : stdexec::__immovable
+      , __tracing::__traced_task {
       const __task_vtable* __vtable_;
       __task* __next_{nullptr};
 
@@ -273,7 +276,10 @@ namespace exec {
           const __u32 __index = __head & __mask_;
           const ::io_uring_cqe& __cqe = __entries_[__index];
           __task* __op = bit_cast<__task*>(__cqe.user_data);
-          __op->__vtable_->__complete_(__op, __cqe);
+          {
+            __tracing::__task_scope __scope{"io_uring_context", *__op};
+            __op->__vtable_->__complete_(__op, __cqe);
+          }
           ++__head;
           ++__count;
           __tail = __tail_.load(std::memory_order_acquire);
@@ -282,6 +288,7 @@ namespace exec {
         while (!__ready.empty()) {
           __task* __op = __ready.pop_front();
           ::io_uring_cqe __dummy_cqe{.user_data = bit_cast<__u64>(__op)};
+          __tracing::__task_scope __scope{"io_uring_context", *__op};
           __op->__vtable_->__complete_(__op, __dummy_cqe);
         }
         return __count;
@@ -406,6 +413,7 @@ namespace exec {
           __stop(__op);
           return false;
         } else {
+          __op->__mark_enqueued();
           __requests_.push_front(__op);
           [[maybe_unused]] int __prev = __n_submissions_in_flight_.fetch_sub(
             1, std::memory_order_relaxed);
@@ -0,0 +1,626 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../stdexec/execution.hpp"
+#include "./__detail/__manual_lifetime.hpp"
+#include "./bulk_chunked.hpp"
+#include "./static_thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace exec {
+  //////////////////////////////////////////////////////////////////////////////////////////////////
+  // multi_pool_context
+  //
+  // A set of static_thread_pools, by default one per NUMA node with its threads bound to the CPUs
+  // of the node. Work that is scheduled on the context runs on one of the pools, chosen
+  // round-robin. A bulk is split across all the pools in proportion to their number of threads,
+  // and completes when every part has. Since each pool runs a contiguous range of the shape, data
+  // that is partitioned the same way stays local to the node that first touched it.
+  class multi_pool_context {
+    template <class SenderId, std::integral Shape, class FunId>
+    struct bulk_sender;
+
+    template <stdexec::sender Sender, std::integral Shape, class Fun>
+    using bulk_sender_t = //
+      bulk_sender<
+        stdexec::__x<stdexec::__decay_t<Sender>>,
+        Shape,
+        stdexec::__x<stdexec::__decay_t<Fun>>>;
+
+    template <class SenderId, class ReceiverId, class Shape, class Fun>
+    struct bulk_op_state;
+
+    struct transform_bulk {
+      template <class Data, class Sender>
+      auto operator()(stdexec::bulk_t, Data&& data, Sender&& sndr) {
+        auto [shape, fun] = (Data&&) data;
+        return bulk_sender_t<Sender, decltype(shape), decltype(fun)>{
+          context_, (Sender&&) sndr, shape, std::move(fun)};
+      }
+
+      multi_pool_context& context_;
+    };
+
+    struct domain {
+      // For eager customization
+      template <stdexec::sender_expr_for<stdexec::bulk_t> Sender>
+      auto transform_sender(Sender&& sndr) const noexcept {
+        auto sched = stdexec::get_completion_scheduler<stdexec::set_value_t>(
+          stdexec::get_env(sndr));
+        return stdexec::apply_sender((Sender&&) sndr, transform_bulk{*sched.context_});
+      }
+
+      // transform the generic bulk sender into a bulk sender that is split across the pools
+      template <stdexec::sender_expr_for<stdexec::bulk_t> Sender, class Env>
+        requires stdexec::__callable<stdexec::get_scheduler_t, Env>
+      auto transform_sender(Sender&& sndr, const Env& env) const noexcept {
+        auto sched = stdexec::get_scheduler(env);
+        return stdexec::apply_sender((Sender&&) sndr, transform_bulk{*sched.context_});
+      }
+    };
+
+    using pool_sender_t = stdexec::schedule_result_t<static_thread_pool::scheduler>;
+
+   public:
+    // One pool per NUMA node; see numa_cpu_sets. Where no CPU sets can be determined, a single
+    // pool with a thread per hardware thread.
+    multi_pool_context()
+      : multi_pool_context(numa_cpu_sets()) {
+    }
+
+    // One pool per set of CPUs, with a thread per CPU. The threads of a pool are bound to its
+    // CPUs where the platform supports it. An empty set stands for one unbound thread, and no
+    // sets at all for a single unbound pool with a thread per hardware thread.
+    explicit multi_pool_context(std::vector<std::vector<int>> cpu_sets) {
+      if (cpu_sets.empty()) {
+        pools_.push_back(std::make_unique<static_thread_pool>(default_thread_count()));
+        return;
+      }
+      pools_.reserve(cpu_sets.size());
+      for (const std::vector<int>& cpus: cpu_sets) {
+        const auto n_threads = static_cast<std::uint32_t>(std::max<std::size_t>(cpus.size(), 1));
+        pools_.push_back(std::make_unique<static_thread_pool>(n_threads));
+        bind_threads(*pools_.back(), cpus);
+      }
+    }
+
+    // One pool per entry, with that many threads, which are not bound to any CPU.
+    explicit multi_pool_context(std::vector<std::uint32_t> thread_counts) {
+      if (thread_counts.empty()) {
+        thread_counts.push_back(default_thread_count());
+      }
+      pools_.reserve(thread_counts.size());
+      for (std::uint32_t n_threads: thread_counts) {
+        pools_.push_back(std::make_unique<static_thread_pool>(n_threads));
+      }
+    }
+
+    multi_pool_context(multi_pool_context&&) = delete;
+
+    // The CPUs of each NUMA node that this process may run on, in node order. Nodes without such
+    // CPUs are left out. Where the topology cannot be determined, this is a single set of all the
+    // CPUs of the process, or an empty list if those cannot be determined either.
+    static std::vector<std::vector<int>> numa_cpu_sets();
+
+    struct scheduler {
+      using __t = scheduler;
+      using __id = scheduler;
+      bool operator==(const scheduler&) const = default;
+
+     private:
+      class sender {
+       public:
+        using __t = sender;
+        using __id = sender;
+        using is_sender = void;
+        using completion_signatures =
+          stdexec::completion_signatures< stdexec::set_value_t(), stdexec::set_stopped_t()>;
+
+       private:
+        template <stdexec::receiver Receiver>
+        friend auto tag_invoke(stdexec::connect_t, sender s, Receiver r)
+          -> stdexec::connect_result_t<pool_sender_t, Receiver> {
+          return stdexec::connect(s.make_pool_sender_(), (Receiver&&) r);
+        }
+
+        pool_sender_t make_pool_sender_() const {
+          return stdexec::schedule(context_->next_pool().get_scheduler());
+        }
+
+        struct env {
+          multi_pool_context* context_;
+
+          template <class CPO>
+          friend multi_pool_context::scheduler
+            tag_invoke(stdexec::get_completion_scheduler_t<CPO>, const env& self) noexcept {
+            return self.make_scheduler_();
+          }
+
+          multi_pool_context::scheduler make_scheduler_() const {
+            return multi_pool_context::scheduler{*context_};
+          }
+        };
+
+        friend env tag_invoke(stdexec::get_env_t, const sender& self) noexcept {
+          return env{self.context_};
+        }
+
+        friend struct multi_pool_context::scheduler;
+
+        explicit sender(multi_pool_context& context) noexcept
+          : context_(&context) {
+        }
+
+        multi_pool_context* context_;
+      };
+
+      sender make_sender_() const {
+        return sender{*context_};
+      }
+
+      friend sender tag_invoke(stdexec::schedule_t, const scheduler& s) noexcept {
+        return s.make_sender_();
+      }
+
+      friend stdexec::forward_progress_guarantee
+        tag_invoke(stdexec::get_forward_progress_guarantee_t, const scheduler&) noexcept {
+        return stdexec::forward_progress_guarantee::parallel;
+      }
+
+      friend domain tag_invoke(stdexec::get_domain_t, scheduler) noexcept {
+        return {};
+      }
+
+      friend class multi_pool_context;
+
+      explicit scheduler(multi_pool_context& context) noexcept
+        : context_(&context) {
+      }
+
+      multi_pool_context* context_;
+    };
+
+    scheduler get_scheduler() noexcept {
+      return scheduler{*this};
+    }
+
+    std::size_t pool_count() const noexcept {
+      return pools_.size();
+    }
+
+    static_thread_pool& get_pool(std::size_t index) noexcept {
+      return *pools_[index];
+    }
+
+    // The total number of threads of the pools.
+    std::uint32_t available_parallelism() const noexcept {
+      std::uint32_t n_threads = 0;
+      for (const auto& pool: pools_) {
+        n_threads += pool->available_parallelism();
+      }
+      return n_threads;
+    }
+
+    void request_stop() noexcept {
+      for (const auto& pool: pools_) {
+        pool->request_stop();
+      }
+    }
+
+   private:
+    static_thread_pool& next_pool() noexcept {
+      return *pools_[next_pool_.fetch_add(1, std::memory_order_relaxed) % pools_.size()];
+    }
+
+    // The part of a shape that the pool with the given index runs: [begin, end).
+    template <class Shape>
+    std::pair<Shape, Shape> share(Shape shape, std::size_t index) const noexcept {
+      const Shape total = static_cast<Shape>(available_parallelism());
+      Shape before = 0;
+      for (std::size_t i = 0; i < index; ++i) {
+        before += static_cast<Shape>(pools_[i]->available_parallelism());
+      }
+      const Shape upto = before + static_cast<Shape>(pools_[index]->available_parallelism());
+      // The shape is divided per thread, with the remainder going to the first threads.
+      const Shape per_thread = shape / total;
+      const Shape remainder = shape % total;
+      return {
+        per_thread * before + std::min(before, remainder),
+        per_thread * upto + std::min(upto, remainder)};
+    }
+
+    static std::uint32_t default_thread_count() noexcept {
+      return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    static void bind_threads(static_thread_pool& pool, const std::vector<int>& cpus) noexcept;
+
+    std::vector<std::unique_ptr<static_thread_pool>> pools_;
+    std::atomic<std::size_t> next_pool_{0};
+  };
+
+#if defined(__linux__)
+  namespace __numa {
+    // Parses a CPU list such as "0-3,8,10-11".
+    inline std::vector<int> parse_cpu_list(const std::string& list) {
+      std::vector<int> cpus;
+      std::size_t pos = 0;
+      while (pos < list.size()) {
+        std::size_t end = list.find(',', pos);
+        if (end == std::string::npos) {
+          end = list.size();
+        }
+        const std::string range = list.substr(pos, end - pos);
+        const std::size_t dash = range.find('-');
+        try {
+          const int first = std::stoi(range.substr(0, dash));
+          const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+          for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+          }
+        } catch (...) {
+          // Not a number, e.g. the trailing newline.
+        }
+        pos = end + 1;
+      }
+      return cpus;
+    }
+
+    inline std::vector<int> read_cpu_list(const std::string& path) {
+      std::ifstream file(path);
+      std::string list;
+      std::getline(file, list);
+      return parse_cpu_list(list);
+    }
+  } // namespace __numa
+
+  inline std::vector<std::vector<int>> multi_pool_context::numa_cpu_sets() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+      return {};
+    }
+    auto usable = [&](const std::vector<int>& cpus) {
+      std::vector<int> result;
+      for (int cpu: cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+          result.push_back(cpu);
+        }
+      }
+      return result;
+    };
+
+    std::vector<std::vector<int>> cpu_sets;
+    for (int node: __numa::read_cpu_list("/sys/devices/system/node/online")) {
+      std::vector<int> cpus = usable(__numa::read_cpu_list(
+        "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+      if (!cpus.empty()) {
+        cpu_sets.push_back(std::move(cpus));
+      }
+    }
+    if (cpu_sets.empty()) {
+      std::vector<int> all;
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) {
+          all.push_back(cpu);
+        }
+      }
+      cpu_sets.push_back(std::move(all));
+    }
+    return cpu_sets;
+  }
+
+  inline void multi_pool_context::bind_threads(
+    static_thread_pool& pool,
+    const std::vector<int>& cpus) noexcept {
+    if (cpus.empty()) {
+      return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu: cpus) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &set);
+      }
+    }
+    // Binding is a hint for locality; a thread that cannot be bound still runs its tasks.
+    for (std::thread& thread: pool.threads_) {
+      ::pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+    }
+  }
+#else
+  inline std::vector<std::vector<int>> multi_pool_context::numa_cpu_sets() {
+    return {};
+  }
+
+  inline void
+    multi_pool_context::bind_threads(static_thread_pool&, const std::vector<int>&) noexcept {
+  }
+#endif
+
+  template <class SenderId, std::integral Shape, class FunId>
+  struct multi_pool_context::bulk_sender {
+    using Sender = stdexec::__t<SenderId>;
+    using Fun = stdexec::__t<FunId>;
+    using is_sender = void;
+
+    multi_pool_context& context_;
+    Sender sndr_;
+    Shape shape_;
+    Fun fun_;
+
+    template <class... Tys>
+    using set_value_t =
+      stdexec::completion_signatures< stdexec::set_value_t(stdexec::__decay_t<Tys>...)>;
+
+    // The parts complete with an error if the function throws and with stopped if their pool
+    // has been stopped.
+    template <class Self, class Env>
+    using completion_signatures = //
+      stdexec::__try_make_completion_signatures<
+        stdexec::__copy_cvref_t<Self, Sender>,
+        Env,
+        stdexec::completion_signatures<
+          stdexec::set_error_t(std::exception_ptr),
+          stdexec::set_stopped_t()>,
+        stdexec::__q<set_value_t>>;
+
+    template <class Self, class Receiver>
+    using bulk_op_state_t = //
+      bulk_op_state<
+        stdexec::__x<stdexec::__copy_cvref_t<Self, Sender>>,
+        stdexec::__x<stdexec::__decay_t<Receiver>>,
+        Shape,
+        Fun>;
+
+    template <stdexec::__decays_to<bulk_sender> Self, stdexec::receiver Receiver>
+      requires stdexec::
+        receiver_of<Receiver, completion_signatures<Self, stdexec::env_of_t<Receiver>>>
+      friend bulk_op_state_t<Self, Receiver>                       //
+      tag_invoke(stdexec::connect_t, Self&& self, Receiver&& rcvr) //
+      noexcept(stdexec::__nothrow_constructible_from<
+               bulk_op_state_t<Self, Receiver>,
+               multi_pool_context&,
+               Shape,
+               Fun,
+               Sender,
+               Receiver>) {
+      return bulk_op_state_t<Self, Receiver>{
+        self.context_, self.shape_, self.fun_, ((Self&&) self).sndr_, (Receiver&&) rcvr};
+    }
+
+    template <stdexec::__decays_to<bulk_sender> Self, class Env>
+    friend auto tag_invoke(stdexec::get_completion_signatures_t, Self&&, Env&&)
+      -> completion_signatures<Self, Env> {
+      return {};
+    }
+
+    friend auto tag_invoke(stdexec::get_env_t, const bulk_sender& self) noexcept
+      -> stdexec::env_of_t<const Sender&> {
+      return stdexec::get_env(self.sndr_);
+    }
+  };
+
+  template <class SenderId, class ReceiverId, class Shape, class Fun>
+  struct multi_pool_context::bulk_op_state {
+    using Sender = stdexec::__t<SenderId>;
+    using Receiver = stdexec::__t<ReceiverId>;
+
+    // Receives the values of the predecessor and starts the parts.
+    struct receiver {
+      using is_receiver = void;
+      bulk_op_state* op_;
+
+      template <stdexec::same_as<stdexec::set_value_t> Tag, class... As>
+      friend void tag_invoke(Tag, receiver&& self, As&&... as) noexcept {
+        using tuple_t = stdexec::__decayed_tuple<As...>;
+        bulk_op_state& op = *self.op_;
+        try {
+          op.values_.template emplace<tuple_t>((As&&) as...);
+        } catch (...) {
+          stdexec::set_error((Receiver&&) op.rcvr_, std::current_exception());
+          return;
+        }
+        op.start_parts();
+      }
+
+      template <stdexec::__one_of<stdexec::set_error_t, stdexec::set_stopped_t> Tag, class... As>
+      friend void tag_invoke(Tag tag, receiver&& self, As&&... as) noexcept {
+        tag((Receiver&&) self.op_->rcvr_, (As&&) as...);
+      }
+
+      friend auto tag_invoke(stdexec::get_env_t, const receiver& self) noexcept
+        -> stdexec::env_of_t<Receiver> {
+        return stdexec::get_env(self.op_->rcvr_);
+      }
+    };
+
+    // Runs a range of the part [begin_, begin_ + n) of the shape on a pool.
+    struct part_fn {
+      bulk_op_state* op_;
+      Shape begin_;
+
+      void operator()(Shape first, Shape last) const {
+        op_->apply([&](auto&... args) {
+          for (Shape i = first; i < last; ++i) {
+            op_->fun_(static_cast<Shape>(begin_ + i), args...);
+          }
+        });
+      }
+    };
+
+    struct part_receiver {
+      using is_receiver = void;
+      bulk_op_state* op_;
+
+      friend void tag_invoke(stdexec::set_value_t, part_receiver&& self) noexcept {
+        self.op_->part_finished();
+      }
+
+      friend void
+        tag_invoke(stdexec::set_error_t, part_receiver&& self, std::exception_ptr error) noexcept {
+        bulk_op_state& op = *self.op_;
+        if (!op.failed_.exchange(true, std::memory_order_relaxed)) {
+          op.error_ = std::move(error);
+        }
+        op.part_finished();
+      }
+
+      friend void tag_invoke(stdexec::set_stopped_t, part_receiver&& self) noexcept {
+        self.op_->stopped_.store(true, std::memory_order_relaxed);
+        self.op_->part_finished();
+      }
+
+      friend auto tag_invoke(stdexec::get_env_t, const part_receiver& self) noexcept
+        -> stdexec::env_of_t<Receiver> {
+        return stdexec::get_env(self.op_->rcvr_);
+      }
+    };
+
+    using part_sender_t = decltype(exec::bulk_chunked(
+      std::declval<pool_sender_t>(),
+      std::declval<Shape>(),
+      std::declval<part_fn>()));
+    using part_op_t = stdexec::connect_result_t<part_sender_t, part_receiver>;
+
+    using variant_t = //
+      stdexec::__value_types_of_t<
+        Sender,
+        stdexec::env_of_t<Receiver>,
+        stdexec::__q<stdexec::__decayed_tuple>,
+        stdexec::__q<stdexec::__variant>>;
+
+    multi_pool_context& context_;
+    Receiver rcvr_;
+    Shape shape_;
+    Fun fun_;
+    variant_t values_;
+    std::unique_ptr<__manual_lifetime<part_op_t>[]> parts_;
+    std::size_t n_parts_{0};
+    std::atomic<std::size_t> remaining_{0};
+    std::atomic<bool> failed_{false};
+    std::atomic<bool> stopped_{false};
+    std::exception_ptr error_;
+    stdexec::connect_result_t<Sender, receiver> inner_op_;
+
+    bulk_op_state(
+      multi_pool_context& context,
+      Shape shape,
+      Fun fun,
+      Sender&& sndr,
+      Receiver rcvr)
+      : context_{context}
+      , rcvr_{(Receiver&&) rcvr}
+      , shape_{shape}
+      , fun_{(Fun&&) fun}
+      , parts_{new __manual_lifetime<part_op_t>[context.pool_count()]}
+      , inner_op_{stdexec::connect((Sender&&) sndr, receiver{this})} {
+      stdexec::__trace_allocation(
+        "multi_pool_context::bulk", context.pool_count() * sizeof(part_op_t));
+    }
+
+    ~bulk_op_state() {
+      destroy_parts();
+    }
+
+    template <class F>
+    void apply(F f) {
+      std::visit(
+        [&](auto& tupl) -> void { std::apply([&](auto&... args) -> void { f(args...); }, tupl); },
+        values_);
+    }
+
+    void destroy_parts() noexcept {
+      for (std::size_t i = 0; i < n_parts_; ++i) {
+        parts_[i].__destruct();
+      }
+      n_parts_ = 0;
+    }
+
+    void start_parts() noexcept {
+      try {
+        for (std::size_t index = 0; index < context_.pool_count(); ++index) {
+          auto [begin, end] = context_.share(shape_, index);
+          if (begin == end) {
+            continue;
+          }
+          parts_[n_parts_].__construct_with([&] {
+            return stdexec::connect(
+              exec::bulk_chunked(
+                stdexec::schedule(context_.get_pool(index).get_scheduler()),
+                static_cast<Shape>(end - begin),
+                part_fn{this, begin}),
+              part_receiver{this});
+          });
+          ++n_parts_;
+        }
+      } catch (...) {
+        destroy_parts();
+        stdexec::set_error((Receiver&&) rcvr_, std::current_exception());
+        return;
+      }
+
+      const std::size_t n_parts = n_parts_;
+      if (n_parts == 0) {
+        complete();
+        return;
+      }
+      remaining_.store(n_parts, std::memory_order_relaxed);
+      // The last part to finish completes the operation, which may destroy it, so only locals
+      // are used once the parts have been started.
+      __manual_lifetime<part_op_t>* parts = parts_.get();
+      for (std::size_t i = 0; i < n_parts; ++i) {
+        stdexec::start(parts[i].__get());
+      }
+    }
+
+    void part_finished() noexcept {
+      if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        complete();
+      }
+    }
+
+    void complete() noexcept {
+      if (failed_.load(std::memory_order_relaxed)) {
+        stdexec::set_error((Receiver&&) rcvr_, std::move(error_));
+      } else if (stopped_.load(std::memory_order_relaxed)) {
+        stdexec::set_stopped((Receiver&&) rcvr_);
+      } else {
+        apply([&](auto&... args) { stdexec::set_value((Receiver&&) rcvr_, std::move(args)...); });
+      }
+    }
+
+    friend void tag_invoke(stdexec::start_t, bulk_op_state& op) noexcept {
+      stdexec::start(op.inner_op_);
+    }
+  };
+} // namespace exec
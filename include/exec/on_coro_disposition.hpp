@@ -127,7 +127,9 @@ namespace exec {
         }
       };
 
-      struct __promise : with_awaitable_senders<__promise> {
+      struct __promise
+        : with_awaitable_senders<__promise>
+        , __traced_frame_allocation<"on_coroutine_disposition"__csz> {
         template <class _Action>
         explicit __promise(_Action&&, _Ts&... __ts) noexcept
           : __args_{__ts...} {
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../stdexec/__detail/__allocation_hooks.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace exec {
+  /////////////////////////////////////////////////////////////////////////////
+  // recycling_allocator<T>
+  //
+  // A stateless allocator that keeps freed single-object blocks in a
+  // thread-local free list per object size and alignment, and hands them out
+  // again on the next allocation of the same shape. The type-erased storage in
+  // any_sender_of.hpp rebinds its allocator to the dynamic type of the stored
+  // object, so using recycling_allocator in an exec::any_storage policy
+  // recycles the memory of operation states of the same type instead of
+  // allocating it anew on every connect. At most 64 blocks are kept per
+  // thread and shape; array allocations are not cached.
+  namespace __recycling {
+    template <std::size_t _Size, std::size_t _Align>
+    class __pool {
+      struct __node {
+        __node* __next_;
+      };
+
+      static constexpr std::size_t __max_cached = 64;
+      static constexpr std::size_t __block_size = _Size < sizeof(__node) ? sizeof(__node) : _Size;
+      static constexpr bool __over_aligned = _Align > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+      __node* __head_ = nullptr;
+      std::size_t __size_ = 0;
+
+     public:
+      static __pool& __get() noexcept {
+        static thread_local __pool __instance;
+        return __instance;
+      }
+
+      static void* __allocate_block() {
+        stdexec::__trace_allocation("recycling_allocator", __block_size);
+        if constexpr (__over_aligned) {
+          return ::operator new(__block_size, std::align_val_t{_Align});
+        } else {
+          return ::operator new(__block_size);
+        }
+      }
+
+      static void __deallocate_block(void* __block) noexcept {
+        if constexpr (__over_aligned) {
+          ::operator delete(__block, __block_size, std::align_val_t{_Align});
+        } else {
+          ::operator delete(__block, __block_size);
+        }
+      }
+
+      ~__pool() {
+        while (__head_ != nullptr) {
+          __deallocate_block(std::exchange(__head_, __head_->__next_));
+        }
+      }
+
+      void* __allocate() {
+        if (__head_ != nullptr) {
+          --__size_;
+          return std::exchange(__head_, __head_->__next_);
+        }
+        return __allocate_block();
+      }
+
+      void __deallocate(void* __block) noexcept {
+        if (__size_ == __max_cached) {
+          __deallocate_block(__block);
+          return;
+        }
+        ++__size_;
+        __head_ = ::new (__block) __node{__head_};
+      }
+    };
+  } // namespace __recycling
+
+  template <class _Tp>
+  struct recycling_allocator {
+    using value_type = _Tp;
+
+    recycling_allocator() = default;
+
+    template <class _Up>
+    constexpr recycling_allocator(const recycling_allocator<_Up>&) noexcept {
+    }
+
+    _Tp* allocate(std::size_t __n) {
+      if (__n == 1) {
+        return static_cast<_Tp*>(__pool_t::__get().__allocate());
+      }
+      stdexec::__trace_allocation("recycling_allocator", __n * sizeof(_Tp));
+      return std::allocator<_Tp>{}.allocate(__n);
+    }
+
+    void deallocate(_Tp* __p, std::size_t __n) noexcept {
+      if (__n == 1) {
+        __pool_t::__get().__deallocate(__p);
+      } else {
+        std::allocator<_Tp>{}.deallocate(__p, __n);
+      }
+    }
+
+    template <class _Up>
+    friend constexpr bool
+      operator==(const recycling_allocator&, const recycling_allocator<_Up>&) noexcept {
+      return true;
+    }
+
+   private:
+    using __pool_t = __recycling::__pool<sizeof(_Tp), alignof(_Tp)>;
+  };
+} // namespace exec
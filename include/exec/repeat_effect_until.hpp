@@ -17,19 +17,41 @@
 #pragma once
 
 #include "../stdexec/execution.hpp"
-#include "exec/trampoline_scheduler.hpp"
-#include "exec/on.hpp"
 #include "__detail/__manual_lifetime.hpp"
 #include "stdexec/__detail/__meta.hpp"
 #include "stdexec/concepts.hpp"
 #include "stdexec/functional.hpp"
-#include "trampoline_scheduler.hpp"
+
+#include <atomic>
 #include <concepts>
+#include <exception>
+#include <utility>
+#include <variant>
 
 namespace exec {
   namespace __repeat_effect_until {
     using namespace stdexec;
 
+    // Iterations that complete synchronously, i.e. before start() returns, are
+    // repeated by a loop in the starting frame instead of recursing, so no
+    // trampoline scheduler and no re-scheduling are needed. An iteration that
+    // completes asynchronously starts the next iteration from its completion,
+    // on a fresh stack.
+    //
+    // A completion recognizes that it runs inside start() by finding its
+    // operation in __starting_op, which costs no atomic operation. Any other
+    // completion may race with start() returning on another thread, so both
+    // sides exchange a flag and whichever comes second continues the loop or
+    // delivers the final result.
+    inline thread_local const void* __starting_op = nullptr;
+
+    enum class __outcome {
+      __again,
+      __done,
+      __error,
+      __stopped
+    };
+
     template <class _SourceId, class _ReceiverId>
     struct __receiver {
       struct __t;
@@ -43,29 +65,102 @@ namespace exec {
       struct __t : stdexec::__immovable {
         using __id = __operation;
         using __receiver_t = stdexec::__t<__receiver<_SourceId, _ReceiverId>>;
-        using __source_on_scheduler_sender =
-          __call_result_t<stdexec::on_t, trampoline_scheduler, _Source &>;
-        using __source_op_t = stdexec::connect_result_t<__source_on_scheduler_sender, __receiver_t>;
+        using __source_op_t = stdexec::connect_result_t<_Source &, __receiver_t>;
+        using __error_t = __error_types_of_t<
+          _Source &,
+          env_of_t<_Receiver>,
+          __transform<__q<__decay_t>, __mbind_front<__nullable_variant_t, std::exception_ptr>>>;
 
         STDEXEC_NO_UNIQUE_ADDRESS _Source __source_;
         STDEXEC_NO_UNIQUE_ADDRESS _Receiver __rcvr_;
         __manual_lifetime<__source_op_t> __source_op_;
-        trampoline_scheduler __sched_;
+        __error_t __error_{};
+        __outcome __outcome_{__outcome::__again};
+        bool __completed_inline_{false};
+        // Set by whichever of start() returning and an asynchronous completion
+        // happens first.
+        std::atomic<bool> __handoff_{false};
 
         template <class _Source2>
         __t(_Source2 &&__source, _Receiver __rcvr) noexcept(
-          __nothrow_decay_copyable<_Source2> &&__nothrow_decay_copyable<_Receiver>
-            &&nothrow_tag_invocable<stdexec::on_t, trampoline_scheduler, _Source>
-              &&__nothrow_connectable<__source_on_scheduler_sender, __receiver_t>)
+          __nothrow_decay_copyable<_Source2> &&__nothrow_decay_copyable<_Receiver>)
           : __source_((_Source2 &&) __source)
           , __rcvr_((_Receiver &&) __rcvr) {
-          __source_op_.__construct_with([&] {
-            return stdexec::connect(stdexec::on(__sched_, __source_), __receiver_t{this});
-          });
+        }
+
+        void __repeat() noexcept {
+          while (true) {
+            try {
+              __source_op_.__construct_with(
+                [&] { return stdexec::connect(__source_, __receiver_t{this}); });
+            } catch (...) {
+              __error_.template emplace<std::exception_ptr>(std::current_exception());
+              __outcome_ = __outcome::__error;
+              __complete();
+              return;
+            }
+            __completed_inline_ = false;
+            __handoff_.store(false, std::memory_order_relaxed);
+            const void* __prev = std::exchange(__starting_op, this);
+            stdexec::start(__source_op_.__get());
+            __starting_op = __prev;
+            if (!__completed_inline_ && !__handoff_.exchange(true, std::memory_order_acq_rel)) {
+              // Still running; the completion continues from here.
+              return;
+            }
+            if (__outcome_ != __outcome::__again) {
+              __complete();
+              return;
+            }
+          }
+        }
+
+        // Called by the receiver after the source operation has been
+        // destroyed.
+        void __iteration_completed(__outcome __result) noexcept {
+          __outcome_ = __result;
+          if (__starting_op == this) {
+            // Completed inside start(); __repeat picks it up.
+            __completed_inline_ = true;
+            return;
+          }
+          if (!__handoff_.exchange(true, std::memory_order_acq_rel)) {
+            // start() has not returned yet.
+            return;
+          }
+          if (__result == __outcome::__again) {
+            __repeat();
+          } else {
+            __complete();
+          }
+        }
+
+        void __complete() noexcept {
+          switch (__outcome_) {
+          case __outcome::__done:
+            stdexec::set_value((_Receiver &&) __rcvr_);
+            break;
+          case __outcome::__error:
+            std::visit(
+              [this]<class _Error>(_Error &__error) noexcept {
+                if constexpr (!same_as<_Error, std::monostate>) {
+                  stdexec::set_error((_Receiver &&) __rcvr_, (_Error &&) __error);
+                }
+              },
+              __error_);
+            break;
+          case __outcome::__stopped:
+            if constexpr (__callable<set_stopped_t, _Receiver>) {
+              stdexec::set_stopped((_Receiver &&) __rcvr_);
+            }
+            break;
+          case __outcome::__again:
+            STDEXEC_ASSERT(false);
+          }
         }
 
         friend void tag_invoke(stdexec::start_t, __t &__self) noexcept {
-          stdexec::start(__self.__source_op_.__get());
+          __self.__repeat();
         }
       };
     };
@@ -99,20 +194,7 @@ namespace exec {
 
         // The following line causes the invalidation of __self.
         __op->__source_op_.__destruct();
-
-        // If the sender completed with true, we're done
-        if (__done) {
-          stdexec::set_value((_Receiver &&) __op->__rcvr_);
-        } else {
-          try {
-            auto &__source_op = __op->__source_op_.__construct_with([&]() {
-              return stdexec::connect(stdexec::on(__op->__sched_, __op->__source_), __t{__op});
-            });
-            stdexec::start(__source_op);
-          } catch (...) {
-            stdexec::set_error((_Receiver &&) __op->__rcvr_, std::current_exception());
-          }
-        }
+        __op->__iteration_completed(__done ? __outcome::__done : __outcome::__again);
       }
 
       template <same_as<set_stopped_t> _Tag, same_as<__t> _Self>
@@ -120,15 +202,17 @@ namespace exec {
       friend void tag_invoke(_Tag, _Self &&__self) noexcept {
         auto *__op = __self.__op_;
         __op->__source_op_.__destruct();
-        stdexec::set_stopped((_Receiver &&) __op->__rcvr_);
+        __op->__iteration_completed(__outcome::__stopped);
       }
 
       template <same_as<set_error_t> _Tag, same_as<__t> _Self, class _Error>
         requires __callable<_Tag, _Receiver, _Error>
       friend void tag_invoke(_Tag, _Self &&__self, _Error __error) noexcept {
         auto *__op = __self.__op_;
+        // The error may live in the source operation, so save it first.
+        __op->__error_.template emplace<_Error>((_Error &&) __error);
         __op->__source_op_.__destruct();
-        stdexec::set_error((_Receiver &&) __op->__rcvr_, (_Error &&) __error);
+        __op->__iteration_completed(__outcome::__error);
       }
 
       friend env_of_t<_Receiver> tag_invoke(get_env_t, const __t &__self) noexcept(
@@ -160,11 +244,7 @@ namespace exec {
           stdexec::make_completion_signatures<
             _Source &,
             _Env,
-            stdexec::make_completion_signatures<
-              stdexec::schedule_result_t<exec::trampoline_scheduler>,
-              _Env,
-              completion_signatures<set_error_t(std::exception_ptr), stdexec::set_value_t()>,
-              __value_t>,
+            completion_signatures<set_error_t(std::exception_ptr), stdexec::set_value_t()>,
             __value_t>;
 
         template <__decays_to<__t> _Self, class _Env>
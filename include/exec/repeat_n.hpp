@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../stdexec/execution.hpp"
+#include "__detail/__manual_lifetime.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <utility>
+#include <variant>
+
+namespace exec {
+  /////////////////////////////////////////////////////////////////////////////
+  // repeat_n(sndr, n, closure)
+  //
+  // Once sndr completes with a value, runs the sender adaptor closure on a
+  // sender that completes with no values, n times in a row, and then
+  // completes with no values. The values of sndr are discarded. An error or
+  // stopped completion of sndr or of an iteration ends the loop and is
+  // forwarded.
+  //
+  //   sync_wait(
+  //     schedule(pool.get_scheduler())
+  //     | exec::repeat_n(1000, bulk(cells, update_h) | bulk(cells, update_e)));
+  //
+  // Schedulers may customize repeat_n for senders that complete on them by
+  // providing tag_invoke(repeat_n_t, scheduler, sndr, n, closure); e.g.
+  // static_thread_pool runs closures made of bulk operations with one
+  // dispatch for all iterations.
+  namespace __repeat_n {
+    using namespace stdexec;
+
+    // Like repeat_effect_until, iterations that complete synchronously are
+    // repeated by a loop in the frame that started them, and an iteration
+    // that completes asynchronously continues the loop from its completion.
+    inline thread_local const void* __starting_op = nullptr;
+
+    enum class __outcome {
+      __again,
+      __error,
+      __stopped
+    };
+
+    template <class _Closure>
+    using __body_t = __call_result_t<const _Closure&, decltype(stdexec::just())>;
+
+    // The closure is applied to just(), which doesn't know where it runs. So
+    // that the body is lowered for the scheduler on which the predecessor
+    // completes, e.g. a bulk in the closure runs in parallel on it, that
+    // scheduler and its domain are the current ones in the environment of the
+    // body.
+    template <class _Sender>
+    auto __predecessor_env(const _Sender& __sndr) noexcept {
+      if constexpr (__callable<get_completion_scheduler_t<set_value_t>, env_of_t<_Sender>>) {
+        auto __sched = get_completion_scheduler<set_value_t>(get_env(__sndr));
+        auto __domain = query_or(get_domain, __sched, __default_domain());
+        return __join_env(__mkprop(get_scheduler, __sched), __mkprop(get_domain, __domain));
+      } else {
+        return empty_env();
+      }
+    }
+
+    template <class _Sender>
+    using __predecessor_env_t = decltype(__repeat_n::__predecessor_env(__declval<_Sender&>()));
+
+    template <class _Sender, class _Env>
+    using __body_env_t = __env::__env_join_t<__predecessor_env_t<_Sender>, _Env>;
+
+    template <class _SenderId, class _ClosureId, class _ReceiverId>
+    struct __operation {
+      struct __t;
+    };
+
+    template <class _SenderId, class _ClosureId, class _ReceiverId>
+    struct __receiver {
+      struct __t {
+        using is_receiver = void;
+        using __id = __receiver;
+        using _Receiver = stdexec::__t<_ReceiverId>;
+        using __op_t = stdexec::__t<__operation<_SenderId, _ClosureId, _ReceiverId>>;
+
+        __op_t* __op_;
+
+        // The values of the predecessor are discarded.
+        template <same_as<set_value_t> _Tag, class... _Values>
+        friend void tag_invoke(_Tag, __t&& __self, _Values&&...) noexcept {
+          __self.__op_->__repeat();
+        }
+
+        template <__one_of<set_error_t, set_stopped_t> _Tag, class... _As>
+          requires __callable<_Tag, _Receiver, _As...>
+        friend void tag_invoke(_Tag __tag, __t&& __self, _As&&... __as) noexcept {
+          __tag((_Receiver&&) __self.__op_->__rcvr_, (_As&&) __as...);
+        }
+
+        friend env_of_t<_Receiver> tag_invoke(get_env_t, const __t& __self) noexcept(
+          __nothrow_callable<get_env_t, const _Receiver&>) {
+          return get_env(__self.__op_->__rcvr_);
+        }
+      };
+    };
+
+    template <class _SenderId, class _ClosureId, class _ReceiverId>
+    struct __body_receiver {
+      struct __t {
+        using is_receiver = void;
+        using __id = __body_receiver;
+        using _Receiver = stdexec::__t<_ReceiverId>;
+        using __op_t = stdexec::__t<__operation<_SenderId, _ClosureId, _ReceiverId>>;
+
+        __op_t* __op_;
+
+        template <same_as<set_value_t> _Tag, class... _Values>
+        friend void tag_invoke(_Tag, __t&& __self, _Values&&...) noexcept {
+          __op_t* __op = __self.__op_;
+          // The following line causes the invalidation of __self.
+          __op->__body_op_.__destruct();
+          __op->__iteration_completed(__outcome::__again);
+        }
+
+        template <same_as<set_stopped_t> _Tag>
+          requires __callable<_Tag, _Receiver>
+        friend void tag_invoke(_Tag, __t&& __self) noexcept {
+          __op_t* __op = __self.__op_;
+          __op->__body_op_.__destruct();
+          __op->__iteration_completed(__outcome::__stopped);
+        }
+
+        template <same_as<set_error_t> _Tag, class _Error>
+          requires __callable<_Tag, _Receiver, _Error>
+        friend void tag_invoke(_Tag, __t&& __self, _Error __error) noexcept {
+          __op_t* __op = __self.__op_;
+          // The error may live in the body operation, so save it first.
+          __op->__error_.template emplace<_Error>((_Error&&) __error);
+          __op->__body_op_.__destruct();
+          __op->__iteration_completed(__outcome::__error);
+        }
+
+        friend auto tag_invoke(get_env_t, const __t& __self) noexcept(
+          __nothrow_callable<get_env_t, const _Receiver&>)
+          -> __body_env_t<stdexec::__t<_SenderId>, env_of_t<_Receiver>> {
+          return __join_env(
+            __predecessor_env_t<stdexec::__t<_SenderId>>(__self.__op_->__pred_env_),
+            get_env(__self.__op_->__rcvr_));
+        }
+      };
+    };
+
+    template <class _SenderId, class _ClosureId, class _ReceiverId>
+    struct __operation<_SenderId, _ClosureId, _ReceiverId>::__t : __immovable {
+      using __id = __operation;
+      using _Sender = stdexec::__t<_SenderId>;
+      using _Closure = stdexec::__t<_ClosureId>;
+      using _Receiver = stdexec::__t<_ReceiverId>;
+      using __receiver_t = stdexec::__t<__receiver<_SenderId, _ClosureId, _ReceiverId>>;
+      using __body_receiver_t = stdexec::__t<__body_receiver<_SenderId, _ClosureId, _ReceiverId>>;
+      using __body_op_t = connect_result_t<__body_t<_Closure>, __body_receiver_t>;
+      using __error_t = __error_types_of_t<
+        __body_t<_Closure>,
+        __body_env_t<_Sender, env_of_t<_Receiver>>,
+        __transform<__q<__decay_t>, __mbind_front<__nullable_variant_t, std::exception_ptr>>>;
+
+      _Closure __closure_;
+      _Receiver __rcvr_;
+      STDEXEC_NO_UNIQUE_ADDRESS __predecessor_env_t<_Sender> __pred_env_;
+      std::size_t __n_;
+      std::size_t __count_{0};
+      __error_t __error_{};
+      __outcome __outcome_{__outcome::__again};
+      bool __completed_inline_{false};
+      // Set by whichever of start() returning and an asynchronous completion
+      // happens first.
+      std::atomic<bool> __handoff_{false};
+      __manual_lifetime<__body_op_t> __body_op_;
+      connect_result_t<_Sender, __receiver_t> __op_;
+
+      template <class _Sender2>
+      __t(_Sender2&& __sndr, std::size_t __n, _Closure __closure, _Receiver __rcvr)
+        : __closure_((_Closure&&) __closure)
+        , __rcvr_((_Receiver&&) __rcvr)
+        , __pred_env_(__repeat_n::__predecessor_env(__sndr))
+        , __n_(__n)
+        , __op_(stdexec::connect((_Sender2&&) __sndr, __receiver_t{this})) {
+      }
+
+      void __repeat() noexcept {
+        while (__count_ != __n_) {
+          ++__count_;
+          try {
+            __body_op_.__construct_with([&] {
+              return stdexec::connect(__closure_(stdexec::just()), __body_receiver_t{this});
+            });
+          } catch (...) {
+            __error_.template emplace<std::exception_ptr>(std::current_exception());
+            __outcome_ = __outcome::__error;
+            __complete();
+            return;
+          }
+          __completed_inline_ = false;
+          __handoff_.store(false, std::memory_order_relaxed);
+          const void* __prev = std::exchange(__starting_op, this);
+          stdexec::start(__body_op_.__get());
+          __starting_op = __prev;
+          if (!__completed_inline_ && !__handoff_.exchange(true, std::memory_order_acq_rel)) {
+            // Still running; the completion continues from here.
+            return;
+          }
+          if (__outcome_ != __outcome::__again) {
+            __complete();
+            return;
+          }
+        }
+        __complete();
+      }
+
+      // Called by the body receiver after the body operation has been
+      // destroyed.
+      void __iteration_completed(__outcome __result) noexcept {
+        __outcome_ = __result;
+        if (__starting_op == this) {
+          // Completed inside start(); __repeat picks it up.
+          __completed_inline_ = true;
+          return;
+        }
+        if (!__handoff_.exchange(true, std::memory_order_acq_rel)) {
+          // start() has not returned yet.
+          return;
+        }
+        if (__result == __outcome::__again) {
+          __repeat();
+        } else {
+          __complete();
+        }
+      }
+
+      void __complete() noexcept {
+        switch (__outcome_) {
+        case __outcome::__again:
+          stdexec::set_value((_Receiver&&) __rcvr_);
+          break;
+        case __outcome::__error:
+          std::visit(
+            [this]<class _Error>(_Error& __error) noexcept {
+              if constexpr (!same_as<_Error, std::monostate>) {
+                stdexec::set_error((_Receiver&&) __rcvr_, (_Error&&) __error);
+              }
+            },
+            __error_);
+          break;
+        case __outcome::__stopped:
+          if constexpr (__callable<set_stopped_t, _Receiver>) {
+            stdexec::set_stopped((_Receiver&&) __rcvr_);
+          }
+          break;
+        }
+      }
+
+      friend void tag_invoke(start_t, __t& __self) noexcept {
+        stdexec::start(__self.__op_);
+      }
+    };
+
+    template <class _SenderId, class _ClosureId>
+    struct __sender {
+      using _Sender = stdexec::__t<_SenderId>;
+      using _Closure = stdexec::__t<_ClosureId>;
+
+      template <class _Self, class _Receiver>
+      using __op_t = stdexec::__t<__operation<
+        stdexec::__id<__copy_cvref_t<_Self, _Sender>>,
+        _ClosureId,
+        stdexec::__id<_Receiver>>>;
+
+      template <class _Self, class _Receiver>
+      using __receiver_t = stdexec::__t<__receiver<
+        stdexec::__id<__copy_cvref_t<_Self, _Sender>>,
+        _ClosureId,
+        stdexec::__id<_Receiver>>>;
+
+      template <class _Self, class _Receiver>
+      using __body_receiver_t = stdexec::__t<__body_receiver<
+        stdexec::__id<__copy_cvref_t<_Self, _Sender>>,
+        _ClosureId,
+        stdexec::__id<_Receiver>>>;
+
+      struct __t {
+        using is_sender = void;
+        using __id = __sender;
+
+        _Sender __sndr_;
+        std::size_t __n_;
+        _Closure __closure_;
+
+        template <class...>
+        using __value_t = completion_signatures<>;
+
+        template <class _Self, class _Env>
+        using __completion_signatures = //
+          make_completion_signatures<
+            __copy_cvref_t<_Self, _Sender>,
+            _Env,
+            make_completion_signatures<
+              __body_t<_Closure>,
+              __body_env_t<__copy_cvref_t<_Self, _Sender>, _Env>,
+              completion_signatures<set_error_t(std::exception_ptr), set_value_t()>,
+              __value_t>,
+            __value_t>;
+
+        template <__decays_to<__t> _Self, class _Env>
+        friend auto tag_invoke(get_completion_signatures_t, _Self&&, _Env&&)
+          -> __completion_signatures<_Self, _Env> {
+          return {};
+        }
+
+        template <__decays_to<__t> _Self, receiver _Receiver>
+          requires sender_to<__copy_cvref_t<_Self, _Sender>, __receiver_t<_Self, _Receiver>>
+                && sender_to<__body_t<_Closure>, __body_receiver_t<_Self, _Receiver>>
+        friend __op_t<_Self, _Receiver> tag_invoke(connect_t, _Self&& __self, _Receiver __rcvr) {
+          return {
+            ((_Self&&) __self).__sndr_,
+            __self.__n_,
+            ((_Self&&) __self).__closure_,
+            (_Receiver&&) __rcvr};
+        }
+
+        friend auto tag_invoke(get_env_t, const __t& __self) //
+          noexcept(__nothrow_callable<get_env_t, const _Sender&>) -> env_of_t<const _Sender&> {
+          return get_env(__self.__sndr_);
+        }
+      };
+    };
+
+    template <class _Sender, class _Closure>
+    using __sender_t = __t<__sender<stdexec::__id<__decay_t<_Sender>>, stdexec::__id<_Closure>>>;
+
+    struct repeat_n_t;
+
+    // A customization of repeat_n for the scheduler on which the sender completes.
+    template <class _Sender, class _Closure>
+    concept __customized_for_scheduler = //
+      __callable<get_completion_scheduler_t<set_value_t>, env_of_t<_Sender>>
+      && tag_invocable<
+        repeat_n_t,
+        __call_result_t<get_completion_scheduler_t<set_value_t>, env_of_t<_Sender>>,
+        _Sender,
+        std::size_t,
+        _Closure>;
+
+    struct repeat_n_t {
+      template <sender _Sender, __sender_adaptor_closure _Closure>
+        requires __customized_for_scheduler<_Sender, _Closure>
+      auto operator()(_Sender&& __sndr, std::size_t __n, _Closure __closure) const {
+        auto __sched = get_completion_scheduler<set_value_t>(get_env(__sndr));
+        return tag_invoke(*this, __sched, (_Sender&&) __sndr, __n, (_Closure&&) __closure);
+      }
+
+      template <sender _Sender, __sender_adaptor_closure _Closure>
+        requires(!__customized_for_scheduler<_Sender, _Closure>)
+      auto operator()(_Sender&& __sndr, std::size_t __n, _Closure __closure) const
+        -> __sender_t<_Sender, _Closure> {
+        return {(_Sender&&) __sndr, __n, (_Closure&&) __closure};
+      }
+
+      template <__sender_adaptor_closure _Closure>
+      auto operator()(std::size_t __n, _Closure __closure) const
+        -> __binder_back<repeat_n_t, std::size_t, _Closure> {
+        return {{}, {}, {__n, (_Closure&&) __closure}};
+      }
+    };
+  } // namespace __repeat_n
+
+  using __repeat_n::repeat_n_t;
+  inline constexpr repeat_n_t repeat_n{};
+} // namespace exec
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "./__detail/__scheduler_tracing.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace exec {
+  /////////////////////////////////////////////////////////////////////////////
+  // Scheduler tracing
+  //
+  // If STDEXEC_SCHEDULER_TRACING is defined to a nonzero value for the whole
+  // program, static_thread_pool and io_uring_context record, for every task
+  // they run, when it was enqueued, when it started and when it finished.
+  // Each thread that runs tasks aggregates the time between enqueueing and
+  // starting (the queue delay) and the time spent running the task into its
+  // own histograms, and keeps a bounded log of the individual tasks for
+  // export as a Chrome trace. Recording takes no locks.
+  //
+  // For io_uring_context the queue delay of an operation spans from its
+  // submission to the processing of its completion, so it includes the time
+  // the kernel took to perform the operation.
+  //
+  // Without the macro nothing is recorded and the functions below report no
+  // tasks.
+
+  // A histogram of durations in nanoseconds, with a relative precision of
+  // 1/16 for every value.
+  using latency_histogram = __tracing::__basic_histogram<std::uint64_t>;
+
+  struct scheduler_latency {
+    std::string scheduler;
+    latency_histogram queue_delay;
+    latency_histogram execution;
+  };
+
+  struct scheduler_trace_event {
+    const char* scheduler;
+    std::uint32_t thread; // threads are numbered in the order they first ran a task
+    // These are measured from the time tracing was first used.
+    std::chrono::nanoseconds enqueued;
+    std::chrono::nanoseconds started;
+    std::chrono::nanoseconds finished;
+  };
+
+  // The latencies recorded so far on all threads, one entry per kind of
+  // scheduler that ran a task.
+  inline std::vector<scheduler_latency> get_scheduler_latencies() {
+    std::vector<scheduler_latency> __result;
+    __tracing::__the_registry.__for_each_log([&](const __tracing::__thread_log& __log) {
+      for (const auto& __atomic_slot: __log.__slots_) {
+        const __tracing::__scheduler_slot* __slot = __atomic_slot.load(std::memory_order_acquire);
+        if (__slot == nullptr || __slot->__queue_delay_.count() == 0) {
+          continue;
+        }
+        auto __it = __result.begin();
+        while (__it != __result.end() && __it->scheduler != __slot->__scheduler_) {
+          ++__it;
+        }
+        if (__it == __result.end()) {
+          __it = __result.insert(__it, scheduler_latency{__slot->__scheduler_, {}, {}});
+        }
+        __it->queue_delay.merge(__slot->__queue_delay_);
+        __it->execution.merge(__slot->__execution_);
+      }
+    });
+    return __result;
+  }
+
+  // The individual tasks recorded so far, grouped by thread. Each thread
+  // logs at most get_scheduler_trace_event_limit() tasks.
+  inline std::vector<scheduler_trace_event> get_scheduler_trace_events() {
+    std::vector<scheduler_trace_event> __result;
+    const std::uint64_t __epoch = __tracing::__the_registry.__epoch();
+    auto __since_epoch = [__epoch](std::uint64_t __time) {
+      return std::chrono::nanoseconds(__time > __epoch ? __time - __epoch : 0);
+    };
+    __tracing::__the_registry.__for_each_log([&](const __tracing::__thread_log& __log) {
+      for (const __tracing::__event_chunk* __chunk =
+             __log.__first_chunk_.load(std::memory_order_acquire);
+           __chunk;
+           __chunk = __chunk->__next_.load(std::memory_order_acquire)) {
+        const std::size_t __size = __chunk->__size_.load(std::memory_order_acquire);
+        for (std::size_t __i = 0; __i < __size; ++__i) {
+          const __tracing::__event& __ev = __chunk->__events_[__i];
+          __result.push_back(scheduler_trace_event{
+            __ev.__scheduler_,
+            __log.__index_,
+            __since_epoch(__ev.__enqueued_),
+            __since_epoch(__ev.__started_),
+            __since_epoch(__ev.__finished_)});
+        }
+      }
+    });
+    return __result;
+  }
+
+  // The number of tasks that were not logged because a thread reached the
+  // limit. They are still counted in the histograms.
+  inline std::uint64_t get_scheduler_trace_dropped_events() noexcept {
+    std::uint64_t __dropped = 0;
+    __tracing::__the_registry.__for_each_log([&](const __tracing::__thread_log& __log) {
+      __dropped += __log.__n_dropped_.__get();
+    });
+    return __dropped;
+  }
+
+  inline std::size_t get_scheduler_trace_event_limit() noexcept {
+    return __tracing::__the_registry.__event_limit_.load(std::memory_order_relaxed);
+  }
+
+  // Sets how many tasks each thread logs individually; the default is 65536.
+  // Pass 0 to only keep the histograms.
+  inline void set_scheduler_trace_event_limit(std::size_t __limit) noexcept {
+    __tracing::__the_registry.__event_limit_.store(__limit, std::memory_order_relaxed);
+  }
+
+  // Discards everything recorded so far. No traced task may run concurrently.
+  inline void reset_scheduler_tracing() noexcept {
+    __tracing::__the_registry.__for_each_log([](__tracing::__thread_log& __log) {
+      __log.__reset();
+    });
+  }
+
+  // Writes the logged tasks in the Chrome trace event format, which can be
+  // loaded into chrome://tracing or https://ui.perfetto.dev. Every task is a
+  // complete event on the thread that ran it, and the time it spent queued is
+  // an async event on a track of its scheduler.
+  inline void write_chrome_trace(std::ostream& __os) {
+    const std::vector<scheduler_trace_event> __events = get_scheduler_trace_events();
+    auto __micros = [](std::chrono::nanoseconds __ns) {
+      return static_cast<double>(__ns.count()) / 1000.0;
+    };
+    char __buffer[256];
+    __os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    const char* __separator = "\n";
+    std::uint32_t __n_threads = 0;
+    for (const scheduler_trace_event& __ev: __events) {
+      __n_threads = __ev.thread + 1 > __n_threads ? __ev.thread + 1 : __n_threads;
+    }
+    for (std::uint32_t __index = 0; __index < __n_threads; ++__index) {
+      std::snprintf(
+        __buffer,
+        sizeof(__buffer),
+        "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+        "\"args\":{\"name\":\"thread %u\"}}",
+        __index,
+        __index);
+      __os << std::exchange(__separator, ",\n") << __buffer;
+    }
+    std::size_t __id = 0;
+    for (const scheduler_trace_event& __ev: __events) {
+      std::snprintf(
+        __buffer,
+        sizeof(__buffer),
+        "{\"name\":\"task\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+        "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"queue_delay_us\":%.3f}}",
+        __ev.scheduler,
+        __ev.thread,
+        __micros(__ev.started),
+        __micros(__ev.finished - __ev.started),
+        __micros(__ev.started - __ev.enqueued));
+      __os << std::exchange(__separator, ",\n") << __buffer;
+      const char* __phases[] = {"b", "e"};
+      const std::chrono::nanoseconds __times[] = {__ev.enqueued, __ev.started};
+      for (int __i = 0; __i < 2; ++__i) {
+        std::snprintf(
+          __buffer,
+          sizeof(__buffer),
+          "{\"name\":\"queued\",\"cat\":\"%s\",\"ph\":\"%s\",\"id\":%zu,\"pid\":1,\"ts\":%.3f}",
+          __ev.scheduler,
+          __phases[__i],
+          __id,
+          __micros(__times[__i]));
+        __os << ",\n" << __buffer;
+      }
+      ++__id;
+    }
+    __os << "\n]}\n";
+  }
+} // namespace exec
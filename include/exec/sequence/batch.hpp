@@ -0,0 +1,661 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../sequence_senders.hpp"
+#include "../timed_scheduler.hpp"
+#include "../../stdexec/__detail/__intrusive_queue.hpp"
+
+#include <mutex>
+#include <optional>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace exec {
+  /////////////////////////////////////////////////////////////////////////////
+  // batch(sequence, n) and batch_for(sequence, scheduler, n, duration)
+  //
+  // Coalesces the values of the items of the input sequence into batches of
+  // up to n values. Every batch is emitted downstream as a single item that
+  // completes with a std::span over the batch. The span refers to a buffer
+  // that is owned by the sequence operation and is reused for the next batch
+  // once the downstream next-sender has completed.
+  //
+  // batch_for additionally emits a partial batch once the given duration has
+  // passed since its first value has been added. The deadline is measured
+  // with schedule_at on the given timed scheduler, from the time of now() when
+  // the first value was added.
+  namespace __batch {
+    using namespace stdexec;
+
+    struct __no_deadline {
+      using __time_point_t = std::monostate;
+    };
+
+    template <class _Scheduler>
+    struct __deadline {
+      using __time_point_t = time_point_of_t<_Scheduler>;
+
+      _Scheduler __sched_;
+      duration_of_t<_Scheduler> __duration_;
+    };
+
+    template <class _Ret, class... _Args>
+    __decayed_tuple<_Ret, _Args...> __signature_to_tuple_(_Ret (*)(_Args...));
+
+    template <class _Sig>
+    using __signature_to_tuple_t = decltype(__signature_to_tuple_((_Sig*) nullptr));
+
+    template <class _Sender, class _Env>
+    using __value_t = __decay_t<__single_sender_value_t<_Sender, _Env>>;
+
+    template <class _Sender, class _Env>
+    using __batch_sender_t = __call_result_t<decltype(just), std::span<__value_t<_Sender, _Env>>>;
+
+    // The final completion of the resulting sequence. Besides the completions
+    // of the input sequence, it may complete with an error that was sent by
+    // an item or with an exception that was thrown while storing a value.
+    template <class _Sender, class _Env>
+    using __result_variant_t = //
+      __mapply<
+        __transform<__q<__signature_to_tuple_t>, __nullable_variant_t>,
+        __concat_completion_signatures_t<
+          completion_signatures<set_error_t(std::exception_ptr)>,
+          __sequence_completion_signatures_of_t<_Sender, _Env>>>;
+
+    template <class _Sender, class _Env>
+    using __completion_sigs_t = //
+      make_completion_signatures<
+        _Sender,
+        _Env,
+        completion_signatures<
+          set_value_t(std::span<__value_t<_Sender, _Env>>),
+          set_error_t(std::exception_ptr),
+          set_stopped_t()>,
+        __mconst<completion_signatures<>>::__f>;
+
+    // An item whose value has been obtained and that waits to be added to the
+    // current batch.
+    template <class _Value>
+    struct __item_base {
+      using __complete_fn = void(__item_base*, bool) noexcept;
+
+      __item_base* __next_{};
+      __complete_fn* __complete_{};
+      std::optional<_Value> __value_{};
+
+      void __complete(bool __stopped) noexcept {
+        __complete_(this, __stopped);
+      }
+    };
+
+    template <class _ItemOp, class _Env>
+    struct __item_receiver {
+      struct __t {
+        using __id = __item_receiver;
+        using is_receiver = void;
+        _ItemOp* __op_;
+
+        template <same_as<set_value_t> _SetValue, same_as<__t> _Self, class... _As>
+        friend void tag_invoke(_SetValue, _Self&& __self, _As&&... __as) noexcept {
+          _ItemOp* __op = __self.__op_;
+          try {
+            __op->__value_.emplace(static_cast<_As&&>(__as)...);
+          } catch (...) {
+            __op->__parent_->__item_failed(__op, set_error, std::current_exception());
+            return;
+          }
+          __op->__parent_->__push(__op);
+        }
+
+        template <__one_of<set_error_t, set_stopped_t> _Tag, same_as<__t> _Self, class... _Error>
+        friend void tag_invoke(_Tag, _Self&& __self, _Error&&... __err) noexcept {
+          __self.__op_->__parent_->__item_failed(
+            __self.__op_, _Tag{}, static_cast<_Error&&>(__err)...);
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend auto tag_invoke(_GetEnv, const _Self& __self) noexcept -> _Env {
+          return stdexec::get_env(__self.__op_->__next_rcvr_);
+        }
+      };
+    };
+
+    template <class _Item, class _Value, class _Op, class _NextRcvr>
+    struct __item_operation {
+      struct __t : __item_base<_Value> {
+        using __id = __item_operation;
+        using __item_receiver_t = stdexec::__t<__item_receiver<__t, env_of_t<_NextRcvr>>>;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _NextRcvr __next_rcvr_;
+        _Op* __parent_;
+        connect_result_t<_Item, __item_receiver_t> __item_op_;
+
+        __t(_Item&& __item, _NextRcvr __next_rcvr, _Op* __parent)
+          : __item_base<_Value>{nullptr, &__completed}
+          , __next_rcvr_(static_cast<_NextRcvr&&>(__next_rcvr))
+          , __parent_(__parent)
+          , __item_op_(stdexec::connect(static_cast<_Item&&>(__item), __item_receiver_t{this})) {
+        }
+
+        static void __completed(__item_base<_Value>* __base, bool __stopped) noexcept {
+          __t* __self = static_cast<__t*>(__base);
+          if (__stopped) {
+            stdexec::set_stopped(static_cast<_NextRcvr&&>(__self->__next_rcvr_));
+          } else {
+            stdexec::set_value(static_cast<_NextRcvr&&>(__self->__next_rcvr_));
+          }
+        }
+
+        friend void tag_invoke(start_t, __t& __self) noexcept {
+          stdexec::start(__self.__item_op_);
+        }
+      };
+    };
+
+    template <class _Item, class _Value, class _Op>
+    struct __item_sender {
+      struct __t {
+        using __id = __item_sender;
+        using is_sender = void;
+        using completion_signatures = stdexec::completion_signatures<set_value_t(), set_stopped_t()>;
+
+        template <class _Self, class _NextRcvr>
+        using __operation_t =
+          stdexec::__t<__item_operation<__copy_cvref_t<_Self, _Item>, _Value, _Op, _NextRcvr>>;
+
+        _Item __item_;
+        _Op* __parent_;
+
+        template <__decays_to<__t> _Self, receiver_of<completion_signatures> _NextRcvr>
+        friend auto tag_invoke(connect_t, _Self&& __self, _NextRcvr __rcvr)
+          -> __operation_t<_Self, _NextRcvr> {
+          return {
+            static_cast<_Self&&>(__self).__item_, static_cast<_NextRcvr&&>(__rcvr), __self.__parent_};
+        }
+      };
+    };
+
+    // Receives the completion of the next-sender of a delivered batch.
+    template <class _Op, class _Env>
+    struct __deliver_receiver {
+      struct __t {
+        using __id = __deliver_receiver;
+        using is_receiver = void;
+        _Op* __op_;
+
+        template <same_as<set_value_t> _SetValue, same_as<__t> _Self>
+        friend void tag_invoke(_SetValue, _Self&& __self) noexcept {
+          __self.__op_->__delivered(false);
+        }
+
+        template <same_as<set_stopped_t> _SetStopped, same_as<__t> _Self>
+        friend void tag_invoke(_SetStopped, _Self&& __self) noexcept {
+          __self.__op_->__delivered(true);
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend auto tag_invoke(_GetEnv, const _Self& __self) noexcept -> _Env {
+          return stdexec::get_env(__self.__op_->__rcvr_);
+        }
+      };
+    };
+
+    template <class _Op, class _Env>
+    struct __timer_receiver {
+      using __env_t = __make_env_t<_Env, __with<get_stop_token_t, in_place_stop_token>>;
+
+      struct __t {
+        using __id = __timer_receiver;
+        using is_receiver = void;
+        _Op* __op_;
+
+        // Every completion of the timer is treated as an expired deadline.
+        template <__completion_tag _Tag, same_as<__t> _Self, class... _As>
+        friend void tag_invoke(_Tag, _Self&& __self, _As&&...) noexcept {
+          __self.__op_->__timer_expired();
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend auto tag_invoke(_GetEnv, const _Self& __self) noexcept -> __env_t {
+          return __make_env(
+            stdexec::get_env(__self.__op_->__rcvr_),
+            __with_(get_stop_token, __self.__op_->__timer_stop_source_.get_token()));
+        }
+      };
+    };
+
+    template <class _Deadline, class _Op, class _Env>
+    struct __timer_op {
+      using __t = std::monostate;
+    };
+
+    template <class _Scheduler, class _Op, class _Env>
+    struct __timer_op<__deadline<_Scheduler>, _Op, _Env> {
+      using __t = connect_result_t<
+        __call_result_t<schedule_at_t, _Scheduler&, const time_point_of_t<_Scheduler>&>,
+        stdexec::__t<__timer_receiver<_Op, _Env>>>;
+    };
+
+    template <class _Op, class _Env, class _Value>
+    struct __receiver {
+      struct __t {
+        using __id = __receiver;
+        using is_receiver = void;
+        _Op* __op_;
+
+        template <same_as<set_next_t> _SetNext, same_as<__t> _Self, sender _Item>
+        friend auto tag_invoke(_SetNext, _Self& __self, _Item&& __item) //
+          noexcept(__nothrow_decay_copyable<_Item>)
+            -> stdexec::__t<__item_sender<__decay_t<_Item>, _Value, _Op>> {
+          return {static_cast<_Item&&>(__item), __self.__op_};
+        }
+
+        template <__completion_tag _Tag, same_as<__t> _Self, class... _As>
+        friend void tag_invoke(_Tag, _Self&& __self, _As&&... __as) noexcept {
+          __self.__op_->__upstream_completed(_Tag{}, static_cast<_As&&>(__as)...);
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend auto tag_invoke(_GetEnv, const _Self& __self) noexcept -> _Env {
+          return stdexec::get_env(__self.__op_->__rcvr_);
+        }
+      };
+    };
+
+    template <class _Sender, class _ReceiverId, class _Deadline>
+    struct __operation {
+      using _Receiver = stdexec::__t<_ReceiverId>;
+      using _Env = env_of_t<_Receiver>;
+      using _Value = __value_t<_Sender, _Env>;
+
+      struct __t : __immovable {
+        using __id = __operation;
+        using __item_t = __item_base<_Value>;
+        using __receiver_t = stdexec::__t<__receiver<__t, _Env, _Value>>;
+        using __deliver_receiver_t = stdexec::__t<__deliver_receiver<__t, _Env>>;
+        using __timer_receiver_t = stdexec::__t<__timer_receiver<__t, _Env>>;
+        using __deliver_op_t = connect_result_t<
+          __next_sender_of_t<_Receiver, __batch_sender_t<_Sender, _Env>>,
+          __deliver_receiver_t>;
+
+        static constexpr bool __timed = !same_as<_Deadline, __no_deadline>;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _Receiver __rcvr_;
+        STDEXEC_NO_UNIQUE_ADDRESS _Deadline __deadline_;
+        std::size_t __n_;
+
+        std::mutex __mutex_{};
+        std::vector<_Value> __buffer_{};
+        // Items whose value arrived while a batch was being delivered.
+        __intrusive_queue<&__item_t::__next_> __waiting_{};
+        // The item that filled the batch that is being delivered. It completes
+        // once the delivery has completed.
+        __item_t* __resume_{nullptr};
+        bool __delivering_{false};
+        bool __stopped_{false};
+        bool __upstream_done_{false};
+        __result_variant_t<_Sender, _Env> __result_{};
+        std::optional<__deliver_op_t> __deliver_op_{};
+
+        // The number of the current batch. A timer only flushes the batch for
+        // which it was armed.
+        std::size_t __epoch_{0};
+        // When the first value of the current batch was added. The timer of a
+        // batch may only be armed after the timer of the previous one has
+        // expired, so its deadline is computed from this time.
+        STDEXEC_NO_UNIQUE_ADDRESS typename _Deadline::__time_point_t __batch_start_{};
+        std::size_t __timer_epoch_{0};
+        bool __timer_running_{false};
+        in_place_stop_source __timer_stop_source_{};
+        std::optional<stdexec::__t<__timer_op<_Deadline, __t, _Env>>> __timer_op_{};
+
+        subscribe_result_t<_Sender, __receiver_t> __op_;
+
+        __t(_Sender&& __sndr, _Receiver __rcvr, _Deadline __deadline, std::size_t __n)
+          : __rcvr_(static_cast<_Receiver&&>(__rcvr))
+          , __deadline_(static_cast<_Deadline&&>(__deadline))
+          , __n_(__n)
+          , __op_{exec::subscribe(static_cast<_Sender&&>(__sndr), __receiver_t{this})} {
+          STDEXEC_ASSERT(__n_ > 0);
+          stdexec::__trace_allocation("batch", __n_ * sizeof(_Value));
+          __buffer_.reserve(__n_);
+        }
+
+        // Must be called with the mutex held.
+        template <class _Tag, class... _As>
+        void __set_result_(_Tag, _As&&... __as) noexcept {
+          if (__result_.index() != 0) {
+            return;
+          }
+          try {
+            __result_.template emplace<__decayed_tuple<_Tag, _As...>>(
+              _Tag{}, static_cast<_As&&>(__as)...);
+          } catch (...) {
+            __result_.template emplace<std::tuple<set_error_t, std::exception_ptr>>(
+              set_error, std::current_exception());
+          }
+        }
+
+        // Must be called with the mutex held. Returns whether the batch is
+        // full and has to be delivered.
+        bool __append_(__item_t* __item) noexcept {
+          if constexpr (__timed) {
+            if (__buffer_.empty()) {
+              __batch_start_ = exec::now(__deadline_.__sched_);
+            }
+          }
+          __buffer_.push_back(std::move(*__item->__value_));
+          __item->__value_.reset();
+          return __buffer_.size() >= __n_;
+        }
+
+        // Must be called with the mutex held. Returns whether a timer has to
+        // be started for the current batch.
+        bool __arm_() noexcept {
+          if constexpr (__timed) {
+            if (!__timer_running_ && !__delivering_ && !__upstream_done_ && !__buffer_.empty()) {
+              __timer_running_ = true;
+              __timer_epoch_ = __epoch_;
+              return true;
+            }
+          }
+          return false;
+        }
+
+        // Must be called with the mutex held.
+        bool __is_done_() const noexcept {
+          return __upstream_done_ && !__delivering_ && !__timer_running_
+              && (__stopped_ || __buffer_.empty());
+        }
+
+        void __push(__item_t* __item) noexcept {
+          std::unique_lock __guard{__mutex_};
+          if (__stopped_) {
+            __guard.unlock();
+            __item->__complete(true);
+            return;
+          }
+          if (__delivering_) {
+            __waiting_.push_back(__item);
+            return;
+          }
+          if (__append_(__item)) {
+            __delivering_ = true;
+            __resume_ = __item;
+            __guard.unlock();
+            __deliver();
+            return;
+          }
+          const bool __arm = __arm_();
+          __guard.unlock();
+          if (__arm) {
+            __start_timer();
+          }
+          __item->__complete(false);
+        }
+
+        template <class _Tag, class... _As>
+        void __item_failed(__item_t* __item, _Tag, _As&&... __as) noexcept {
+          std::unique_lock __guard{__mutex_};
+          __set_result_(_Tag{}, static_cast<_As&&>(__as)...);
+          __stopped_ = true;
+          __guard.unlock();
+          __item->__complete(true);
+        }
+
+        void __deliver() noexcept {
+          try {
+            auto& __op = __deliver_op_.emplace(__conv{[&] {
+              return stdexec::connect(
+                exec::set_next(__rcvr_, just(std::span<_Value>{__buffer_})),
+                __deliver_receiver_t{this});
+            }});
+            stdexec::start(__op);
+          } catch (...) {
+            std::unique_lock __guard{__mutex_};
+            __set_result_(set_error, std::current_exception());
+            __guard.unlock();
+            __delivered(true);
+          }
+        }
+
+        void __delivered(bool __stop) noexcept {
+          std::unique_lock __guard{__mutex_};
+          __stopped_ = __stopped_ || __stop;
+          __buffer_.clear();
+          ++__epoch_;
+          __delivering_ = false;
+
+          __intrusive_queue<&__item_t::__next_> __completed{};
+          if (__resume_ != nullptr) {
+            __completed.push_back(std::exchange(__resume_, nullptr));
+          }
+          if (__stopped_) {
+            __completed.append(std::move(__waiting_));
+          } else {
+            while (!__waiting_.empty()) {
+              __item_t* __item = __waiting_.pop_front();
+              if (__append_(__item)) {
+                __delivering_ = true;
+                __resume_ = __item;
+                break;
+              }
+              __completed.push_back(__item);
+            }
+            // Flush the remaining values once the input sequence is done.
+            if (!__delivering_ && __upstream_done_ && !__buffer_.empty()) {
+              __delivering_ = true;
+            }
+          }
+          const bool __deliver_next = __delivering_;
+          const bool __arm = __arm_();
+          const bool __done = __is_done_();
+          const bool __stopped = __stopped_;
+          __guard.unlock();
+
+          while (!__completed.empty()) {
+            __completed.pop_front()->__complete(__stopped);
+          }
+          if (__deliver_next) {
+            __deliver();
+          } else if (__arm) {
+            __start_timer();
+          } else if (__done) {
+            __finish();
+          }
+        }
+
+        void __start_timer() noexcept {
+          if constexpr (__timed) {
+            try {
+              auto& __op = __timer_op_.emplace(__conv{[&] {
+                return stdexec::connect(
+                  exec::schedule_at(__deadline_.__sched_, __batch_start_ + __deadline_.__duration_),
+                  __timer_receiver_t{this});
+              }});
+              stdexec::start(__op);
+            } catch (...) {
+              // Without a timer the batch is flushed once it is full or the
+              // input sequence is done.
+              std::unique_lock __guard{__mutex_};
+              __timer_running_ = false;
+              const bool __done = __is_done_();
+              __guard.unlock();
+              if (__done) {
+                __finish();
+              }
+            }
+          }
+        }
+
+        void __timer_expired() noexcept {
+          std::unique_lock __guard{__mutex_};
+          __timer_running_ = false;
+          bool __deliver_now = false;
+          if (!__delivering_ && !__stopped_ && !__buffer_.empty()) {
+            if (__timer_epoch_ == __epoch_) {
+              __delivering_ = true;
+              __deliver_now = true;
+            }
+          }
+          // The timer may have been armed for a batch that was already full.
+          const bool __arm = __arm_();
+          const bool __done = __is_done_();
+          __guard.unlock();
+          if (__deliver_now) {
+            __deliver();
+          } else if (__arm) {
+            __start_timer();
+          } else if (__done) {
+            __finish();
+          }
+        }
+
+        template <class _Tag, class... _As>
+        void __upstream_completed(_Tag, _As&&... __as) noexcept {
+          std::unique_lock __guard{__mutex_};
+          __set_result_(_Tag{}, static_cast<_As&&>(__as)...);
+          __upstream_done_ = true;
+          bool __deliver_now = false;
+          if (!__delivering_ && !__stopped_ && !__buffer_.empty()) {
+            __delivering_ = true;
+            __deliver_now = true;
+          }
+          const bool __cancel_timer = __timer_running_;
+          const bool __done = __is_done_();
+          __guard.unlock();
+          // No timer is armed after the input sequence is done, so the stop
+          // source is not replaced while we request stop.
+          if (__cancel_timer) {
+            __timer_stop_source_.request_stop();
+          }
+          if (__deliver_now) {
+            __deliver();
+          } else if (__done) {
+            __finish();
+          }
+        }
+
+        void __finish() noexcept {
+          std::visit(
+            [&]<class _Tuple>(_Tuple& __tupl) noexcept -> void {
+              if constexpr (same_as<_Tuple, std::monostate>) {
+                stdexec::set_value(static_cast<_Receiver&&>(__rcvr_));
+              } else {
+                std::apply(
+                  [&]<class _Tag, class... _As>(_Tag __tag, _As&... __as) noexcept {
+                    __tag(static_cast<_Receiver&&>(__rcvr_), static_cast<_As&&>(__as)...);
+                  },
+                  __tupl);
+              }
+            },
+            __result_);
+        }
+
+        friend void tag_invoke(start_t, __t& __self) noexcept {
+          stdexec::start(__self.__op_);
+        }
+      };
+    };
+
+    template <class _SenderId, class _Deadline>
+    struct __sender {
+      using _Sender = stdexec::__t<_SenderId>;
+
+      template <class _Self, class _Receiver>
+      using __operation_t = stdexec::__t<
+        __operation<__copy_cvref_t<_Self, _Sender>, stdexec::__id<_Receiver>, _Deadline>>;
+
+      template <class _Self, class _Receiver>
+      using __receiver_t = stdexec::__t<__receiver<
+        __operation_t<_Self, _Receiver>,
+        env_of_t<_Receiver>,
+        __value_t<__copy_cvref_t<_Self, _Sender>, env_of_t<_Receiver>>>>;
+
+      struct __t {
+        using __id = __sender;
+        using is_sender = sequence_tag;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _Sender __sndr_;
+        STDEXEC_NO_UNIQUE_ADDRESS _Deadline __deadline_;
+        std::size_t __n_;
+
+        template <__decays_to<__t> _Self, receiver _Receiver>
+          requires sequence_receiver_of<
+                     _Receiver,
+                     __completion_sigs_t<__copy_cvref_t<_Self, _Sender>, env_of_t<_Receiver>>>
+                && sequence_sender_to<__copy_cvref_t<_Self, _Sender>, __receiver_t<_Self, _Receiver>>
+        friend auto tag_invoke(subscribe_t, _Self&& __self, _Receiver __rcvr)
+          -> __operation_t<_Self, _Receiver> {
+          return {
+            static_cast<_Self&&>(__self).__sndr_,
+            static_cast<_Receiver&&>(__rcvr),
+            static_cast<_Self&&>(__self).__deadline_,
+            __self.__n_};
+        }
+
+        template <__decays_to<__t> _Self, class _Env>
+        friend auto tag_invoke(get_completion_signatures_t, _Self&&, _Env&&)
+          -> __completion_sigs_t<__copy_cvref_t<_Self, _Sender>, _Env> {
+          return {};
+        }
+      };
+    };
+
+    struct batch_t {
+      template <sender _Sender>
+      auto operator()(_Sender&& __sndr, std::size_t __n) const
+        noexcept(__nothrow_decay_copyable<_Sender>)
+          -> stdexec::__t<__sender<stdexec::__id<__decay_t<_Sender>>, __no_deadline>> {
+        return {static_cast<_Sender&&>(__sndr), {}, __n};
+      }
+
+      constexpr auto operator()(std::size_t __n) const noexcept
+        -> __binder_back<batch_t, std::size_t> {
+        return {{}, {}, {__n}};
+      }
+    };
+
+    struct batch_for_t {
+      template <sender _Sender, timed_scheduler _Scheduler>
+      auto operator()(
+        _Sender&& __sndr,
+        _Scheduler __sched,
+        std::size_t __n,
+        duration_of_t<_Scheduler> __duration) const
+        -> stdexec::__t<__sender<stdexec::__id<__decay_t<_Sender>>, __deadline<_Scheduler>>> {
+        return {
+          static_cast<_Sender&&>(__sndr),
+          {static_cast<_Scheduler&&>(__sched), __duration},
+          __n};
+      }
+
+      template <timed_scheduler _Scheduler>
+      auto operator()(_Scheduler __sched, std::size_t __n, duration_of_t<_Scheduler> __duration)
+        const -> __binder_back<batch_for_t, _Scheduler, std::size_t, duration_of_t<_Scheduler>> {
+        return {{}, {}, {static_cast<_Scheduler&&>(__sched), __n, __duration}};
+      }
+    };
+  } // namespace __batch
+
+  using __batch::batch_t;
+  inline constexpr batch_t batch{};
+
+  using __batch::batch_for_t;
+  inline constexpr batch_for_t batch_for{};
+} // namespace exec
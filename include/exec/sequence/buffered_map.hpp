@@ -0,0 +1,678 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../sequence_senders.hpp"
+#include "../../stdexec/__detail/__intrusive_queue.hpp"
+
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace exec {
+  /////////////////////////////////////////////////////////////////////////////
+  // buffered_map(sequence, scheduler, n, fun)
+  //
+  // Applies fun to the values of every item of the input sequence on the given
+  // scheduler, with up to n applications in flight at the same time. The
+  // sequence operation owns n slots; an item of the input sequence is only
+  // accepted once a slot is available, which provides backpressure to the
+  // producer. Results are emitted downstream one at a time, either in input
+  // order (buffered_map) or in completion order (buffered_map_unordered).
+  namespace __buffered_map {
+    using namespace stdexec;
+
+    template <class _Ret, class... _Args>
+    __decayed_tuple<_Ret, _Args...> __signature_to_tuple_(_Ret (*)(_Args...));
+
+    template <class _Sig>
+    using __signature_to_tuple_t = decltype(__signature_to_tuple_((_Sig*) nullptr));
+
+    template <class _Sigs>
+    using __sigs_variant_t = //
+      __mapply<__transform<__q<__signature_to_tuple_t>, __nullable_variant_t>, _Sigs>;
+
+    template <class _Ty>
+    struct __value_sig_ {
+      using __t = set_value_t(_Ty);
+    };
+
+    template <>
+    struct __value_sig_<void> {
+      using __t = set_value_t();
+    };
+
+    template <class _Fun>
+    struct __result_value {
+      template <class... _Args>
+      using __f = completion_signatures<
+        stdexec::__t<__value_sig_<__decay_t<__call_result_t<_Fun&, __decay_t<_Args>&...>>>>>;
+    };
+
+    template <class _Sender, class _Env>
+    using __no_values_t = //
+      make_completion_signatures<
+        _Sender,
+        _Env,
+        completion_signatures<>,
+        __mconst<completion_signatures<>>::__f>;
+
+    // The completions of the items of the resulting sequence.
+    template <class _Sender, class _Env, class _Scheduler, class _Fun>
+    using __result_sigs_t = //
+      make_completion_signatures<
+        _Sender,
+        _Env,
+        __concat_completion_signatures_t<
+          completion_signatures<set_error_t(std::exception_ptr)>,
+          __no_values_t<schedule_result_t<_Scheduler&>, _Env>>,
+        __result_value<_Fun>::template __f>;
+
+    // An item that waits for a slot. The slot is passed type-erased so that the
+    // item operation does not depend on the (incomplete) sequence operation.
+    struct __acquire_base {
+      using __acquire_fn = void(__acquire_base*, void*) noexcept;
+
+      __acquire_base* __next_{};
+      __acquire_fn* __acquired_{};
+    };
+
+    // The item sender that is passed downstream. It replays the result stored
+    // in a slot.
+    template <class _Slot, class _ReceiverId>
+    struct __result_operation {
+      using _Receiver = stdexec::__t<_ReceiverId>;
+
+      struct __t {
+        using __id = __result_operation;
+        _Slot* __slot_;
+        STDEXEC_NO_UNIQUE_ADDRESS _Receiver __rcvr_;
+
+        friend void tag_invoke(start_t, __t& __self) noexcept {
+          std::visit(
+            [&]<class _Tuple>(_Tuple& __tupl) noexcept -> void {
+              if constexpr (same_as<_Tuple, std::monostate>) {
+                STDEXEC_UNREACHABLE();
+              } else {
+                std::apply(
+                  [&]<class _Tag, class... _As>(_Tag __tag, _As&... __as) noexcept {
+                    __tag(static_cast<_Receiver&&>(__self.__rcvr_), static_cast<_As&&>(__as)...);
+                  },
+                  __tupl);
+              }
+            },
+            __self.__slot_->__result_);
+        }
+      };
+    };
+
+    template <class _Slot, class _Sigs>
+    struct __result_sender {
+      struct __t {
+        using __id = __result_sender;
+        using is_sender = void;
+        using completion_signatures = _Sigs;
+
+        _Slot* __slot_;
+
+        template <same_as<__t> _Self, receiver_of<completion_signatures> _Receiver>
+        friend auto tag_invoke(connect_t, _Self&& __self, _Receiver __rcvr) //
+          noexcept(__nothrow_decay_copyable<_Receiver>)
+            -> stdexec::__t<__result_operation<_Slot, stdexec::__id<_Receiver>>> {
+          return {__self.__slot_, static_cast<_Receiver&&>(__rcvr)};
+        }
+      };
+    };
+
+    // Completes the work on a slot once the scheduler has picked it up.
+    template <class _Slot, class _Env>
+    struct __work_receiver {
+      struct __t {
+        using __id = __work_receiver;
+        using is_receiver = void;
+        _Slot* __slot_;
+
+        template <same_as<set_value_t> _SetValue, same_as<__t> _Self>
+        friend void tag_invoke(_SetValue, _Self&& __self) noexcept {
+          __self.__slot_->__op_->__invoke(__self.__slot_);
+        }
+
+        template <__one_of<set_error_t, set_stopped_t> _Tag, same_as<__t> _Self, class... _Error>
+        friend void tag_invoke(_Tag, _Self&& __self, _Error&&... __err) noexcept {
+          __self.__slot_->__op_->__set_result(
+            __self.__slot_, _Tag{}, static_cast<_Error&&>(__err)...);
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend auto tag_invoke(_GetEnv, const _Self& __self) noexcept
+          -> _Env {
+          return stdexec::get_env(__self.__slot_->__op_->__rcvr_);
+        }
+      };
+    };
+
+    // Receives the completion of the next-sender returned from the
+    // downstream receiver for a delivered result.
+    template <class _Slot, class _Env>
+    struct __deliver_receiver {
+      struct __t {
+        using __id = __deliver_receiver;
+        using is_receiver = void;
+        _Slot* __slot_;
+
+        template <same_as<set_value_t> _SetValue, same_as<__t> _Self>
+        friend void tag_invoke(_SetValue, _Self&& __self) noexcept {
+          __self.__slot_->__op_->__release(__self.__slot_, false);
+        }
+
+        template <same_as<set_stopped_t> _SetStopped, same_as<__t> _Self>
+        friend void tag_invoke(_SetStopped, _Self&& __self) noexcept {
+          __self.__slot_->__op_->__release(__self.__slot_, true);
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend auto tag_invoke(_GetEnv, const _Self& __self) noexcept
+          -> _Env {
+          return stdexec::get_env(__self.__slot_->__op_->__rcvr_);
+        }
+      };
+    };
+
+    template <class _ItemOp, class _Env>
+    struct __item_receiver {
+      struct __t {
+        using __id = __item_receiver;
+        using is_receiver = void;
+        _ItemOp* __op_;
+
+        template <__completion_tag _Tag, same_as<__t> _Self, class... _As>
+        friend void tag_invoke(_Tag, _Self&& __self, _As&&... __as) noexcept {
+          __self.__op_->__item_completed(_Tag{}, static_cast<_As&&>(__as)...);
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend auto tag_invoke(_GetEnv, const _Self& __self) noexcept
+          -> _Env {
+          return stdexec::get_env(__self.__op_->__next_rcvr_);
+        }
+      };
+    };
+
+    // The operation of the next-sender handed back to the input sequence. It
+    // waits for a free slot, runs the item to obtain its values and completes
+    // as soon as the work on the slot has been scheduled.
+    template <class _Item, class _Op, class _NextRcvr>
+    struct __item_operation {
+      struct __t : __acquire_base {
+        using __id = __item_operation;
+        using __next_receiver_t = _NextRcvr;
+        using __item_receiver_t = stdexec::__t<__item_receiver<__t, env_of_t<_NextRcvr>>>;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _NextRcvr __next_rcvr_;
+        _Op* __parent_;
+        void* __slot_{};
+        connect_result_t<_Item, __item_receiver_t> __item_op_;
+
+        __t(_Item&& __item, _NextRcvr __next_rcvr, _Op* __parent)
+          : __acquire_base{nullptr, &__acquired}
+          , __next_rcvr_(static_cast<_NextRcvr&&>(__next_rcvr))
+          , __parent_(__parent)
+          , __item_op_(stdexec::connect(static_cast<_Item&&>(__item), __item_receiver_t{this})) {
+        }
+
+        static void __acquired(__acquire_base* __base, void* __slot) noexcept {
+          __t* __self = static_cast<__t*>(__base);
+          if (__slot == nullptr) {
+            // The downstream receiver asked us to stop.
+            stdexec::set_stopped(static_cast<_NextRcvr&&>(__self->__next_rcvr_));
+          } else {
+            __self->__slot_ = __slot;
+            stdexec::start(__self->__item_op_);
+          }
+        }
+
+        template <class _Tag, class... _As>
+        void __item_completed(_Tag, _As&&... __as) noexcept {
+          __parent_->__item_completed(__slot_, _Tag{}, static_cast<_As&&>(__as)...);
+          stdexec::set_value(static_cast<_NextRcvr&&>(__next_rcvr_));
+        }
+
+        friend void tag_invoke(start_t, __t& __self) noexcept {
+          __self.__parent_->__acquire(&__self);
+        }
+      };
+    };
+
+    template <class _Item, class _Op>
+    struct __item_sender {
+      struct __t {
+        using __id = __item_sender;
+        using is_sender = void;
+        using completion_signatures = stdexec::completion_signatures<set_value_t(), set_stopped_t()>;
+
+        template <class _Self, class _NextRcvr>
+        using __operation_t =
+          stdexec::__t<__item_operation<__copy_cvref_t<_Self, _Item>, _Op, _NextRcvr>>;
+
+        _Item __item_;
+        _Op* __parent_;
+
+        template <__decays_to<__t> _Self, receiver_of<completion_signatures> _NextRcvr>
+        friend auto tag_invoke(connect_t, _Self&& __self, _NextRcvr __rcvr)
+          -> __operation_t<_Self, _NextRcvr> {
+          return {
+            static_cast<_Self&&>(__self).__item_, static_cast<_NextRcvr&&>(__rcvr), __self.__parent_};
+        }
+      };
+    };
+
+    template <class _Op, class _Env>
+    struct __receiver {
+      struct __t {
+        using __id = __receiver;
+        using is_receiver = void;
+        _Op* __op_;
+
+        template <same_as<set_next_t> _SetNext, same_as<__t> _Self, sender _Item>
+        friend auto tag_invoke(_SetNext, _Self& __self, _Item&& __item) //
+          noexcept(__nothrow_decay_copyable<_Item>)
+            -> stdexec::__t<__item_sender<__decay_t<_Item>, _Op>> {
+          return {static_cast<_Item&&>(__item), __self.__op_};
+        }
+
+        template <__completion_tag _Tag, same_as<__t> _Self, class... _As>
+        friend void tag_invoke(_Tag, _Self&& __self, _As&&... __as) noexcept {
+          __self.__op_->__upstream_completed(_Tag{}, static_cast<_As&&>(__as)...);
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend auto tag_invoke(_GetEnv, const _Self& __self) noexcept
+          -> _Env {
+          return stdexec::get_env(__self.__op_->__rcvr_);
+        }
+      };
+    };
+
+    template <class _Sender, class _ReceiverId, class _Scheduler, class _Fun, bool _Ordered>
+    struct __operation {
+      using _Receiver = stdexec::__t<_ReceiverId>;
+      using _Env = env_of_t<_Receiver>;
+
+      struct __t : __immovable {
+        using __id = __operation;
+        using __receiver_type = _Receiver;
+        using __values_t = __value_types_of_t<_Sender, _Env, __q<__decayed_tuple>, __nullable_variant_t>;
+        using __result_sigs = __result_sigs_t<_Sender, _Env, _Scheduler, _Fun>;
+        using __result_t = __sigs_variant_t<__result_sigs>;
+        using __upstream_result_t =
+          __sigs_variant_t<__sequence_completion_signatures_of_t<_Sender, _Env>>;
+
+        struct __slot_t {
+          using __work_receiver_t = stdexec::__t<__work_receiver<__slot_t, _Env>>;
+          using __deliver_receiver_t = stdexec::__t<__deliver_receiver<__slot_t, _Env>>;
+          using __result_sender_t = stdexec::__t<__result_sender<__slot_t, __result_sigs>>;
+
+          __slot_t* __next_{};
+          __t* __op_{};
+          bool __ready_{false};
+          __values_t __values_{};
+          __result_t __result_{};
+          std::optional<connect_result_t<schedule_result_t<_Scheduler&>, __work_receiver_t>>
+            __work_op_{};
+          std::optional<
+            connect_result_t<__next_sender_of_t<_Receiver, __result_sender_t>, __deliver_receiver_t>>
+            __deliver_op_{};
+        };
+
+        using __receiver_t = stdexec::__t<__receiver<__t, _Env>>;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _Receiver __rcvr_;
+        STDEXEC_NO_UNIQUE_ADDRESS _Scheduler __sched_;
+        STDEXEC_NO_UNIQUE_ADDRESS _Fun __fun_;
+        std::size_t __n_;
+        std::unique_ptr<__slot_t[]> __slots_;
+
+        std::mutex __mutex_{};
+        // The number of slots handed out and handed back. Their difference is
+        // the number of items in flight.
+        std::size_t __issued_{0};
+        std::size_t __released_{0};
+        __intrusive_queue<&__slot_t::__next_> __free_{};
+        __intrusive_queue<&__slot_t::__next_> __ready_{};
+        __intrusive_queue<&__acquire_base::__next_> __waiting_{};
+        bool __delivering_{false};
+        bool __stopped_{false};
+        bool __upstream_done_{false};
+        __upstream_result_t __upstream_result_{};
+
+        subscribe_result_t<_Sender, __receiver_t> __op_;
+
+        __t(_Sender&& __sndr, _Receiver __rcvr, _Scheduler __sched, std::size_t __n, _Fun __fun)
+          : __rcvr_(static_cast<_Receiver&&>(__rcvr))
+          , __sched_(static_cast<_Scheduler&&>(__sched))
+          , __fun_(static_cast<_Fun&&>(__fun))
+          , __n_(__n)
+          , __slots_(new __slot_t[__n])
+          , __op_{exec::subscribe(static_cast<_Sender&&>(__sndr), __receiver_t{this})} {
+          STDEXEC_ASSERT(__n_ > 0);
+          stdexec::__trace_allocation("buffered_map", __n_ * sizeof(__slot_t));
+          for (std::size_t __i = 0; __i < __n_; ++__i) {
+            __slots_[__i].__op_ = this;
+            if constexpr (!_Ordered) {
+              __free_.push_back(&__slots_[__i]);
+            }
+          }
+        }
+
+        ~__t() {
+          // The intrusive queues assert that they are empty on destruction.
+          while (!__free_.empty()) {
+            (void) __free_.pop_front();
+          }
+        }
+
+        // Must be called with the mutex held.
+        __slot_t* __try_acquire_() noexcept {
+          if constexpr (_Ordered) {
+            // Results are delivered, and slots released, in the order in which
+            // slots were handed out, so the slots can be used round-robin.
+            if (__issued_ - __released_ == __n_) {
+              return nullptr;
+            }
+            return &__slots_[__issued_++ % __n_];
+          } else {
+            if (__free_.empty()) {
+              return nullptr;
+            }
+            ++__issued_;
+            return __free_.pop_front();
+          }
+        }
+
+        // Must be called with the mutex held and no delivery in progress.
+        __slot_t* __try_pop_ready_() noexcept {
+          if constexpr (_Ordered) {
+            __slot_t* __next = &__slots_[__released_ % __n_];
+            return __released_ != __issued_ && __next->__ready_ ? __next : nullptr;
+          } else {
+            return __ready_.empty() ? nullptr : __ready_.pop_front();
+          }
+        }
+
+        // Must be called with the mutex held.
+        bool __is_done_() const noexcept {
+          return __upstream_done_ && !__delivering_ && __issued_ == __released_;
+        }
+
+        void __acquire(__acquire_base* __waiter) noexcept {
+          std::unique_lock __guard{__mutex_};
+          if (__stopped_) {
+            __guard.unlock();
+            __waiter->__acquired_(__waiter, nullptr);
+            return;
+          }
+          __slot_t* __slot = __try_acquire_();
+          if (__slot == nullptr) {
+            __waiting_.push_back(__waiter);
+            return;
+          }
+          __guard.unlock();
+          __waiter->__acquired_(__waiter, __slot);
+        }
+
+        template <class _Tag, class... _As>
+        void __item_completed(void* __slot, _Tag, _As&&... __as) noexcept {
+          if constexpr (same_as<_Tag, set_value_t>) {
+            __schedule(static_cast<__slot_t*>(__slot), static_cast<_As&&>(__as)...);
+          } else {
+            __set_result(static_cast<__slot_t*>(__slot), _Tag{}, static_cast<_As&&>(__as)...);
+          }
+        }
+
+        template <class... _As>
+        void __schedule(__slot_t* __slot, _As&&... __as) noexcept {
+          try {
+            __slot->__values_.template emplace<__decayed_tuple<_As...>>(static_cast<_As&&>(__as)...);
+            auto& __op = __slot->__work_op_.emplace(__conv{[&] {
+              return stdexec::connect(
+                stdexec::schedule(__sched_), typename __slot_t::__work_receiver_t{__slot});
+            }});
+            stdexec::start(__op);
+          } catch (...) {
+            __set_result(__slot, set_error, std::current_exception());
+          }
+        }
+
+        void __invoke(__slot_t* __slot) noexcept {
+          std::visit(
+            [&]<class _Tuple>(_Tuple& __values) noexcept {
+              if constexpr (same_as<_Tuple, std::monostate>) {
+                STDEXEC_UNREACHABLE();
+              } else {
+                try {
+                  using __result_t = decltype(std::apply(__fun_, __values));
+                  if constexpr (same_as<__result_t, void>) {
+                    std::apply(__fun_, __values);
+                    __slot->__result_.template emplace<std::tuple<set_value_t>>();
+                  } else {
+                    __slot->__result_.template emplace<__decayed_tuple<set_value_t, __result_t>>(
+                      set_value, std::apply(__fun_, __values));
+                  }
+                } catch (...) {
+                  __slot->__result_.template emplace<std::tuple<set_error_t, std::exception_ptr>>(
+                    set_error, std::current_exception());
+                }
+              }
+            },
+            __slot->__values_);
+          __complete(__slot);
+        }
+
+        template <class _Tag, class... _As>
+        void __set_result(__slot_t* __slot, _Tag, _As&&... __as) noexcept {
+          __slot->__result_.template emplace<__decayed_tuple<_Tag, _As...>>(
+            _Tag{}, static_cast<_As&&>(__as)...);
+          __complete(__slot);
+        }
+
+        void __complete(__slot_t* __slot) noexcept {
+          std::unique_lock __guard{__mutex_};
+          __slot->__ready_ = true;
+          if constexpr (!_Ordered) {
+            __ready_.push_back(__slot);
+          }
+          if (__delivering_) {
+            return;
+          }
+          __slot = __try_pop_ready_();
+          __delivering_ = __slot != nullptr;
+          __guard.unlock();
+          if (__slot != nullptr) {
+            __deliver(__slot);
+          }
+        }
+
+        void __deliver(__slot_t* __slot) noexcept {
+          if (!__stopped_) {
+            try {
+              auto& __op = __slot->__deliver_op_.emplace(__conv{[&] {
+                return stdexec::connect(
+                  exec::set_next(__rcvr_, typename __slot_t::__result_sender_t{__slot}),
+                  typename __slot_t::__deliver_receiver_t{__slot});
+              }});
+              stdexec::start(__op);
+              return;
+            } catch (...) {
+            }
+          }
+          __release(__slot, true);
+        }
+
+        void __release(__slot_t* __slot, bool __stop) noexcept {
+          std::unique_lock __guard{__mutex_};
+          __stopped_ = __stopped_ || __stop;
+          __slot->__ready_ = false;
+          ++__released_;
+          if constexpr (!_Ordered) {
+            __free_.push_back(__slot);
+          }
+
+          // Hand a slot to the first item that is waiting for one, or tell all
+          // waiting items to stop.
+          __intrusive_queue<&__acquire_base::__next_> __waiters{};
+          __slot_t* __handed_out{};
+          if (__stopped_) {
+            __waiters = std::move(__waiting_);
+          } else if (!__waiting_.empty()) {
+            __handed_out = __try_acquire_();
+            __waiters.push_back(__waiting_.pop_front());
+          }
+
+          __slot = __try_pop_ready_();
+          __delivering_ = __slot != nullptr;
+          const bool __done = __is_done_();
+          __guard.unlock();
+
+          while (!__waiters.empty()) {
+            __acquire_base* __waiter = __waiters.pop_front();
+            __waiter->__acquired_(__waiter, __handed_out);
+          }
+          if (__slot != nullptr) {
+            __deliver(__slot);
+          } else if (__done) {
+            __finish();
+          }
+        }
+
+        template <class _Tag, class... _As>
+        void __upstream_completed(_Tag, _As&&... __as) noexcept {
+          try {
+            __upstream_result_.template emplace<__decayed_tuple<_Tag, _As...>>(
+              _Tag{}, static_cast<_As&&>(__as)...);
+          } catch (...) {
+            __upstream_result_.template emplace<std::tuple<set_error_t, std::exception_ptr>>(
+              set_error, std::current_exception());
+          }
+          std::unique_lock __guard{__mutex_};
+          __upstream_done_ = true;
+          const bool __done = __is_done_();
+          __guard.unlock();
+          if (__done) {
+            __finish();
+          }
+        }
+
+        void __finish() noexcept {
+          std::visit(
+            [&]<class _Tuple>(_Tuple& __tupl) noexcept -> void {
+              if constexpr (same_as<_Tuple, std::monostate>) {
+                STDEXEC_UNREACHABLE();
+              } else {
+                std::apply(
+                  [&]<class _Tag, class... _As>(_Tag __tag, _As&... __as) noexcept {
+                    __tag(static_cast<_Receiver&&>(__rcvr_), static_cast<_As&&>(__as)...);
+                  },
+                  __tupl);
+              }
+            },
+            __upstream_result_);
+        }
+
+        friend void tag_invoke(start_t, __t& __self) noexcept {
+          stdexec::start(__self.__op_);
+        }
+      };
+    };
+
+    template <class _SenderId, class _Scheduler, class _Fun, bool _Ordered>
+    struct __sender {
+      using _Sender = stdexec::__t<_SenderId>;
+
+      template <class _Self, class _Receiver>
+      using __operation_t = stdexec::__t<__operation<
+        __copy_cvref_t<_Self, _Sender>,
+        stdexec::__id<_Receiver>,
+        _Scheduler,
+        _Fun,
+        _Ordered>>;
+
+      template <class _Self, class _Receiver>
+      using __receiver_t =
+        stdexec::__t<__receiver<__operation_t<_Self, _Receiver>, env_of_t<_Receiver>>>;
+
+      template <class _Self, class _Env>
+      using __completion_sigs_t = __result_sigs_t<__copy_cvref_t<_Self, _Sender>, _Env, _Scheduler, _Fun>;
+
+      struct __t {
+        using __id = __sender;
+        using is_sender = sequence_tag;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _Sender __sndr_;
+        STDEXEC_NO_UNIQUE_ADDRESS _Scheduler __sched_;
+        std::size_t __n_;
+        STDEXEC_NO_UNIQUE_ADDRESS _Fun __fun_;
+
+        template <__decays_to<__t> _Self, receiver _Receiver>
+          requires sequence_receiver_of<_Receiver, __completion_sigs_t<_Self, env_of_t<_Receiver>>>
+                && sequence_sender_to<__copy_cvref_t<_Self, _Sender>, __receiver_t<_Self, _Receiver>>
+        friend auto tag_invoke(subscribe_t, _Self&& __self, _Receiver __rcvr)
+          -> __operation_t<_Self, _Receiver> {
+          return {
+            static_cast<_Self&&>(__self).__sndr_,
+            static_cast<_Receiver&&>(__rcvr),
+            static_cast<_Self&&>(__self).__sched_,
+            __self.__n_,
+            static_cast<_Self&&>(__self).__fun_};
+        }
+
+        template <__decays_to<__t> _Self, class _Env>
+        friend auto tag_invoke(get_completion_signatures_t, _Self&&, _Env&&)
+          -> __completion_sigs_t<_Self, _Env> {
+          return {};
+        }
+      };
+    };
+
+    template <bool _Ordered>
+    struct __buffered_map_t {
+      template <sender _Sender, scheduler _Scheduler, __movable_value _Fun>
+      auto operator()(_Sender&& __sndr, _Scheduler&& __sched, std::size_t __n, _Fun __fun) const
+        -> stdexec::__t<
+          __sender<stdexec::__id<__decay_t<_Sender>>, __decay_t<_Scheduler>, _Fun, _Ordered>> {
+        return {
+          static_cast<_Sender&&>(__sndr),
+          static_cast<_Scheduler&&>(__sched),
+          __n,
+          static_cast<_Fun&&>(__fun)};
+      }
+
+      template <scheduler _Scheduler, __movable_value _Fun>
+      auto operator()(_Scheduler&& __sched, std::size_t __n, _Fun __fun) const
+        -> __binder_back<__buffered_map_t, __decay_t<_Scheduler>, std::size_t, _Fun> {
+        return {{}, {}, {static_cast<_Scheduler&&>(__sched), __n, static_cast<_Fun&&>(__fun)}};
+      }
+    };
+
+    using buffered_map_t = __buffered_map_t<true>;
+    using buffered_map_unordered_t = __buffered_map_t<false>;
+  } // namespace __buffered_map
+
+  using __buffered_map::buffered_map_t;
+  inline constexpr buffered_map_t buffered_map{};
+
+  using __buffered_map::buffered_map_unordered_t;
+  inline constexpr buffered_map_unordered_t buffered_map_unordered{};
+} // namespace exec
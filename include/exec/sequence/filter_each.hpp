@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../sequence_senders.hpp"
+
+namespace exec {
+  namespace __filter_each {
+    using namespace stdexec;
+
+    // Every completion of an item is re-emitted downstream as a sender that
+    // replays it. Values are only re-emitted if they satisfy the predicate.
+    template <class _Sig>
+    struct __replay_;
+
+    template <class... _As>
+    struct __replay_<set_value_t(_As...)> {
+      using __t = __call_result_t<decltype(just), __decay_t<_As>...>;
+    };
+
+    template <class _Error>
+    struct __replay_<set_error_t(_Error)> {
+      using __t = __call_result_t<decltype(just_error), __decay_t<_Error>>;
+    };
+
+    template <>
+    struct __replay_<set_stopped_t()> {
+      using __t = __call_result_t<decltype(just_stopped)>;
+    };
+
+    template <class _Sig>
+    using __replay_t = stdexec::__t<__replay_<_Sig>>;
+
+    template <class _Sender, class _Env>
+    using __item_sigs_t = //
+      __concat_completion_signatures_t<
+        completion_signatures_of_t<_Sender, _Env>,
+        completion_signatures<set_error_t(std::exception_ptr)>>;
+
+    template <class _Receiver, class _Pred>
+    struct __operation_base {
+      STDEXEC_NO_UNIQUE_ADDRESS _Receiver __receiver_;
+      STDEXEC_NO_UNIQUE_ADDRESS _Pred __pred_;
+    };
+
+    template <class _ItemOp>
+    struct __next_receiver {
+      struct __t {
+        using __id = __next_receiver;
+        using is_receiver = void;
+        _ItemOp* __op_;
+
+        template <same_as<set_value_t> _SetValue, same_as<__t> _Self>
+        friend void tag_invoke(_SetValue, _Self&& __self) noexcept {
+          stdexec::set_value(static_cast<_Self&&>(__self).__op_->__complete());
+        }
+
+        template <same_as<set_stopped_t> _SetStopped, same_as<__t> _Self>
+        friend void tag_invoke(_SetStopped, _Self&& __self) noexcept {
+          stdexec::set_stopped(static_cast<_Self&&>(__self).__op_->__complete());
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend auto tag_invoke(_GetEnv, const _Self& __self) noexcept
+          -> env_of_t<typename _ItemOp::__next_receiver_t> {
+          return stdexec::get_env(__self.__op_->__next_rcvr_);
+        }
+      };
+    };
+
+    template <class _ItemOp>
+    struct __item_receiver {
+      struct __t {
+        using __id = __item_receiver;
+        using is_receiver = void;
+        _ItemOp* __op_;
+
+        template <__completion_tag _Tag, same_as<__t> _Self, class... _As>
+        friend void tag_invoke(_Tag, _Self&& __self, _As&&... __as) noexcept {
+          __self.__op_->__item_completed(_Tag{}, static_cast<_As&&>(__as)...);
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend auto tag_invoke(_GetEnv, const _Self& __self) noexcept
+          -> env_of_t<typename _ItemOp::__next_receiver_t> {
+          return stdexec::get_env(__self.__op_->__next_rcvr_);
+        }
+      };
+    };
+
+    template <class _Item, class _Receiver, class _Pred, class _NextRcvr>
+    struct __item_operation {
+      struct __t {
+        using __id = __item_operation;
+        using __next_receiver_t = _NextRcvr;
+        using __item_receiver_t = stdexec::__t<__item_receiver<__t>>;
+        using __downstream_receiver_t = stdexec::__t<__next_receiver<__t>>;
+
+        template <class _Sig>
+        using __downstream_op_t = //
+          connect_result_t<__next_sender_of_t<_Receiver, __replay_t<_Sig>>, __downstream_receiver_t>;
+
+        using __downstream_ops_t = //
+          __mapply<
+            __transform<__q<__downstream_op_t>, __nullable_variant_t>,
+            __item_sigs_t<_Item, env_of_t<_NextRcvr>>>;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _NextRcvr __next_rcvr_;
+        __operation_base<_Receiver, _Pred>* __parent_;
+        connect_result_t<_Item, __item_receiver_t> __item_op_;
+        __downstream_ops_t __downstream_op_{};
+
+        __t(_Item&& __item, _NextRcvr __next_rcvr, __operation_base<_Receiver, _Pred>* __parent)
+          : __next_rcvr_(static_cast<_NextRcvr&&>(__next_rcvr))
+          , __parent_(__parent)
+          , __item_op_(stdexec::connect(static_cast<_Item&&>(__item), __item_receiver_t{this})) {
+        }
+
+        _NextRcvr&& __complete() noexcept {
+          return static_cast<_NextRcvr&&>(__next_rcvr_);
+        }
+
+        template <class _Tag, class _Factory, class... _As>
+        void __replay(_Factory __factory, _As&&... __as) {
+          using __op_t = __downstream_op_t<_Tag(_As...)>;
+          auto& __op = __downstream_op_.template emplace<__op_t>(__conv{[&] {
+            return stdexec::connect(
+              exec::set_next(__parent_->__receiver_, __factory(static_cast<_As&&>(__as)...)),
+              __downstream_receiver_t{this});
+          }});
+          stdexec::start(__op);
+        }
+
+        template <class _Tag, class... _As>
+        void __item_completed(_Tag, _As&&... __as) noexcept {
+          try {
+            if constexpr (same_as<_Tag, set_value_t>) {
+              if (!std::invoke(__parent_->__pred_, std::as_const(__as)...)) {
+                stdexec::set_value(static_cast<_NextRcvr&&>(__next_rcvr_));
+                return;
+              }
+              __replay<set_value_t>(just, static_cast<_As&&>(__as)...);
+            } else if constexpr (same_as<_Tag, set_error_t>) {
+              __replay<set_error_t>(just_error, static_cast<_As&&>(__as)...);
+            } else {
+              __replay<set_stopped_t>(just_stopped);
+            }
+          } catch (...) {
+            try {
+              __replay<set_error_t>(just_error, std::current_exception());
+            } catch (...) {
+              stdexec::set_stopped(static_cast<_NextRcvr&&>(__next_rcvr_));
+            }
+          }
+        }
+
+        friend void tag_invoke(start_t, __t& __self) noexcept {
+          stdexec::start(__self.__item_op_);
+        }
+      };
+    };
+
+    template <class _Item, class _Receiver, class _Pred>
+    struct __item_sender {
+      struct __t {
+        using __id = __item_sender;
+        using is_sender = void;
+        using completion_signatures = stdexec::completion_signatures<set_value_t(), set_stopped_t()>;
+
+        template <class _Self, class _NextRcvr>
+        using __operation_t = //
+          stdexec::__t<__item_operation<__copy_cvref_t<_Self, _Item>, _Receiver, _Pred, _NextRcvr>>;
+
+        _Item __item_;
+        __operation_base<_Receiver, _Pred>* __parent_;
+
+        template <__decays_to<__t> _Self, receiver_of<completion_signatures> _NextRcvr>
+        friend auto tag_invoke(connect_t, _Self&& __self, _NextRcvr __rcvr)
+          -> __operation_t<_Self, _NextRcvr> {
+          return {
+            static_cast<_Self&&>(__self).__item_, static_cast<_NextRcvr&&>(__rcvr), __self.__parent_};
+        }
+      };
+    };
+
+    template <class _ReceiverId, class _Pred>
+    struct __receiver {
+      using _Receiver = stdexec::__t<_ReceiverId>;
+
+      struct __t {
+        using __id = __receiver;
+        using is_receiver = void;
+        __operation_base<_Receiver, _Pred>* __op_;
+
+        template <same_as<set_next_t> _SetNext, same_as<__t> _Self, sender _Item>
+        friend auto tag_invoke(_SetNext, _Self& __self, _Item&& __item) //
+          noexcept(__nothrow_decay_copyable<_Item>)
+            -> stdexec::__t<__item_sender<__decay_t<_Item>, _Receiver, _Pred>> {
+          return {static_cast<_Item&&>(__item), __self.__op_};
+        }
+
+        template <same_as<set_value_t> _SetValue, same_as<__t> _Self>
+        friend void tag_invoke(_SetValue, _Self&& __self) noexcept {
+          stdexec::set_value(static_cast<_Receiver&&>(__self.__op_->__receiver_));
+        }
+
+        template <same_as<set_stopped_t> _SetStopped, same_as<__t> _Self>
+          requires __callable<set_stopped_t, _Receiver&&>
+        friend void tag_invoke(_SetStopped, _Self&& __self) noexcept {
+          stdexec::set_stopped(static_cast<_Receiver&&>(__self.__op_->__receiver_));
+        }
+
+        template <same_as<set_error_t> _SetError, same_as<__t> _Self, class _Error>
+          requires __callable<set_error_t, _Receiver&&, _Error>
+        friend void tag_invoke(_SetError, _Self&& __self, _Error&& __error) noexcept {
+          stdexec::set_error(
+            static_cast<_Receiver&&>(__self.__op_->__receiver_), static_cast<_Error&&>(__error));
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend env_of_t<_Receiver> tag_invoke(_GetEnv, const _Self& __self) noexcept {
+          return stdexec::get_env(__self.__op_->__receiver_);
+        }
+      };
+    };
+
+    template <class _Sender, class _ReceiverId, class _Pred>
+    struct __operation {
+      using _Receiver = stdexec::__t<_ReceiverId>;
+
+      struct __t : __operation_base<_Receiver, _Pred> {
+        using __id = __operation;
+        using __receiver_t = stdexec::__t<__receiver<_ReceiverId, _Pred>>;
+
+        subscribe_result_t<_Sender, __receiver_t> __op_;
+
+        __t(_Sender&& __sndr, _Receiver __rcvr, _Pred __pred)
+          : __operation_base<_Receiver, _Pred>{
+            static_cast<_Receiver&&>(__rcvr),
+            static_cast<_Pred&&>(__pred)}
+          , __op_{exec::subscribe(static_cast<_Sender&&>(__sndr), __receiver_t{this})} {
+        }
+
+        friend void tag_invoke(start_t, __t& __self) noexcept {
+          stdexec::start(__self.__op_);
+        }
+      };
+    };
+
+    template <class _SenderId, class _Pred>
+    struct __sender {
+      using _Sender = stdexec::__t<_SenderId>;
+
+      template <class _Self, class _Receiver>
+      using __operation_t = stdexec::__t<
+        __operation<__copy_cvref_t<_Self, _Sender>, stdexec::__id<_Receiver>, _Pred>>;
+
+      template <class _Receiver>
+      using __receiver_t = stdexec::__t<__receiver<stdexec::__id<_Receiver>, _Pred>>;
+
+      struct __t {
+        using __id = __sender;
+        using is_sender = sequence_tag;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _Sender __sndr_;
+        STDEXEC_NO_UNIQUE_ADDRESS _Pred __pred_;
+
+        template <__decays_to<__t> _Self, receiver _Receiver>
+          requires sequence_receiver_of<
+                     _Receiver,
+                     __item_sigs_t<__copy_cvref_t<_Self, _Sender>, env_of_t<_Receiver>>>
+                && sequence_sender_to<__copy_cvref_t<_Self, _Sender>, __receiver_t<_Receiver>>
+        friend auto tag_invoke(subscribe_t, _Self&& __self, _Receiver __rcvr)
+          -> __operation_t<_Self, _Receiver> {
+          return {
+            static_cast<_Self&&>(__self).__sndr_,
+            static_cast<_Receiver&&>(__rcvr),
+            static_cast<_Self&&>(__self).__pred_};
+        }
+
+        template <__decays_to<__t> _Self, class _Env>
+        friend auto tag_invoke(get_completion_signatures_t, _Self&&, _Env&&)
+          -> __item_sigs_t<__copy_cvref_t<_Self, _Sender>, _Env> {
+          return {};
+        }
+      };
+    };
+
+    struct filter_each_t {
+      template <sender _Sender, __movable_value _Pred>
+      auto operator()(_Sender&& __sndr, _Pred __pred) const
+        noexcept(__nothrow_decay_copyable<_Sender> && __nothrow_decay_copyable<_Pred>)
+          -> stdexec::__t<__sender<stdexec::__id<__decay_t<_Sender>>, _Pred>> {
+        return {static_cast<_Sender&&>(__sndr), static_cast<_Pred&&>(__pred)};
+      }
+
+      template <__movable_value _Pred>
+      constexpr auto operator()(_Pred __pred) const noexcept
+        -> __binder_back<filter_each_t, _Pred> {
+        return {{}, {}, {static_cast<_Pred&&>(__pred)}};
+      }
+    };
+  } // namespace __filter_each
+
+  using __filter_each::filter_each_t;
+  inline constexpr filter_each_t filter_each{};
+} // namespace exec
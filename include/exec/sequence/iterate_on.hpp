@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../../stdexec/__detail/__config.hpp"
+
+#if STDEXEC_HAS_STD_RANGES()
+
+#include "../sequence_senders.hpp"
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <ranges>
+
+namespace exec {
+  /////////////////////////////////////////////////////////////////////////////
+  // iterate_on(scheduler, range, chunk_size)
+  //
+  // Splits a random-access range into consecutive sub-ranges of chunk_size
+  // elements and emits one item per sub-range. The range is held as
+  // std::views::all(range), so an lvalue container is referenced, not
+  // copied. Unlike iterate, the items do
+  // not wait for each other: all of them are passed downstream up front and
+  // every item completes on the given scheduler. On a thread pool the chunks
+  // are therefore processed in parallel.
+  namespace __iterate_on {
+    using namespace stdexec;
+
+    template <class _Range>
+    using __chunk_t = std::ranges::subrange<std::ranges::iterator_t<_Range>>;
+
+    template <class _Range, class _Scheduler>
+    using __item_sender_t =
+      __call_result_t<transfer_just_t, _Scheduler&, __chunk_t<_Range>>;
+
+    template <class _Op, class _Env>
+    struct __next_receiver {
+      struct __t {
+        using __id = __next_receiver;
+        using is_receiver = void;
+        _Op* __op_;
+
+        template <same_as<set_value_t> _SetValue, same_as<__t> _Self>
+        friend void tag_invoke(_SetValue, _Self&& __self) noexcept {
+          __self.__op_->__item_completed();
+        }
+
+        template <same_as<set_stopped_t> _SetStopped, same_as<__t> _Self>
+        friend void tag_invoke(_SetStopped, _Self&& __self) noexcept {
+          __self.__op_->__stopped_.store(true, std::memory_order_relaxed);
+          __self.__op_->__item_completed();
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend auto tag_invoke(_GetEnv, const _Self& __self) noexcept -> _Env {
+          return stdexec::get_env(__self.__op_->__rcvr_);
+        }
+      };
+    };
+
+    template <class _Range, class _Scheduler, class _ReceiverId>
+    struct __operation {
+      using _Receiver = stdexec::__t<_ReceiverId>;
+
+      struct __t : __immovable {
+        using __id = __operation;
+        using __next_receiver_t = stdexec::__t<__next_receiver<__t, env_of_t<_Receiver>>>;
+        using __next_op_t = connect_result_t<
+          __next_sender_of_t<_Receiver, __item_sender_t<_Range, _Scheduler>>,
+          __next_receiver_t>;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _Receiver __rcvr_;
+        STDEXEC_NO_UNIQUE_ADDRESS _Range __range_;
+        STDEXEC_NO_UNIQUE_ADDRESS _Scheduler __sched_;
+        std::size_t __chunk_size_;
+        std::size_t __count_;
+        // One reference per item plus one that is held while the items are
+        // being started.
+        std::atomic<std::size_t> __remaining_;
+        std::atomic<bool> __stopped_{false};
+        std::exception_ptr __error_{};
+        std::unique_ptr<std::optional<__next_op_t>[]> __ops_{};
+
+        __t(_Range __range, _Scheduler __sched, std::size_t __chunk_size, _Receiver __rcvr)
+          : __rcvr_(static_cast<_Receiver&&>(__rcvr))
+          , __range_(static_cast<_Range&&>(__range))
+          , __sched_(static_cast<_Scheduler&&>(__sched))
+          , __chunk_size_(__chunk_size)
+          , __count_((std::ranges::size(__range_) + __chunk_size - 1) / __chunk_size)
+          , __remaining_(__count_ + 1) {
+        }
+
+        __chunk_t<_Range> __chunk(std::size_t __i) noexcept {
+          auto __first = std::ranges::begin(__range_);
+          auto __size = static_cast<std::size_t>(std::ranges::size(__range_));
+          auto __begin = __i * __chunk_size_;
+          auto __end = (std::min)(__begin + __chunk_size_, __size);
+          return {
+            __first + static_cast<std::ranges::range_difference_t<_Range>>(__begin),
+            __first + static_cast<std::ranges::range_difference_t<_Range>>(__end)};
+        }
+
+        void __item_completed() noexcept {
+          if (__remaining_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+          }
+          if (__error_) {
+            stdexec::set_error(static_cast<_Receiver&&>(__rcvr_), std::move(__error_));
+          } else if (__stopped_.load(std::memory_order_relaxed)) {
+            __set_value_unless_stopped(static_cast<_Receiver&&>(__rcvr_));
+          } else {
+            stdexec::set_value(static_cast<_Receiver&&>(__rcvr_));
+          }
+        }
+
+        void __start() noexcept {
+          std::size_t __i = 0;
+          try {
+            stdexec::__trace_allocation(
+              "iterate_on", __count_ * sizeof(std::optional<__next_op_t>));
+            __ops_.reset(new std::optional<__next_op_t>[__count_]);
+            for (; __i < __count_ && !__stopped_.load(std::memory_order_relaxed); ++__i) {
+              auto& __op = __ops_[__i].emplace(__conv{[&] {
+                return stdexec::connect(
+                  exec::set_next(__rcvr_, stdexec::transfer_just(__sched_, __chunk(__i))),
+                  __next_receiver_t{this});
+              }});
+              stdexec::start(__op);
+            }
+          } catch (...) {
+            __error_ = std::current_exception();
+          }
+          // Drop the references of the items that were not started, then the
+          // one that was held while starting.
+          std::size_t __not_started = __count_ - __i;
+          if (__not_started != 0) {
+            __remaining_.fetch_sub(__not_started, std::memory_order_relaxed);
+          }
+          __item_completed();
+        }
+
+        friend void tag_invoke(start_t, __t& __self) noexcept {
+          __self.__start();
+        }
+      };
+    };
+
+    template <class _Range, class _Scheduler>
+    struct __sequence {
+      struct __t {
+        using __id = __sequence;
+        using is_sender = sequence_tag;
+
+        template <class _Env>
+        using __completion_sigs_t = //
+          make_completion_signatures<
+            __item_sender_t<_Range, _Scheduler>,
+            _Env,
+            completion_signatures<set_error_t(std::exception_ptr), set_stopped_t()>>;
+
+        template <class _Receiver>
+        using __operation_t =
+          stdexec::__t<__operation<_Range, _Scheduler, stdexec::__id<_Receiver>>>;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _Range __range_;
+        STDEXEC_NO_UNIQUE_ADDRESS _Scheduler __sched_;
+        std::size_t __chunk_size_;
+
+        template <__decays_to<__t> _Self, receiver _Receiver>
+          requires constructible_from<_Range, __copy_cvref_t<_Self, _Range>>
+                && sequence_receiver_of<_Receiver, __completion_sigs_t<env_of_t<_Receiver>>>
+                && sender_to<
+                     __next_sender_of_t<_Receiver, __item_sender_t<_Range, _Scheduler>>,
+                     stdexec::__t<__next_receiver<__operation_t<_Receiver>, env_of_t<_Receiver>>>>
+        friend auto tag_invoke(subscribe_t, _Self&& __self, _Receiver __rcvr)
+          -> __operation_t<_Receiver> {
+          return {
+            static_cast<_Self&&>(__self).__range_,
+            static_cast<_Self&&>(__self).__sched_,
+            __self.__chunk_size_,
+            static_cast<_Receiver&&>(__rcvr)};
+        }
+
+        template <__decays_to<__t> _Self, class _Env>
+        friend auto tag_invoke(get_completion_signatures_t, _Self&&, _Env&&)
+          -> __completion_sigs_t<_Env> {
+          return {};
+        }
+      };
+    };
+
+    struct iterate_on_t {
+      template <scheduler _Scheduler, std::ranges::random_access_range _Range>
+        requires std::ranges::sized_range<_Range> && std::ranges::viewable_range<_Range>
+      auto operator()(_Scheduler&& __sched, _Range&& __range, std::size_t __chunk_size) const
+        -> stdexec::__t<__sequence<std::views::all_t<_Range>, __decay_t<_Scheduler>>> {
+        STDEXEC_ASSERT(__chunk_size > 0);
+        return {
+          std::views::all(static_cast<_Range&&>(__range)),
+          static_cast<_Scheduler&&>(__sched),
+          __chunk_size};
+      }
+    };
+  } // namespace __iterate_on
+
+  using __iterate_on::iterate_on_t;
+  inline constexpr iterate_on_t iterate_on{};
+} // namespace exec
+
+#endif // STDEXEC_HAS_STD_RANGES()
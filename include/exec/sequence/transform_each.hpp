@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../sequence_senders.hpp"
+
+namespace exec {
+  namespace __transform_each {
+    using namespace stdexec;
+
+    template <class _Receiver, class _Adaptor>
+    struct __operation_base {
+      STDEXEC_NO_UNIQUE_ADDRESS _Receiver __receiver_;
+      STDEXEC_NO_UNIQUE_ADDRESS _Adaptor __adaptor_;
+    };
+
+    template <class _ReceiverId, class _Adaptor>
+    struct __receiver {
+      using _Receiver = stdexec::__t<_ReceiverId>;
+
+      struct __t {
+        using __id = __receiver;
+        using is_receiver = void;
+        __operation_base<_Receiver, _Adaptor>* __op_;
+
+        template <same_as<set_next_t> _SetNext, same_as<__t> _Self, sender _Item>
+          requires __callable<_Adaptor&, _Item>
+                && __callable<set_next_t, _Receiver&, __call_result_t<_Adaptor&, _Item>>
+        friend auto tag_invoke(_SetNext, _Self& __self, _Item&& __item) noexcept(
+          __nothrow_callable<_Adaptor&, _Item>
+          && __nothrow_callable<set_next_t, _Receiver&, __call_result_t<_Adaptor&, _Item>>)
+          -> __next_sender_of_t<_Receiver, __call_result_t<_Adaptor&, _Item>> {
+          return exec::set_next(
+            __self.__op_->__receiver_, __self.__op_->__adaptor_(static_cast<_Item&&>(__item)));
+        }
+
+        template <same_as<set_value_t> _SetValue, same_as<__t> _Self>
+        friend void tag_invoke(_SetValue, _Self&& __self) noexcept {
+          stdexec::set_value(static_cast<_Receiver&&>(__self.__op_->__receiver_));
+        }
+
+        template <same_as<set_stopped_t> _SetStopped, same_as<__t> _Self>
+          requires __callable<set_stopped_t, _Receiver&&>
+        friend void tag_invoke(_SetStopped, _Self&& __self) noexcept {
+          stdexec::set_stopped(static_cast<_Receiver&&>(__self.__op_->__receiver_));
+        }
+
+        template <same_as<set_error_t> _SetError, same_as<__t> _Self, class _Error>
+          requires __callable<set_error_t, _Receiver&&, _Error>
+        friend void tag_invoke(_SetError, _Self&& __self, _Error&& __error) noexcept {
+          stdexec::set_error(
+            static_cast<_Receiver&&>(__self.__op_->__receiver_), static_cast<_Error&&>(__error));
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend env_of_t<_Receiver> tag_invoke(_GetEnv, const _Self& __self) noexcept {
+          return stdexec::get_env(__self.__op_->__receiver_);
+        }
+      };
+    };
+
+    template <class _Sender, class _ReceiverId, class _Adaptor>
+    struct __operation {
+      using _Receiver = stdexec::__t<_ReceiverId>;
+
+      struct __t : __operation_base<_Receiver, _Adaptor> {
+        using __id = __operation;
+        using __receiver_t = stdexec::__t<__receiver<_ReceiverId, _Adaptor>>;
+
+        subscribe_result_t<_Sender, __receiver_t> __op_;
+
+        __t(_Sender&& __sndr, _Receiver __rcvr, _Adaptor __adaptor)
+          : __operation_base<_Receiver, _Adaptor>{
+            static_cast<_Receiver&&>(__rcvr),
+            static_cast<_Adaptor&&>(__adaptor)}
+          , __op_{exec::subscribe(static_cast<_Sender&&>(__sndr), __receiver_t{this})} {
+        }
+
+        friend void tag_invoke(start_t, __t& __self) noexcept {
+          stdexec::start(__self.__op_);
+        }
+      };
+    };
+
+    // The items of the resulting sequence are the items of the input sequence
+    // transformed by the adaptor. Errors and stop signals of the input sequence
+    // itself are passed through.
+    template <class _Sender, class _Env, class _Adaptor>
+    using __completion_sigs_t = //
+      make_completion_signatures<
+        _Sender,
+        _Env,
+        completion_signatures_of_t<
+          __call_result_t<
+            _Adaptor&,
+            __sequence_sndr::__unspecified_sender_of<completion_signatures_of_t<_Sender, _Env>>>,
+          _Env>,
+        __mconst<completion_signatures<>>::__f>;
+
+    template <class _SenderId, class _Adaptor>
+    struct __sender {
+      using _Sender = stdexec::__t<_SenderId>;
+
+      template <class _Self, class _Receiver>
+      using __operation_t = stdexec::__t<
+        __operation<__copy_cvref_t<_Self, _Sender>, stdexec::__id<_Receiver>, _Adaptor>>;
+
+      template <class _Receiver>
+      using __receiver_t = stdexec::__t<__receiver<stdexec::__id<_Receiver>, _Adaptor>>;
+
+      struct __t {
+        using __id = __sender;
+        using is_sender = sequence_tag;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _Sender __sndr_;
+        STDEXEC_NO_UNIQUE_ADDRESS _Adaptor __adaptor_;
+
+        template <__decays_to<__t> _Self, receiver _Receiver>
+          requires sequence_receiver_of<
+                     _Receiver,
+                     __completion_sigs_t<__copy_cvref_t<_Self, _Sender>, env_of_t<_Receiver>, _Adaptor>>
+                && sequence_sender_to<__copy_cvref_t<_Self, _Sender>, __receiver_t<_Receiver>>
+        friend auto tag_invoke(subscribe_t, _Self&& __self, _Receiver __rcvr)
+          -> __operation_t<_Self, _Receiver> {
+          return {
+            static_cast<_Self&&>(__self).__sndr_,
+            static_cast<_Receiver&&>(__rcvr),
+            static_cast<_Self&&>(__self).__adaptor_};
+        }
+
+        template <__decays_to<__t> _Self, class _Env>
+        friend auto tag_invoke(get_completion_signatures_t, _Self&&, _Env&&)
+          -> __completion_sigs_t<__copy_cvref_t<_Self, _Sender>, _Env, _Adaptor> {
+          return {};
+        }
+      };
+    };
+
+    struct transform_each_t {
+      template <sender _Sender, class _Adaptor>
+      auto operator()(_Sender&& __sndr, _Adaptor&& __adaptor) const
+        noexcept(__nothrow_decay_copyable<_Sender> && __nothrow_decay_copyable<_Adaptor>)
+          -> stdexec::__t<__sender<stdexec::__id<__decay_t<_Sender>>, __decay_t<_Adaptor>>> {
+        return {static_cast<_Sender&&>(__sndr), static_cast<_Adaptor&&>(__adaptor)};
+      }
+
+      template <class _Adaptor>
+      constexpr auto operator()(_Adaptor __adaptor) const noexcept
+        -> __binder_back<transform_each_t, _Adaptor> {
+        return {{}, {}, {static_cast<_Adaptor&&>(__adaptor)}};
+      }
+    };
+  } // namespace __transform_each
+
+  using __transform_each::transform_each_t;
+  inline constexpr transform_each_t transform_each{};
+} // namespace exec
@@ -0,0 +1,584 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../stdexec/execution.hpp"
+#include "./env.hpp"
+#include "./static_thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace exec {
+  /////////////////////////////////////////////////////////////////////////////
+  // sort(sch, range [, cmp])
+  // stable_partition(sch, range, pred)
+  //
+  // Senders that sort or stably partition a random-access range on the
+  // given scheduler. sort completes with no values; stable_partition
+  // completes with the iterator to the first element for which pred is
+  // false. The range must outlive the operation.
+  //
+  //   sync_wait(exec::sort(pool.get_scheduler(), records, by_key));
+  //
+  // By default, the algorithm runs sequentially in a then on the scheduler.
+  // Schedulers may customize it by providing tag_invoke(sort_t, sch, first,
+  // last, cmp) or tag_invoke(stable_partition_t, sch, first, last, pred);
+  // e.g. static_thread_pool, below, splits the range into a part per thread
+  // and runs the parallel algorithms, which consist of bulk operations.
+  //
+  // The parallel algorithms need a scratch buffer of the size of the range
+  // and some bookkeeping per part, which are allocated together once per
+  // operation with the allocator of the receiver's environment, or
+  // std::allocator if it has none. The values are
+  // moved into the uninitialized buffer and back, so like for std::sort the
+  // value type only has to be move constructible and move assignable.
+  namespace __sort {
+    using namespace stdexec;
+
+    // Part __i of __n elements split into __parts parts: [first, second).
+    inline std::pair<std::size_t, std::size_t>
+      __part(std::size_t __n, std::size_t __parts, std::size_t __i) noexcept {
+      return {__n * __i / __parts, __n * (__i + 1) / __parts};
+    }
+
+    // Parts smaller than this are not worth a task of their own.
+    inline constexpr std::size_t __min_part_size = 2048;
+
+    inline std::size_t __parts_for(std::size_t __n, std::size_t __parallelism) noexcept {
+      return std::max<std::size_t>(1, std::min(__parallelism, __n / __min_part_size));
+    }
+
+    template <class _Alloc, class _Ty>
+    using __rebind_t = typename std::allocator_traits<_Alloc>::template rebind_alloc<_Ty>;
+
+    // Uninitialized storage for __size values, followed by arrays of the
+    // trivial types _Extra for the bookkeeping of an algorithm, all in a
+    // single allocation. The values are moved in and out in slices, each of
+    // which starts at __begin_ and holds __size_ values, so that whatever a
+    // failed operation left in the buffer is destroyed with it. A position in
+    // the buffer corresponds to the same position in the range.
+    template <class _Ty, class _Alloc, class... _Extra>
+    struct __scratch_buffer {
+      static_assert((std::is_trivial_v<_Extra> && ...));
+
+      using __alloc_t = __rebind_t<_Alloc, _Ty>;
+      using __alloc_traits = std::allocator_traits<__alloc_t>;
+
+      struct __slice {
+        std::size_t __begin_ = 0;
+        std::size_t __size_ = 0;
+      };
+
+      static constexpr std::size_t __align =
+        (std::max)({alignof(_Ty), alignof(__slice), alignof(_Extra)...});
+
+      struct alignas(__align) __unit {
+        unsigned char __bytes_[__align];
+      };
+
+      using __unit_alloc_t = __rebind_t<_Alloc, __unit>;
+      using __unit_traits = std::allocator_traits<__unit_alloc_t>;
+
+      // Appends values to a slice. The size of the slice is only stored once
+      // the writer goes away, so that threads filling neighbouring slices do
+      // not write to the same cache line for every value.
+      struct __writer {
+        __scratch_buffer* __buffer_;
+        __slice* __slice_;
+        std::size_t __size_ = 0;
+
+        ~__writer() {
+          __slice_->__size_ = __size_;
+        }
+
+        void __push_back(_Ty&& __value) {
+          __alloc_traits::construct(
+            __buffer_->__alloc_,
+            __buffer_->__data_ + __slice_->__begin_ + __size_,
+            static_cast<_Ty&&>(__value));
+          ++__size_;
+        }
+      };
+
+      __alloc_t __alloc_;
+      std::size_t __n_slices_;
+      std::size_t __units_ = 0;
+      __unit* __storage_{nullptr};
+      _Ty* __data_{nullptr};
+      __slice* __slices_{nullptr};
+      std::tuple<_Extra*...> __extra_{};
+
+      // Reserves room for __n objects of type _Uy after the first __bytes
+      // bytes, and returns their offset.
+      template <class _Uy>
+      static std::size_t __reserve(std::size_t& __bytes, std::size_t __n) noexcept {
+        const std::size_t __offset = (__bytes + alignof(_Uy) - 1) / alignof(_Uy) * alignof(_Uy);
+        __bytes = __offset + __n * sizeof(_Uy);
+        return __offset;
+      }
+
+      // __counts holds the number of objects of each of the _Extra types.
+      __scratch_buffer(
+        const char* __algorithm,
+        std::size_t __size,
+        std::size_t __slices,
+        std::array<std::size_t, sizeof...(_Extra)> __counts,
+        const _Alloc& __alloc)
+        : __alloc_(__alloc)
+        , __n_slices_(__slices) {
+        std::size_t __bytes = 0;
+        const std::size_t __data_offset = __reserve<_Ty>(__bytes, __size);
+        const std::size_t __slices_offset = __reserve<__slice>(__bytes, __n_slices_);
+        std::array<std::size_t, sizeof...(_Extra)> __offsets{};
+        [&]<std::size_t... _Is>(std::index_sequence<_Is...>) {
+          ((__offsets[_Is] = __reserve<_Extra>(__bytes, __counts[_Is])), ...);
+        }(std::index_sequence_for<_Extra...>{});
+        if (__bytes == 0) {
+          return;
+        }
+
+        __units_ = (__bytes + __align - 1) / __align;
+        __unit_alloc_t __unit_alloc{__alloc_};
+        stdexec::__trace_allocation(__algorithm, __units_ * __align);
+        __storage_ = __unit_traits::allocate(__unit_alloc, __units_);
+        unsigned char* __base = __storage_->__bytes_;
+        __data_ = reinterpret_cast<_Ty*>(__base + __data_offset);
+        __slices_ = reinterpret_cast<__slice*>(__base + __slices_offset);
+        std::uninitialized_value_construct_n(__slices_, __n_slices_);
+        [&]<std::size_t... _Is>(std::index_sequence<_Is...>) {
+          ((std::get<_Is>(__extra_) = reinterpret_cast<_Extra*>(__base + __offsets[_Is])), ...);
+          (std::uninitialized_default_construct_n(std::get<_Is>(__extra_), __counts[_Is]), ...);
+        }(std::index_sequence_for<_Extra...>{});
+      }
+
+      __scratch_buffer(__scratch_buffer&& __other) noexcept
+        : __alloc_(static_cast<__alloc_t&&>(__other.__alloc_))
+        , __n_slices_(__other.__n_slices_)
+        , __units_(__other.__units_)
+        , __storage_(std::exchange(__other.__storage_, nullptr))
+        , __data_(__other.__data_)
+        , __slices_(__other.__slices_)
+        , __extra_(__other.__extra_) {
+      }
+
+      ~__scratch_buffer() {
+        if (__storage_ != nullptr) {
+          for (std::size_t __i = 0; __i < __n_slices_; ++__i) {
+            const __slice& __s = __slices_[__i];
+            for (std::size_t __k = 0; __k < __s.__size_; ++__k) {
+              __alloc_traits::destroy(__alloc_, __data_ + __s.__begin_ + __k);
+            }
+          }
+          __unit_alloc_t __unit_alloc{__alloc_};
+          __unit_traits::deallocate(__unit_alloc, __storage_, __units_);
+        }
+      }
+
+      // The array of the _Ip-th of the _Extra types.
+      template <std::size_t _Ip>
+      auto* __extra() const noexcept {
+        return std::get<_Ip>(__extra_);
+      }
+
+      __writer __write(std::size_t __i, std::size_t __begin) noexcept {
+        __slice& __s = __slices_[__i];
+        __s.__begin_ = __begin;
+        return __writer{this, &__s};
+      }
+
+      // Moves the values of a slice back to the same positions in the range
+      // that starts at __first.
+      template <class _Iter>
+      void __move_back(std::size_t __i, _Iter __first) {
+        __slice& __s = __slices_[__i];
+        const std::size_t __begin = __s.__begin_;
+        std::size_t __k = 0;
+        try {
+          for (; __k < __s.__size_; ++__k) {
+            __first[__begin + __k] = static_cast<_Ty&&>(__data_[__begin + __k]);
+            __alloc_traits::destroy(__alloc_, __data_ + __begin + __k);
+          }
+        } catch (...) {
+          __s.__begin_ += __k;
+          __s.__size_ -= __k;
+          throw;
+        }
+        __s.__size_ = 0;
+      }
+    };
+
+    // Sample sort. The parts are sorted, the samples taken from them choose
+    // a splitter value between every two buckets, and every bucket is merged
+    // from the runs of the parts that fall into it. The buckets are merged
+    // into the scratch buffer, from which the values are moved back.
+    template <class _Iter, class _Compare, class _Alloc>
+    struct __sort_state {
+      using __value_t = std::iter_value_t<_Iter>;
+
+      // The positions [__begin_, __end_) of a run in the range.
+      struct __run_t {
+        std::size_t __begin_;
+        std::size_t __end_;
+      };
+
+      // The number of samples per part.
+      static constexpr std::size_t __oversampling = 16;
+
+      _Iter __first_;
+      std::size_t __size_;
+      std::size_t __parts_;
+      _Compare __cmp_;
+      std::size_t __n_samples_;
+      // Bucket __j is merged into slice __j of the scratch buffer. A single
+      // part needs no buffer at all.
+      __scratch_buffer<__value_t, _Alloc, std::size_t, std::size_t, __run_t> __scratch_;
+      // The positions of the samples in the range.
+      std::size_t* __samples_ = __scratch_.template __extra<0>();
+      // The offsets of the buckets within each part: __bounds_[__i * (__parts_ + 1) + __j]
+      // is the offset of bucket __j in part __i.
+      std::size_t* __bounds_ = __scratch_.template __extra<1>();
+      // The runs that a bucket merges, __parts_ per bucket.
+      __run_t* __runs_ = __scratch_.template __extra<2>();
+
+      __sort_state(_Iter __first, _Iter __last, _Compare __cmp, std::size_t __parts, _Alloc __alloc)
+        : __first_(__first)
+        , __size_(static_cast<std::size_t>(__last - __first))
+        , __parts_(__parts)
+        , __cmp_((_Compare&&) __cmp)
+        , __n_samples_(__parts_ > 1 ? __parts_ * __oversampling : 0)
+        , __scratch_(
+            "sort",
+            __parts_ > 1 ? __size_ : 0,
+            __parts_ > 1 ? __parts_ : 0,
+            {__n_samples_,
+             __parts_ > 1 ? __parts_ * (__parts_ + 1) : 0,
+             __parts_ > 1 ? __parts_ * __parts_ : 0},
+            __alloc) {
+      }
+
+      std::size_t* __bounds_of(std::size_t __i) noexcept {
+        return __bounds_ + __i * (__parts_ + 1);
+      }
+
+      void __sort_part(std::size_t __i) {
+        auto [__begin, __end] = __sort::__part(__size_, __parts_, __i);
+        std::sort(__first_ + __begin, __first_ + __end, __cmp_);
+      }
+
+      // The samples of all parts, sorted by their values. They stay in place
+      // until the buckets are merged, which is after the bounds are found.
+      void __choose_splitters() {
+        if (__parts_ == 1) {
+          return;
+        }
+        std::size_t* __sample = __samples_;
+        for (std::size_t __i = 0; __i < __parts_; ++__i) {
+          auto [__begin, __end] = __sort::__part(__size_, __parts_, __i);
+          const std::size_t __len = __end - __begin;
+          for (std::size_t __k = 0; __k < __oversampling; ++__k) {
+            *__sample++ = __begin + __len * (2 * __k + 1) / (2 * __oversampling);
+          }
+        }
+        std::sort(
+          __samples_, __samples_ + __n_samples_, [this](std::size_t __a, std::size_t __b) {
+            return __cmp_(__first_[__a], __first_[__b]);
+          });
+      }
+
+      decltype(auto) __splitter(std::size_t __j) const {
+        return __first_[__samples_[__j * __n_samples_ / __parts_]];
+      }
+
+      // Bucket __j holds the values v with splitter(__j) <= v < splitter(__j + 1).
+      void __find_bounds(std::size_t __i) {
+        if (__parts_ == 1) {
+          return;
+        }
+        auto [__begin, __end] = __sort::__part(__size_, __parts_, __i);
+        std::size_t* __bounds = __bounds_of(__i);
+        __bounds[0] = 0;
+        for (std::size_t __j = 1; __j < __parts_; ++__j) {
+          __bounds[__j] = static_cast<std::size_t>(
+            std::lower_bound(
+              __first_ + __begin + __bounds[__j - 1], __first_ + __end, __splitter(__j), __cmp_)
+            - (__first_ + __begin));
+        }
+        __bounds[__parts_] = __end - __begin;
+      }
+
+      void __merge_bucket(std::size_t __j) {
+        if (__parts_ == 1) {
+          return;
+        }
+        std::size_t __offset = 0;
+        __run_t* __runs = __runs_ + __j * __parts_;
+        std::size_t __n_runs = 0;
+        for (std::size_t __i = 0; __i < __parts_; ++__i) {
+          const std::size_t* __bounds = __bounds_of(__i);
+          const std::size_t __part = __sort::__part(__size_, __parts_, __i).first;
+          __offset += __bounds[__j];
+          if (__bounds[__j] != __bounds[__j + 1]) {
+            __runs[__n_runs++] = {__part + __bounds[__j], __part + __bounds[__j + 1]};
+          }
+        }
+        // A heap of the runs by their first value, smallest on top.
+        auto __greater = [this](const __run_t& __a, const __run_t& __b) {
+          return __cmp_(__first_[__b.__begin_], __first_[__a.__begin_]);
+        };
+        auto __out = __scratch_.__write(__j, __offset);
+        std::make_heap(__runs, __runs + __n_runs, __greater);
+        while (__n_runs != 0) {
+          std::pop_heap(__runs, __runs + __n_runs, __greater);
+          __run_t& __run = __runs[__n_runs - 1];
+          __out.__push_back(std::ranges::iter_move(__first_ + __run.__begin_++));
+          if (__run.__begin_ == __run.__end_) {
+            --__n_runs;
+          } else {
+            std::push_heap(__runs, __runs + __n_runs, __greater);
+          }
+        }
+      }
+
+      void __move_back(std::size_t __j) {
+        if (__parts_ == 1) {
+          return;
+        }
+        __scratch_.__move_back(__j, __first_);
+      }
+
+      template <class _Scheduler>
+      auto __run(_Scheduler __sched) {
+        return schedule(__sched)                                               //
+             | bulk(__parts_, [this](std::size_t __i) { __sort_part(__i); })   //
+             | then([this] { __choose_splitters(); })                          //
+             | bulk(__parts_, [this](std::size_t __i) { __find_bounds(__i); }) //
+             | bulk(__parts_, [this](std::size_t __j) { __merge_bucket(__j); })
+             | bulk(__parts_, [this](std::size_t __j) { __move_back(__j); });
+      }
+    };
+
+    // Every part moves its values for which the predicate holds, and then the
+    // others, into the scratch buffer at offsets that follow from the counts
+    // of the preceding parts. The values are then moved back.
+    template <class _Iter, class _Predicate, class _Alloc>
+    struct __partition_state {
+      using __value_t = std::iter_value_t<_Iter>;
+
+      _Iter __first_;
+      std::size_t __size_;
+      std::size_t __parts_;
+      _Predicate __pred_;
+      // Part __i moves the values for which the predicate holds into slice
+      // 2 * __i of the scratch buffer, and the others into slice 2 * __i + 1.
+      __scratch_buffer<__value_t, _Alloc, unsigned char, std::size_t, std::size_t> __scratch_;
+      // Whether the predicate holds for each value.
+      unsigned char* __flags_ = __scratch_.template __extra<0>();
+      // The number of values of each part that satisfy the predicate, and then
+      // the offsets at which a part moves those values and the others.
+      std::size_t* __counts_ = __scratch_.template __extra<1>();
+      std::size_t* __offsets_ = __scratch_.template __extra<2>();
+      std::size_t __n_true_ = 0;
+
+      __partition_state(
+        _Iter __first,
+        _Iter __last,
+        _Predicate __pred,
+        std::size_t __parts,
+        _Alloc __alloc)
+        : __first_(__first)
+        , __size_(static_cast<std::size_t>(__last - __first))
+        , __parts_(__parts)
+        , __pred_((_Predicate&&) __pred)
+        , __scratch_(
+            "stable_partition",
+            __size_,
+            2 * __parts,
+            {__size_, __parts, 2 * __parts},
+            __alloc) {
+      }
+
+      void __count(std::size_t __i) {
+        auto [__begin, __end] = __sort::__part(__size_, __parts_, __i);
+        std::size_t __count = 0;
+        for (std::size_t __k = __begin; __k < __end; ++__k) {
+          const bool __flag = std::invoke(__pred_, __first_[__k]);
+          __flags_[__k] = __flag;
+          __count += __flag;
+        }
+        __counts_[__i] = __count;
+      }
+
+      void __compute_offsets() noexcept {
+        __n_true_ = 0;
+        for (std::size_t __i = 0; __i < __parts_; ++__i) {
+          __offsets_[2 * __i] = __n_true_;
+          __n_true_ += __counts_[__i];
+        }
+        std::size_t __n_false = __n_true_;
+        for (std::size_t __i = 0; __i < __parts_; ++__i) {
+          auto [__begin, __end] = __sort::__part(__size_, __parts_, __i);
+          __offsets_[2 * __i + 1] = __n_false;
+          __n_false += (__end - __begin) - __counts_[__i];
+        }
+      }
+
+      void __scatter(std::size_t __i) {
+        auto [__begin, __end] = __sort::__part(__size_, __parts_, __i);
+        auto __true = __scratch_.__write(2 * __i, __offsets_[2 * __i]);
+        auto __false = __scratch_.__write(2 * __i + 1, __offsets_[2 * __i + 1]);
+        for (std::size_t __k = __begin; __k < __end; ++__k) {
+          auto& __out = __flags_[__k] ? __true : __false;
+          __out.__push_back(std::ranges::iter_move(__first_ + __k));
+        }
+      }
+
+      void __move_back(std::size_t __i) {
+        __scratch_.__move_back(2 * __i, __first_);
+        __scratch_.__move_back(2 * __i + 1, __first_);
+      }
+
+      template <class _Scheduler>
+      auto __run(_Scheduler __sched) {
+        return schedule(__sched)                                           //
+             | bulk(__parts_, [this](std::size_t __i) { __count(__i); })   //
+             | then([this]() noexcept { __compute_offsets(); })            //
+             | bulk(__parts_, [this](std::size_t __i) { __scatter(__i); }) //
+             | bulk(__parts_, [this](std::size_t __i) { __move_back(__i); })
+             | then([this] { return __first_ + __n_true_; });
+      }
+    };
+
+    // Runs the algorithm of a state that is made with the allocator of the
+    // receiver's environment, once the operation is started. The state lives
+    // in the operation of let_value.
+    template <template <class, class, class> class _State, class _Scheduler, class _Iter, class _Fn>
+    auto __with_state(
+      _Scheduler __sched,
+      _Iter __first,
+      _Iter __last,
+      _Fn __fn,
+      std::size_t __parts) {
+      return exec::read_with_default(get_allocator, std::allocator<std::byte>{})
+           | then([=](auto __alloc) {
+               using __state_t = _State<_Iter, _Fn, decltype(__alloc)>;
+               return __state_t{__first, __last, __fn, __parts, __alloc};
+             })
+           | let_value([__sched](auto& __state) { return __state.__run(__sched); });
+    }
+
+    // Sorts [first, last) with a task per part on sched, which should be able
+    // to run that many bulk tasks in parallel.
+    template <scheduler _Scheduler, std::random_access_iterator _Iter, class _Compare>
+    auto __parallel_sort(
+      _Scheduler __sched,
+      _Iter __first,
+      _Iter __last,
+      _Compare __cmp,
+      std::size_t __parallelism) {
+      const std::size_t __parts =
+        __sort::__parts_for(static_cast<std::size_t>(__last - __first), __parallelism);
+      return __sort::__with_state<__sort_state>(__sched, __first, __last, __cmp, __parts);
+    }
+
+    template <scheduler _Scheduler, std::random_access_iterator _Iter, class _Predicate>
+    auto __parallel_stable_partition(
+      _Scheduler __sched,
+      _Iter __first,
+      _Iter __last,
+      _Predicate __pred,
+      std::size_t __parallelism) {
+      const std::size_t __parts =
+        __sort::__parts_for(static_cast<std::size_t>(__last - __first), __parallelism);
+      return __sort::__with_state<__partition_state>(__sched, __first, __last, __pred, __parts);
+    }
+
+    template <class _Range>
+    concept __sortable_range = //
+      std::ranges::random_access_range<_Range> && std::ranges::borrowed_range<_Range>;
+
+    struct sort_t {
+      template <scheduler _Scheduler, __sortable_range _Range, class _Compare = std::less<>>
+        requires std::sortable<std::ranges::iterator_t<_Range>, _Compare>
+      auto operator()(_Scheduler __sched, _Range&& __range, _Compare __cmp = {}) const {
+        using _Iter = std::ranges::iterator_t<_Range>;
+        _Iter __first = std::ranges::begin(__range);
+        _Iter __last = std::ranges::next(__first, std::ranges::end(__range));
+        if constexpr (tag_invocable<sort_t, _Scheduler, _Iter, _Iter, _Compare>) {
+          return tag_invoke(*this, __sched, __first, __last, (_Compare&&) __cmp);
+        } else {
+          return schedule(__sched) | then([__first, __last, __cmp] {
+                   std::sort(__first, __last, __cmp);
+                 });
+        }
+      }
+    };
+
+    struct stable_partition_t {
+      template <scheduler _Scheduler, __sortable_range _Range, class _Predicate>
+        requires std::indirect_unary_predicate<_Predicate, std::ranges::iterator_t<_Range>>
+              && std::permutable<std::ranges::iterator_t<_Range>>
+      auto operator()(_Scheduler __sched, _Range&& __range, _Predicate __pred) const {
+        using _Iter = std::ranges::iterator_t<_Range>;
+        _Iter __first = std::ranges::begin(__range);
+        _Iter __last = std::ranges::next(__first, std::ranges::end(__range));
+        if constexpr (tag_invocable<stable_partition_t, _Scheduler, _Iter, _Iter, _Predicate>) {
+          return tag_invoke(*this, __sched, __first, __last, (_Predicate&&) __pred);
+        } else {
+          return schedule(__sched) | then([__first, __last, __pred] {
+                   return std::stable_partition(__first, __last, __pred);
+                 });
+        }
+      }
+    };
+
+    // static_thread_pool runs a task per thread for every stage.
+    template <std::random_access_iterator _Iter, class _Compare>
+    auto tag_invoke(
+      sort_t,
+      const static_thread_pool::scheduler& __sched,
+      _Iter __first,
+      _Iter __last,
+      _Compare __cmp) {
+      return __sort::__parallel_sort(
+        __sched, __first, __last, (_Compare&&) __cmp, __sched.available_parallelism());
+    }
+
+    template <std::random_access_iterator _Iter, class _Predicate>
+    auto tag_invoke(
+      stable_partition_t,
+      const static_thread_pool::scheduler& __sched,
+      _Iter __first,
+      _Iter __last,
+      _Predicate __pred) {
+      return __sort::__parallel_stable_partition(
+        __sched, __first, __last, (_Predicate&&) __pred, __sched.available_parallelism());
+    }
+  } // namespace __sort
+
+  using __sort::sort_t;
+  using __sort::stable_partition_t;
+  inline constexpr sort_t sort{};
+  inline constexpr stable_partition_t stable_partition{};
+} // namespace exec
@@ -20,23 +20,31 @@
 #include "../stdexec/__detail/__config.hpp"
 #include "../stdexec/__detail/__intrusive_queue.hpp"
 #include "../stdexec/__detail/__meta.hpp"
+#include "./__detail/__scheduler_tracing.hpp"
+#include "./bulk_chunked.hpp"
+#include "./repeat_n.hpp"
 
 #include <atomic>
 #include <condition_variable>
 #include <exception>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace exec {
   using stdexec::__intrusive_queue;
 
-  struct task_base {
+  struct task_base : __tracing::__traced_task {
     task_base* next;
     void (*__execute)(task_base*, std::uint32_t tid) noexcept;
   };
 
+  class multi_pool_context;
+
   class static_thread_pool {
     template <class ReceiverId>
     class operation;
@@ -75,17 +83,179 @@ namespace exec {
     template <class SenderId, class ReceiverId, std::integral Shape, class Fun>
     struct bulk_op_state;
 
+    // One bulk of a chain of consecutive bulks that are executed as a
+    // single dispatch.
+    template <class ShapeT, class FunId>
+    struct bulk_stage {
+      using Shape = ShapeT;
+      using Fun = stdexec::__t<FunId>;
+      Shape shape_;
+      Fun fun_;
+    };
+
+    template <class Shape, class Fun>
+    using bulk_stage_t = bulk_stage<Shape, stdexec::__x<stdexec::__decay_t<Fun>>>;
+
+    template <class Sender, class Env, class... Stages>
+    static constexpr bool bulk_chain_may_throw = //
+      !stdexec::__v<stdexec::__mand<stdexec::__value_types_of_t<
+        Sender,
+        Env,
+        stdexec::__mbind_front_q<bulk_non_throwing, typename Stages::Fun, typename Stages::Shape>,
+        stdexec::__q<stdexec::__mand>>...>>;
+
+    template <class SenderId, class... Stages>
+    struct bulk_chain_sender;
+
+    template <class SenderId, class ReceiverId, bool MayThrow, class... Stages>
+    struct bulk_chain_shared_state;
+
+    template <class SenderId, class ReceiverId, bool MayThrow, class... Stages>
+    struct bulk_chain_receiver;
+
+    template <class SenderId, class ReceiverId, class... Stages>
+    struct bulk_chain_op_state;
+
+    template <class SenderId, class... Stages>
+    struct bulk_repeat_sender;
+
     struct transform_bulk {
+      // A bulk of a bulk is fused into one chain, so that the pool runs
+      // both in a single dispatch; see bulk_chain_shared_state.
       template <class Data, class Sender>
       auto operator()(stdexec::bulk_t, Data&& data, Sender&& sndr) {
+        if constexpr (stdexec::sender_expr_for<Sender, stdexec::bulk_t>) {
+          // When bulk is customized lazily, the inner bulk has not been
+          // transformed yet. Transform it first so that it can be fused.
+          return (*this)(
+            stdexec::bulk, (Data&&) data, stdexec::apply_sender((Sender&&) sndr, *this));
+        } else {
+          return make_bulk_sender((Data&&) data, (Sender&&) sndr);
+        }
+      }
+
+      template <class Data, class Sender>
+      auto make_bulk_sender(Data&& data, Sender&& sndr) {
         auto [shape, fun] = (Data&&) data;
-        return bulk_sender_t<Sender, decltype(shape), decltype(fun)>{
-          pool_, (Sender&&) sndr, shape, std::move(fun)};
+        using stage_t = bulk_stage_t<decltype(shape), decltype(fun)>;
+        using sender_t = stdexec::__decay_t<Sender>;
+        if constexpr (stdexec::__is_instance_of<sender_t, bulk_sender>) {
+          using first_t = bulk_stage_t<decltype(sndr.shape_), decltype(sndr.fun_)>;
+          using child_t = stdexec::__decay_t<decltype(sndr.sndr_)>;
+          return bulk_chain_sender<stdexec::__x<child_t>, first_t, stage_t>{
+            pool_,
+            ((Sender&&) sndr).sndr_,
+            {first_t{sndr.shape_, ((Sender&&) sndr).fun_}, stage_t{shape, std::move(fun)}}};
+        } else if constexpr (stdexec::__is_instance_of<sender_t, bulk_chain_sender>) {
+          return std::apply(
+            [&]<class... Stages>(Stages&&... stages) {
+              using child_t = stdexec::__decay_t<decltype(sndr.sndr_)>;
+              using chain_t = bulk_chain_sender<
+                stdexec::__x<child_t>,
+                stdexec::__decay_t<Stages>...,
+                stage_t>;
+              return chain_t{
+                pool_,
+                ((Sender&&) sndr).sndr_,
+                {(Stages&&) stages..., stage_t{shape, std::move(fun)}}};
+            },
+            ((Sender&&) sndr).stages_);
+        } else {
+          return bulk_sender_t<Sender, decltype(shape), decltype(fun)>{
+            pool_, (Sender&&) sndr, shape, std::move(fun)};
+        }
       }
 
       static_thread_pool& pool_;
     };
 
+    template <class Body>
+    static constexpr bool is_repeatable_bulk_body() noexcept {
+      if constexpr (
+        stdexec::__is_instance_of<Body, bulk_sender>
+        || stdexec::__is_instance_of<Body, bulk_chain_sender>) {
+        using child_t = stdexec::__decay_t<decltype(std::declval<Body&>().sndr_)>;
+        return stdexec::same_as<child_t, decltype(stdexec::just())>;
+      } else {
+        return false;
+      }
+    }
+
+    // repeat_n of a closure that consists of bulk operations only runs all the
+    // iterations as a single dispatch of the fused bulk chain; see
+    // bulk_chain_shared_state. Other closures are repeated generically.
+    template <class Sender, class Closure>
+    auto make_repeat_sender(Sender&& sndr, std::size_t n, Closure closure) {
+      using generic_t = exec::__repeat_n::__sender_t<Sender, Closure>;
+      using body_t = stdexec::__call_result_t<Closure&, decltype(stdexec::just())>;
+      if constexpr (stdexec::sender_expr_for<body_t, stdexec::bulk_t>) {
+        using chain_t =
+          decltype(stdexec::apply_sender(closure(stdexec::just()), transform_bulk{*this}));
+        if constexpr (is_repeatable_bulk_body<chain_t>()) {
+          chain_t chain = stdexec::apply_sender(closure(stdexec::just()), transform_bulk{*this});
+          auto stages = [&] {
+            if constexpr (stdexec::__is_instance_of<chain_t, bulk_sender>) {
+              using stage_t = bulk_stage_t<decltype(chain.shape_), decltype(chain.fun_)>;
+              return std::tuple<stage_t>{stage_t{chain.shape_, std::move(chain.fun_)}};
+            } else {
+              return std::move(chain.stages_);
+            }
+          }();
+          // The values of the predecessor are discarded.
+          auto pred = stdexec::then((Sender&&) sndr, [](auto&&...) noexcept {});
+          return std::apply(
+            [&]<class... Stages>(Stages&... stage) {
+              using repeat_t = bulk_repeat_sender<stdexec::__x<decltype(pred)>, Stages...>;
+              return repeat_t{{*this, std::move(pred), {std::move(stage)...}}, n};
+            },
+            stages);
+        } else {
+          return generic_t{(Sender&&) sndr, n, std::move(closure)};
+        }
+      } else {
+        return generic_t{(Sender&&) sndr, n, std::move(closure)};
+      }
+    }
+
+    // Splits `n` into `size` chunks distributing `n % size` evenly between ranks.
+    // Returns `[begin, end)` range in `n` for a given `rank`.
+    // Example:
+    // ```cpp
+    // //         n_items  thread  n_threads
+    // even_share(     11,      0,         3); // -> [0,  4) -> 4 items
+    // even_share(     11,      1,         3); // -> [4,  8) -> 4 items
+    // even_share(     11,      2,         3); // -> [8, 11) -> 3 items
+    // ```
+    template <class Shape>
+    static std::pair<Shape, Shape>
+      even_share(Shape n, std::uint32_t rank, std::uint32_t size) noexcept {
+      const auto avg_per_thread = n / size;
+      const auto n_big_share = avg_per_thread + 1;
+      const auto big_shares = n % size;
+      const auto is_big_share = rank < big_shares;
+      const auto begin = is_big_share
+                         ? n_big_share * rank
+                         : n_big_share * big_shares + (rank - big_shares) * avg_per_thread;
+      const auto end = begin + (is_big_share ? n_big_share : avg_per_thread);
+
+      return std::make_pair(begin, end);
+    }
+
+    // Runs the indices [begin, end) of a bulk. The function of a bulk_chunked
+    // gets the whole range in a single call.
+    template <class Fun, class Shape, class... Args>
+    static void run_bulk_range(Fun& fun, Shape begin, Shape end, Args&... args) {
+      if constexpr (__bulk_chunked::__is_chunk_fn<Fun>) {
+        if (begin != end) {
+          fun.__run_range(begin, end, args...);
+        }
+      } else {
+        for (Shape i = begin; i < end; ++i) {
+          fun(i, args...);
+        }
+      }
+    }
+
     struct domain {
       // For eager customization
       template <stdexec::sender_expr_for<stdexec::bulk_t> Sender>
@@ -114,6 +284,12 @@ namespace exec {
       using __id = scheduler;
       bool operator==(const scheduler&) const = default;
 
+      // The number of threads of the pool, which is how many tasks of a bulk
+      // can run in parallel.
+      std::uint32_t available_parallelism() const noexcept {
+        return pool_->available_parallelism();
+      }
+
      private:
       template <typename ReceiverId>
       friend class operation;
@@ -181,6 +357,21 @@ namespace exec {
         return {};
       }
 
+      template <class Sender, class Closure>
+      auto make_repeat_sender_(Sender&& sndr, std::size_t n, Closure closure) const {
+        return pool_->make_repeat_sender((Sender&&) sndr, n, std::move(closure));
+      }
+
+      template <stdexec::sender Sender, stdexec::__sender_adaptor_closure Closure>
+      friend auto tag_invoke(
+        exec::repeat_n_t,
+        const scheduler& sched,
+        Sender&& sndr,
+        std::size_t n,
+        Closure closure) {
+        return sched.make_repeat_sender_((Sender&&) sndr, n, std::move(closure));
+      }
+
       friend class static_thread_pool;
 
       explicit scheduler(static_thread_pool& pool) noexcept
@@ -201,6 +392,8 @@ namespace exec {
     }
 
    private:
+    friend class multi_pool_context;
+
     class thread_state {
      public:
       task_base* try_pop();
@@ -240,6 +433,8 @@ namespace exec {
     , nextThread_(0) {
     STDEXEC_ASSERT(threadCount > 0);
 
+    stdexec::__trace_allocation(
+      "static_thread_pool", threadCount * (sizeof(thread_state) + sizeof(std::thread)));
     threads_.reserve(threadCount);
 
     try {
@@ -281,6 +476,7 @@ namespace exec {
       if (!task && !(task = threadStates_[queueIndex].pop()))
         return; // pop() only returns null when request_stop() was called.
 
+      __tracing::__task_scope scope{"static_thread_pool", *task};
       task->__execute(task, queueIndex);
     }
   }
@@ -293,6 +489,7 @@ namespace exec {
   }
 
   inline void static_thread_pool::enqueue(task_base* task) noexcept {
+    task->__mark_enqueued();
     const std::uint32_t threadCount = static_cast<std::uint32_t>(threads_.size());
     const std::uint32_t startIndex =
       nextThread_.fetch_add(1, std::memory_order_relaxed) % threadCount;
@@ -313,6 +510,7 @@ namespace exec {
   template <std::derived_from<task_base> TaskT>
   inline void static_thread_pool::bulk_enqueue(TaskT* task, std::uint32_t n_threads) noexcept {
     for (std::size_t i = 0; i < n_threads; ++i) {
+      task[i].__mark_enqueued();
       threadStates_[i % available_parallelism()].push(task + i);
     }
   }
@@ -485,9 +683,7 @@ namespace exec {
 
           auto computation = [&](auto&... args) {
             auto [begin, end] = even_share(sh_state.shape_, tid, total_threads);
-            for (Shape i = begin; i < end; ++i) {
-              sh_state.fn_(i, args...);
-            }
+            run_bulk_range(sh_state.fn_, begin, end, args...);
           };
 
           auto completion = [&](auto&... args) {
@@ -548,29 +744,6 @@ namespace exec {
     std::exception_ptr exception_;
     std::vector<bulk_task> tasks_;
 
-    // Splits `n` into `size` chunks distributing `n % size` evenly between ranks.
-    // Returns `[begin, end)` range in `n` for a given `rank`.
-    // Example:
-    // ```cpp
-    // //         n_items  thread  n_threads
-    // even_share(     11,      0,         3); // -> [0,  4) -> 4 items
-    // even_share(     11,      1,         3); // -> [4,  8) -> 4 items
-    // even_share(     11,      2,         3); // -> [8, 11) -> 3 items
-    // ```
-    static std::pair<Shape, Shape>
-      even_share(Shape n, std::uint32_t rank, std::uint32_t size) noexcept {
-      const auto avg_per_thread = n / size;
-      const auto n_big_share = avg_per_thread + 1;
-      const auto big_shares = n % size;
-      const auto is_big_share = rank < big_shares;
-      const auto begin = is_big_share
-                         ? n_big_share * rank
-                         : n_big_share * big_shares + (rank - big_shares) * avg_per_thread;
-      const auto end = begin + (is_big_share ? n_big_share : avg_per_thread);
-
-      return std::make_pair(begin, end);
-    }
-
     std::uint32_t num_agents_required() const {
       return std::min(shape_, static_cast<Shape>(pool_.available_parallelism()));
     }
@@ -589,6 +762,7 @@ namespace exec {
       , fn_{fn}
       , thread_with_exception_{num_agents_required()}
       , tasks_{num_agents_required(), {this}} {
+      stdexec::__trace_allocation("static_thread_pool::bulk", tasks_.size() * sizeof(bulk_task));
     }
   };
 
@@ -677,4 +851,370 @@ namespace exec {
     }
   };
 
+  //////////////////////////////////////////////////////////////////////////////////////////////////
+  // A chain of consecutive bulk operations runs as one dispatch: each task runs its slice of the
+  // first bulk, waits for the other tasks to finish theirs, runs its slice of the second bulk and
+  // so on. As long as the shapes agree, every task touches the same indices in each bulk.
+  template <class SenderId, class... Stages>
+  struct static_thread_pool::bulk_chain_sender {
+    using Sender = stdexec::__t<SenderId>;
+    using is_sender = void;
+
+    static_thread_pool& pool_;
+    Sender sndr_;
+    std::tuple<Stages...> stages_;
+
+    template <class... Tys>
+    using set_value_t =
+      stdexec::completion_signatures< stdexec::set_value_t(stdexec::__decay_t<Tys>...)>;
+
+    template <class Self, class Env>
+    using completion_signatures = //
+      stdexec::__try_make_completion_signatures<
+        stdexec::__copy_cvref_t<Self, Sender>,
+        Env,
+        stdexec::__if_c<
+          bulk_chain_may_throw<stdexec::__copy_cvref_t<Self, Sender>, Env, Stages...>,
+          stdexec::__with_exception_ptr,
+          stdexec::completion_signatures<>>,
+        stdexec::__q<set_value_t>>;
+
+    template <class Self, class Receiver>
+    using bulk_op_state_t = //
+      bulk_chain_op_state<
+        stdexec::__x<stdexec::__copy_cvref_t<Self, Sender>>,
+        stdexec::__x<stdexec::__decay_t<Receiver>>,
+        Stages...>;
+
+    template <stdexec::__decays_to<bulk_chain_sender> Self, stdexec::receiver Receiver>
+      requires stdexec::
+        receiver_of<Receiver, completion_signatures<Self, stdexec::env_of_t<Receiver>>>
+      friend bulk_op_state_t<Self, Receiver>                       //
+      tag_invoke(stdexec::connect_t, Self&& self, Receiver&& rcvr) //
+      noexcept(stdexec::__nothrow_constructible_from<
+               bulk_op_state_t<Self, Receiver>,
+               static_thread_pool&,
+               std::tuple<Stages...>,
+               Sender,
+               Receiver,
+               std::size_t>) {
+      return bulk_op_state_t<Self, Receiver>{
+        self.pool_, self.stages_, ((Self&&) self).sndr_, (Receiver&&) rcvr, 1};
+    }
+
+    template <stdexec::__decays_to<bulk_chain_sender> Self, class Env>
+    friend auto tag_invoke(stdexec::get_completion_signatures_t, Self&&, Env&&)
+      -> completion_signatures<Self, Env> {
+      return {};
+    }
+
+    friend auto tag_invoke(stdexec::get_env_t, const bulk_chain_sender& self) noexcept
+      -> stdexec::env_of_t<const Sender&> {
+      return stdexec::get_env(self.sndr_);
+    }
+  };
+
+  template <class SenderId, class ReceiverId, bool MayThrow, class... Stages>
+  struct static_thread_pool::bulk_chain_shared_state {
+    using Sender = stdexec::__t<SenderId>;
+    using Receiver = stdexec::__t<ReceiverId>;
+
+    // The tasks do not wait for each other to start. Instead, the slices of a stage are claimed
+    // by the tasks, each first trying its own, and a task that finishes early runs the slices
+    // that no other task has claimed yet. It then only waits for slices that are being run, so
+    // tasks that are stuck in the queue of a busy thread cannot block the others.
+    struct bulk_task : task_base {
+      bulk_chain_shared_state* sh_state_ = nullptr;
+      // The number of steps for which the slice of this task has been claimed.
+      std::atomic<std::uint64_t> claimed_{0};
+
+      bulk_task() {
+        this->__execute = [](task_base* t, const std::uint32_t /* tid */) noexcept {
+          auto& task = *static_cast<bulk_task*>(t);
+          auto& sh_state = *task.sh_state_;
+          sh_state.run(static_cast<std::uint32_t>(&task - sh_state.tasks_.get()));
+        };
+      }
+    };
+
+    using variant_t = //
+      stdexec::__value_types_of_t<
+        Sender,
+        stdexec::env_of_t<Receiver>,
+        stdexec::__q<stdexec::__decayed_tuple>,
+        stdexec::__q<stdexec::__variant>>;
+
+    variant_t data_;
+    static_thread_pool& pool_;
+    Receiver receiver_;
+    std::tuple<Stages...> stages_;
+    std::uint32_t num_agents_;
+    std::size_t iterations_;
+
+    // The slices of a stage that have finished, summed over all iterations.
+    std::array<std::atomic<std::uint64_t>, sizeof...(Stages)> finished_slices_{};
+    std::atomic<std::uint32_t> finished_threads_{0};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr exception_;
+    std::unique_ptr<bulk_task[]> tasks_;
+
+    template <class Shape>
+    std::uint32_t num_slices(Shape shape) const noexcept {
+      return static_cast<std::uint32_t>(std::min(shape, static_cast<Shape>(num_agents_)));
+    }
+
+    template <class F>
+    void apply(F f) {
+      std::visit(
+        [&](auto& tupl) -> void { std::apply([&](auto&... args) -> void { f(args...); }, tupl); },
+        data_);
+    }
+
+    // A step is a stage of an iteration; the steps are numbered in the order they run.
+    bool try_claim(std::uint32_t slice, std::uint64_t step) noexcept {
+      std::atomic<std::uint64_t>& claimed = tasks_[slice].claimed_;
+      std::uint64_t expected = claimed.load(std::memory_order_relaxed);
+      while (expected <= step) {
+        if (claimed.compare_exchange_weak(expected, step + 1, std::memory_order_relaxed)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    template <std::size_t Stage>
+    void run_stage(std::uint32_t rank, std::size_t iteration) noexcept {
+      auto& stage = std::get<Stage>(stages_);
+      const std::uint32_t n_slices = num_slices(stage.shape_);
+      const std::uint64_t step = iteration * sizeof...(Stages) + Stage;
+      auto run_slice = [&](std::uint32_t slice) noexcept {
+        if (!try_claim(slice, step)) {
+          return;
+        }
+        auto computation = [&](auto&... args) {
+          auto [begin, end] = even_share(stage.shape_, slice, n_slices);
+          run_bulk_range(stage.fun_, begin, end, args...);
+        };
+        if constexpr (MayThrow) {
+          try {
+            apply(computation);
+          } catch (...) {
+            if (!failed_.exchange(true, std::memory_order_relaxed)) {
+              exception_ = std::current_exception();
+            }
+          }
+        } else {
+          apply(computation);
+        }
+        finished_slices_[Stage].fetch_add(1, std::memory_order_release);
+      };
+
+      for (std::uint32_t i = 0; i < n_slices; ++i) {
+        run_slice((rank + i) % n_slices);
+      }
+      // A task that starts late finds the earlier steps finished already.
+      const std::uint64_t finished = (iteration + 1) * n_slices;
+      stdexec::__stok::__spin_wait spin;
+      while (finished_slices_[Stage].load(std::memory_order_acquire) < finished) {
+        spin.__wait();
+      }
+    }
+
+    void run(std::uint32_t rank) noexcept {
+      for (std::size_t iteration = 0; iteration < iterations_; ++iteration) {
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+          // A failed stage ends the chain, like an error completion of a bulk would.
+          ((failed_.load(std::memory_order_relaxed) ? void() : run_stage<Is>(rank, iteration)),
+           ...);
+        }(std::index_sequence_for<Stages...>{});
+      }
+
+      if (finished_threads_.fetch_add(1, std::memory_order_acq_rel) == num_agents_ - 1) {
+        complete();
+      }
+    }
+
+    void complete() noexcept {
+      if constexpr (MayThrow) {
+        if (exception_) {
+          stdexec::set_error((Receiver&&) receiver_, std::move(exception_));
+          return;
+        }
+      }
+      apply([&](auto&... args) {
+        stdexec::set_value((Receiver&&) receiver_, std::move(args)...);
+      });
+    }
+
+    static std::uint32_t num_agents_required(
+      const std::tuple<Stages...>& stages,
+      std::uint32_t parallelism) noexcept {
+      return std::apply(
+        [&](const Stages&... stage) {
+          std::uint32_t agents = 0;
+          ((agents = std::max(
+              agents,
+              static_cast<std::uint32_t>(std::min(
+                stage.shape_, static_cast<typename Stages::Shape>(parallelism))))),
+           ...);
+          return agents;
+        },
+        stages);
+    }
+
+    bulk_chain_shared_state(
+      static_thread_pool& pool,
+      Receiver receiver,
+      std::tuple<Stages...> stages,
+      std::size_t iterations)
+      : pool_{pool}
+      , receiver_{(Receiver&&) receiver}
+      , stages_{std::move(stages)}
+      , num_agents_{num_agents_required(stages_, pool.available_parallelism())}
+      , iterations_{iterations}
+      , tasks_{new bulk_task[num_agents_]} {
+      stdexec::__trace_allocation("static_thread_pool::bulk", num_agents_ * sizeof(bulk_task));
+      for (std::uint32_t i = 0; i < num_agents_; ++i) {
+        tasks_[i].sh_state_ = this;
+      }
+    }
+  };
+
+  template <class SenderId, class ReceiverId, bool MayThrow, class... Stages>
+  struct static_thread_pool::bulk_chain_receiver {
+    using is_receiver = void;
+    using Receiver = stdexec::__t<ReceiverId>;
+
+    using shared_state = bulk_chain_shared_state<SenderId, ReceiverId, MayThrow, Stages...>;
+
+    shared_state& shared_state_;
+
+    void enqueue() noexcept {
+      shared_state_.pool_.bulk_enqueue(shared_state_.tasks_.get(), shared_state_.num_agents_);
+    }
+
+    template <class... As>
+    friend void tag_invoke(
+      stdexec::same_as<stdexec::set_value_t> auto,
+      bulk_chain_receiver&& self,
+      As&&... as) noexcept {
+      using tuple_t = stdexec::__decayed_tuple<As...>;
+
+      shared_state& state = self.shared_state_;
+
+      if constexpr (MayThrow) {
+        try {
+          state.data_.template emplace<tuple_t>((As&&) as...);
+        } catch (...) {
+          stdexec::set_error(std::move(state.receiver_), std::current_exception());
+          return;
+        }
+      } else {
+        state.data_.template emplace<tuple_t>((As&&) as...);
+      }
+
+      if (state.num_agents_ && state.iterations_) {
+        self.enqueue();
+      } else {
+        state.complete();
+      }
+    }
+
+    template <stdexec::__one_of<stdexec::set_error_t, stdexec::set_stopped_t> Tag, class... As>
+    friend void tag_invoke(Tag tag, bulk_chain_receiver&& self, As&&... as) noexcept {
+      shared_state& state = self.shared_state_;
+      tag((Receiver&&) state.receiver_, (As&&) as...);
+    }
+
+    friend auto tag_invoke(stdexec::get_env_t, const bulk_chain_receiver& self) noexcept
+      -> stdexec::env_of_t<Receiver> {
+      return stdexec::get_env(self.shared_state_.receiver_);
+    }
+  };
+
+  template <class SenderId, class ReceiverId, class... Stages>
+  struct static_thread_pool::bulk_chain_op_state {
+    using Sender = stdexec::__t<SenderId>;
+    using Receiver = stdexec::__t<ReceiverId>;
+
+    static constexpr bool may_throw =
+      bulk_chain_may_throw<Sender, stdexec::env_of_t<Receiver>, Stages...>;
+
+    using bulk_rcvr = bulk_chain_receiver<SenderId, ReceiverId, may_throw, Stages...>;
+    using shared_state = bulk_chain_shared_state<SenderId, ReceiverId, may_throw, Stages...>;
+    using inner_op_state = stdexec::connect_result_t<Sender, bulk_rcvr>;
+
+    shared_state shared_state_;
+
+    inner_op_state inner_op_;
+
+    friend void tag_invoke(stdexec::start_t, bulk_chain_op_state& op) noexcept {
+      stdexec::start(op.inner_op_);
+    }
+
+    bulk_chain_op_state(
+      static_thread_pool& pool,
+      std::tuple<Stages...> stages,
+      Sender&& sender,
+      Receiver receiver,
+      std::size_t iterations)
+      : shared_state_(pool, (Receiver&&) receiver, std::move(stages), iterations)
+      , inner_op_{stdexec::connect((Sender&&) sender, bulk_rcvr{shared_state_})} {
+    }
+  };
+
+  //////////////////////////////////////////////////////////////////////////////////////////////////
+  // repeat_n of a bulk chain: the tasks run the steps of all the iterations one after the other,
+  // so the chain is dispatched once. It is a separate sender so that a bulk that follows the
+  // repeat_n is not fused into the repeated chain.
+  template <class SenderId, class... Stages>
+  struct static_thread_pool::bulk_repeat_sender {
+    using is_sender = void;
+    using chain_t = bulk_chain_sender<SenderId, Stages...>;
+    using Sender = stdexec::__t<SenderId>;
+
+    chain_t chain_;
+    std::size_t iterations_;
+
+    template <class Self, class Env>
+    using completion_signatures = //
+      typename chain_t::template completion_signatures<stdexec::__copy_cvref_t<Self, chain_t>, Env>;
+
+    template <class Self, class Receiver>
+    using bulk_op_state_t = typename chain_t::template bulk_op_state_t<
+      stdexec::__copy_cvref_t<Self, chain_t>,
+      Receiver>;
+
+    template <stdexec::__decays_to<bulk_repeat_sender> Self, stdexec::receiver Receiver>
+      requires stdexec::
+        receiver_of<Receiver, completion_signatures<Self, stdexec::env_of_t<Receiver>>>
+      friend bulk_op_state_t<Self, Receiver>                       //
+      tag_invoke(stdexec::connect_t, Self&& self, Receiver&& rcvr) //
+      noexcept(stdexec::__nothrow_constructible_from<
+               bulk_op_state_t<Self, Receiver>,
+               static_thread_pool&,
+               std::tuple<Stages...>,
+               Sender,
+               Receiver,
+               std::size_t>) {
+      return bulk_op_state_t<Self, Receiver>{
+        self.chain_.pool_,
+        self.chain_.stages_,
+        ((Self&&) self).chain_.sndr_,
+        (Receiver&&) rcvr,
+        self.iterations_};
+    }
+
+    template <stdexec::__decays_to<bulk_repeat_sender> Self, class Env>
+    friend auto tag_invoke(stdexec::get_completion_signatures_t, Self&&, Env&&)
+      -> completion_signatures<Self, Env> {
+      return {};
+    }
+
+    friend auto tag_invoke(stdexec::get_env_t, const bulk_repeat_sender& self) noexcept
+      -> stdexec::env_of_t<const Sender&> {
+      return stdexec::get_env(self.chain_.sndr_);
+    }
+  };
+
 } // namespace exec
@@ -349,7 +349,8 @@ namespace exec {
 
       struct __promise
         : __promise_base<_Ty>
-        , with_awaitable_senders<__promise> {
+        , with_awaitable_senders<__promise>
+        , __traced_frame_allocation<"task"__csz> {
         basic_task get_return_object() noexcept {
           return basic_task(__coro::coroutine_handle<__promise>::from_promise(*this));
         }
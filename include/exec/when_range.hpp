@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "../stdexec/__detail/__config.hpp"
+
+#if STDEXEC_HAS_STD_RANGES()
+
+#include "../stdexec/execution.hpp"
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <vector>
+
+namespace exec {
+  /////////////////////////////////////////////////////////////////////////////
+  // when_all_range(range [, allocator]) and when_any_range(range [, allocator])
+  //
+  // The counterparts of when_all and when_any for a number of senders of the
+  // same type that is only known at run time. The child operation states are
+  // placed in a single allocation that is obtained from the given allocator,
+  // and all children share one stop source.
+  //
+  // when_all_range completes with a std::vector of the values of the children
+  // (in the order of the range), whose elements are allocated with the given
+  // allocator as well, or with set_value() if the children do not send a
+  // value. when_any_range completes with the first completion of any
+  // child and requests stop on the others.
+  namespace __when_range {
+    using namespace stdexec;
+
+    enum __state_t {
+      __started,
+      __error,
+      __stopped
+    };
+
+    struct __on_stop_requested {
+      in_place_stop_source& __stop_source_;
+
+      void operator()() noexcept {
+        __stop_source_.request_stop();
+      }
+    };
+
+    template <class _BaseEnv>
+    using __env_t = __make_env_t<_BaseEnv, __with<get_stop_token_t, in_place_stop_token>>;
+
+    template <class _Ret, class... _Args>
+    __decayed_tuple<_Ret, _Args...> __signature_to_tuple_(_Ret (*)(_Args...));
+
+    template <class _Sig>
+    using __signature_to_tuple_t = decltype(__signature_to_tuple_((_Sig*) nullptr));
+
+    template <class... _Args>
+    using __as_rvalues = set_value_t(__decay_t<_Args>&&...);
+
+    template <class... _Errors>
+    using __as_errors = completion_signatures<set_error_t(__decay_t<_Errors>&&)...>;
+
+    template <class _Sender, class _Env>
+    using __value_t = __decay_t<__single_sender_value_t<_Sender, __env_t<_Env>>>;
+
+    template <class _Value, class _Alloc>
+    using __values_t =
+      std::vector<_Value, typename std::allocator_traits<_Alloc>::template rebind_alloc<_Value>>;
+
+    template <class _Value, class _Alloc>
+    struct __all_value_sig {
+      using __t = completion_signatures<set_value_t(__values_t<_Value, _Alloc>)>;
+    };
+
+    template <class _Alloc>
+    struct __all_value_sig<void, _Alloc> {
+      using __t = completion_signatures<set_value_t()>;
+    };
+
+    template <bool _All, class _Sender, class _Env, class _Alloc>
+    struct __completions;
+
+    template <class _Sender, class _Env, class _Alloc>
+    struct __completions<true, _Sender, _Env, _Alloc> {
+      using __t = __concat_completion_signatures_t<
+        completion_signatures<set_stopped_t(), set_error_t(std::exception_ptr)>,
+        stdexec::__t<__all_value_sig<__value_t<_Sender, _Env>, _Alloc>>,
+        error_types_of_t<_Sender, __env_t<_Env>, __as_errors>>;
+    };
+
+    template <class _Sender, class _Env, class _Alloc>
+    struct __completions<false, _Sender, _Env, _Alloc> {
+      using __t = __concat_completion_signatures_t<
+        completion_signatures<set_stopped_t(), set_error_t(std::exception_ptr)>,
+        value_types_of_t<_Sender, __env_t<_Env>, __as_rvalues, completion_signatures>,
+        error_types_of_t<_Sender, __env_t<_Env>, __as_errors>>;
+    };
+
+    template <bool _All, class _Sender, class _Env, class _Alloc>
+    using __completions_t = stdexec::__t<__completions<_All, _Sender, _Env, _Alloc>>;
+
+    template <bool _All, class _Sender, class _Env>
+    struct __stored_value {
+      using __t = void;
+    };
+
+    template <class _Sender, class _Env>
+    struct __stored_value<true, _Sender, _Env> {
+      using __t = __value_t<_Sender, _Env>;
+    };
+
+    // when_all_range stores the errors and when_any_range the first completion.
+    template <bool _All, class _Sender, class _Env, class _Alloc>
+    using __result_variant_t = __mapply<
+      __transform<__q<__signature_to_tuple_t>, __nullable_variant_t>,
+      __if_c<
+        _All,
+        __concat_completion_signatures_t<
+          completion_signatures<set_error_t(std::exception_ptr)>,
+          error_types_of_t<_Sender, __env_t<_Env>, __as_errors>>,
+        __completions_t<false, _Sender, _Env, _Alloc>>>;
+
+    template <class _Op, class _Env>
+    struct __receiver {
+      struct __t {
+        using __id = __receiver;
+        using is_receiver = void;
+        _Op* __op_;
+        std::size_t __index_;
+
+        template <__completion_tag _Tag, same_as<__t> _Self, class... _As>
+        friend void tag_invoke(_Tag, _Self&& __self, _As&&... __as) noexcept {
+          __self.__op_->__notify(__self.__index_, _Tag{}, static_cast<_As&&>(__as)...);
+        }
+
+        template <same_as<get_env_t> _GetEnv, same_as<__t> _Self>
+        friend auto tag_invoke(_GetEnv, const _Self& __self) noexcept -> __env_t<_Env> {
+          return __make_env(
+            stdexec::get_env(__self.__op_->__rcvr_),
+            __with_(get_stop_token, __self.__op_->__stop_source_.get_token()));
+        }
+      };
+    };
+
+    // One child of the operation. when_all_range stores the value of the child
+    // next to its operation state.
+    template <class _Sender, class _Receiver, class _Value>
+    struct __child {
+      __child(_Sender&& __sndr, _Receiver __rcvr)
+        : __op_(
+          stdexec::connect(static_cast<_Sender&&>(__sndr), static_cast<_Receiver&&>(__rcvr))) {
+      }
+
+      connect_result_t<_Sender, _Receiver> __op_;
+      std::optional<_Value> __value_{};
+    };
+
+    template <class _Sender, class _Receiver>
+    struct __child<_Sender, _Receiver, void> {
+      __child(_Sender&& __sndr, _Receiver __rcvr)
+        : __op_(
+          stdexec::connect(static_cast<_Sender&&>(__sndr), static_cast<_Receiver&&>(__rcvr))) {
+      }
+
+      connect_result_t<_Sender, _Receiver> __op_;
+    };
+
+    template <bool _All, class _Range, class _Sender, class _ReceiverId, class _Alloc>
+    struct __operation {
+      using _Receiver = stdexec::__t<_ReceiverId>;
+      using _Env = env_of_t<_Receiver>;
+
+      struct __t : __immovable {
+        using __id = __operation;
+        using __value_type = stdexec::__t<__stored_value<_All, _Sender, _Env>>;
+        using __receiver_t = stdexec::__t<__receiver<__t, _Env>>;
+        using __child_t = __child<_Sender, __receiver_t, __value_type>;
+        using __alloc_t = typename std::allocator_traits<_Alloc>::template rebind_alloc<__child_t>;
+        using __alloc_traits = std::allocator_traits<__alloc_t>;
+        using __on_stop_t =
+          typename stop_token_of_t<_Env&>::template callback_type<__on_stop_requested>;
+
+        STDEXEC_NO_UNIQUE_ADDRESS _Receiver __rcvr_;
+        STDEXEC_NO_UNIQUE_ADDRESS __alloc_t __alloc_;
+        std::size_t __size_;
+        __child_t* __children_{nullptr};
+        std::atomic<std::size_t> __count_;
+        in_place_stop_source __stop_source_{};
+        std::optional<__on_stop_t> __on_stop_{};
+        std::atomic<__state_t> __state_{__started};
+        __result_variant_t<_All, _Sender, _Env, _Alloc> __result_{};
+
+        __t(_Range&& __range, _Receiver __rcvr, _Alloc __alloc)
+          : __rcvr_(static_cast<_Receiver&&>(__rcvr))
+          , __alloc_(static_cast<_Alloc&&>(__alloc))
+          , __size_(static_cast<std::size_t>(std::ranges::distance(__range)))
+          , __count_(__size_) {
+          stdexec::__trace_allocation("when_range", __size_ * sizeof(__child_t));
+          __children_ = __alloc_traits::allocate(__alloc_, __size_);
+          std::size_t __i = 0;
+          try {
+            for (auto&& __sndr: __range) {
+              __alloc_traits::construct(
+                __alloc_,
+                __children_ + __i,
+                static_cast<__copy_cvref_t<_Range&&, _Sender>>(__sndr),
+                __receiver_t{this, __i});
+              ++__i;
+            }
+          } catch (...) {
+            __destroy_(__i);
+            throw;
+          }
+        }
+
+        ~__t() {
+          __destroy_(__size_);
+        }
+
+        void __destroy_(std::size_t __n) noexcept {
+          if (__children_ != nullptr) {
+            for (std::size_t __i = 0; __i < __n; ++__i) {
+              __alloc_traits::destroy(__alloc_, __children_ + __i);
+            }
+            __alloc_traits::deallocate(__alloc_, __children_, __size_);
+            __children_ = nullptr;
+          }
+        }
+
+        template <class... _As>
+        void __emplace_result_(_As&&... __as) noexcept {
+          try {
+            __result_.template emplace<__decayed_tuple<_As...>>(static_cast<_As&&>(__as)...);
+          } catch (...) {
+            __result_.template emplace<std::tuple<set_error_t, std::exception_ptr>>(
+              set_error, std::current_exception());
+          }
+        }
+
+        template <class _Tag, class... _As>
+        void __notify(std::size_t __index, _Tag, _As&&... __as) noexcept {
+          if constexpr (_All) {
+            if constexpr (same_as<_Tag, set_value_t>) {
+              if constexpr (!same_as<__value_type, void>) {
+                if (__state_.load(std::memory_order_relaxed) == __started) {
+                  try {
+                    __children_[__index].__value_.emplace(static_cast<_As&&>(__as)...);
+                  } catch (...) {
+                    __set_error_(std::current_exception());
+                  }
+                }
+              }
+            } else if constexpr (same_as<_Tag, set_error_t>) {
+              __set_error_(static_cast<_As&&>(__as)...);
+            } else {
+              __state_t __expected = __started;
+              if (__state_.compare_exchange_strong(__expected, __stopped)) {
+                __stop_source_.request_stop();
+              }
+            }
+          } else {
+            __state_t __expected = __started;
+            if (__state_.compare_exchange_strong(__expected, __stopped)) {
+              __emplace_result_(_Tag{}, static_cast<_As&&>(__as)...);
+              __stop_source_.request_stop();
+            }
+          }
+          __arrive();
+        }
+
+        template <class _Error>
+        void __set_error_(_Error&& __err) noexcept {
+          if (__state_.exchange(__error) != __error) {
+            __stop_source_.request_stop();
+            __emplace_result_(set_error, static_cast<_Error&&>(__err));
+          }
+        }
+
+        void __arrive() noexcept {
+          if (__count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            __complete();
+          }
+        }
+
+        void __complete() noexcept {
+          __on_stop_.reset();
+          if constexpr (_All) {
+            if (__state_.load(std::memory_order_relaxed) == __started) {
+              if constexpr (same_as<__value_type, void>) {
+                stdexec::set_value(static_cast<_Receiver&&>(__rcvr_));
+              } else {
+                try {
+                  using __values_alloc_t =
+                    typename __alloc_traits::template rebind_alloc<__value_type>;
+                  __values_t<__value_type, _Alloc> __values{__values_alloc_t{__alloc_}};
+                  stdexec::__trace_allocation("when_range", __size_ * sizeof(__value_type));
+                  __values.reserve(__size_);
+                  for (std::size_t __i = 0; __i < __size_; ++__i) {
+                    __values.push_back(std::move(*__children_[__i].__value_));
+                  }
+                  stdexec::set_value(static_cast<_Receiver&&>(__rcvr_), std::move(__values));
+                } catch (...) {
+                  stdexec::set_error(static_cast<_Receiver&&>(__rcvr_), std::current_exception());
+                }
+              }
+              return;
+            }
+          }
+          if (__result_.index() == 0) {
+            stdexec::set_stopped(static_cast<_Receiver&&>(__rcvr_));
+            return;
+          }
+          std::visit(
+            [&]<class _Tuple>(_Tuple& __tupl) noexcept -> void {
+              if constexpr (!same_as<_Tuple, std::monostate>) {
+                std::apply(
+                  [&]<class _Tag, class... _As>(_Tag __tag, _As&... __as) noexcept {
+                    __tag(static_cast<_Receiver&&>(__rcvr_), static_cast<_As&&>(__as)...);
+                  },
+                  __tupl);
+              }
+            },
+            __result_);
+        }
+
+        friend void tag_invoke(start_t, __t& __self) noexcept {
+          __self.__on_stop_.emplace(
+            get_stop_token(get_env(__self.__rcvr_)), __on_stop_requested{__self.__stop_source_});
+          if (__self.__stop_source_.stop_requested()) {
+            // Stop has already been requested. Don't bother starting the
+            // child operations.
+            __self.__on_stop_.reset();
+            stdexec::set_stopped(static_cast<_Receiver&&>(__self.__rcvr_));
+          } else if (__self.__size_ == 0) {
+            __self.__complete();
+          } else {
+            for (std::size_t __i = 0, __n = __self.__size_; __i < __n; ++__i) {
+              stdexec::start(__self.__children_[__i].__op_);
+            }
+          }
+        }
+      };
+    };
+
+    template <bool _All, class _Range, class _Alloc>
+    struct __sender {
+      using _Sender = std::ranges::range_value_t<_Range>;
+
+      template <class _Self, class _Receiver>
+      using __operation_t = stdexec::__t<__operation<
+        _All,
+        __copy_cvref_t<_Self, _Range>,
+        _Sender,
+        stdexec::__id<_Receiver>,
+        _Alloc>>;
+
+      struct __t {
+        using __id = __sender;
+        using is_sender = void;
+
+        _Range __range_;
+        STDEXEC_NO_UNIQUE_ADDRESS _Alloc __alloc_;
+
+        template <__decays_to<__t> _Self, receiver _Receiver>
+          requires receiver_of<
+            _Receiver,
+            __completions_t<_All, _Sender, env_of_t<_Receiver>, _Alloc>>
+        friend auto tag_invoke(connect_t, _Self&& __self, _Receiver __rcvr)
+          -> __operation_t<_Self, _Receiver> {
+          return {
+            static_cast<_Self&&>(__self).__range_,
+            static_cast<_Receiver&&>(__rcvr),
+            static_cast<_Self&&>(__self).__alloc_};
+        }
+
+        template <__decays_to<__t> _Self, class _Env>
+        friend auto tag_invoke(get_completion_signatures_t, _Self&&, _Env&&)
+          -> __completions_t<_All, _Sender, _Env, _Alloc> {
+          return {};
+        }
+
+        friend empty_env tag_invoke(get_env_t, const __t&) noexcept {
+          return {};
+        }
+      };
+    };
+
+    template <bool _All>
+    struct __when_range_t {
+      template <std::ranges::forward_range _Range, class _Alloc = std::allocator<std::byte>>
+        requires std::ranges::sized_range<_Range> && sender<std::ranges::range_value_t<_Range>>
+              && __decay_copyable<_Range>
+      auto operator()(_Range&& __range, _Alloc __alloc = _Alloc{}) const
+        -> stdexec::__t<__sender<_All, __decay_t<_Range>, _Alloc>> {
+        return {static_cast<_Range&&>(__range), static_cast<_Alloc&&>(__alloc)};
+      }
+    };
+
+    using when_all_range_t = __when_range_t<true>;
+    using when_any_range_t = __when_range_t<false>;
+  } // namespace __when_range
+
+  using __when_range::when_all_range_t;
+  inline constexpr when_all_range_t when_all_range{};
+
+  using __when_range::when_any_range_t;
+  inline constexpr when_any_range_t when_any_range{};
+} // namespace exec
+
+#endif // STDEXEC_HAS_STD_RANGES()
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "__config.hpp"
+#include "__meta.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+// When STDEXEC_ALLOCATION_HOOKS is defined to a nonzero value, every
+// allocation that stdexec and exec make on their own behalf is reported to
+// the function installed with exec::set_allocation_hook, together with the
+// name of the algorithm that allocates and the number of bytes. Otherwise
+// the reporting compiles away. The macro must have the same value in every
+// translation unit of a program.
+#ifndef STDEXEC_ALLOCATION_HOOKS
+#define STDEXEC_ALLOCATION_HOOKS 0
+#endif
+
+namespace stdexec {
+  using __allocation_hook_t = void (*)(const char* __algorithm, std::size_t __size) noexcept;
+
+  inline std::atomic<__allocation_hook_t> __allocation_hook{nullptr};
+
+  // Every internal allocation is reported through this function.
+  inline void __trace_allocation(
+    [[maybe_unused]] const char* __algorithm,
+    [[maybe_unused]] std::size_t __size) noexcept {
+#if STDEXEC_ALLOCATION_HOOKS
+    if (__allocation_hook_t __hook = __allocation_hook.load(std::memory_order_acquire)) {
+      __hook(__algorithm, __size);
+    }
+#endif
+  }
+
+  // A base for the promise types of coroutines created by the library, so
+  // that their frame allocations are reported as well.
+  template <__mstring _Algorithm>
+  struct __traced_frame_allocation {
+#if STDEXEC_ALLOCATION_HOOKS
+    static void* operator new(std::size_t __size) {
+      stdexec::__trace_allocation(_Algorithm.__what_, __size);
+      return ::operator new(__size);
+    }
+
+    static void operator delete(void* __pointer, std::size_t __size) noexcept {
+      ::operator delete(__pointer, __size);
+    }
+#endif
+  };
+} // namespace stdexec
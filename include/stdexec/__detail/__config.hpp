@@ -148,6 +148,19 @@
 #define STDEXEC_IMMOVABLE_NO_UNIQUE_ADDRESS [[no_unique_address]]
 #endif
 
+// The distance that keeps data written by different threads out of the same
+// cache line. GCC warns that std::hardware_destructive_interference_size
+// depends on the tuning flags, so it is not used there. Define
+// STDEXEC_DESTRUCTIVE_INTERFERENCE_SIZE to override.
+#ifndef STDEXEC_DESTRUCTIVE_INTERFERENCE_SIZE
+#if defined(__cpp_lib_hardware_interference_size) && !STDEXEC_GCC()
+#include <new>
+#define STDEXEC_DESTRUCTIVE_INTERFERENCE_SIZE std::hardware_destructive_interference_size
+#else
+#define STDEXEC_DESTRUCTIVE_INTERFERENCE_SIZE 64
+#endif
+#endif
+
 #if STDEXEC_CLANG() && defined(__CUDACC__)
 #define STDEXEC_DETAIL_CUDACC_HOST_DEVICE __host__ __device__
 #else
@@ -151,7 +151,7 @@ namespace stdexec {
 
   template <class _Ty>
   concept swappable = //
-    swappable_with<_Ty, _Ty>;
+    swappable_with<_Ty&, _Ty&>;
 
   template < class _Ty >
   concept movable =               //
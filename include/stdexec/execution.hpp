@@ -30,6 +30,7 @@
 
 #include "__detail/__execution_fwd.hpp"
 
+#include "__detail/__allocation_hooks.hpp"
 #include "__detail/__intrusive_ptr.hpp"
 #include "__detail/__meta.hpp"
 #include "__detail/__scope.hpp"
@@ -1764,7 +1765,7 @@ namespace stdexec {
   /////////////////////////////////////////////////////////////////////////////
   // __connect_awaitable_
   namespace __connect_awaitable_ {
-    struct __promise_base {
+    struct __promise_base : __traced_frame_allocation<"connect_awaitable"__csz> {
       __coro::suspend_always initial_suspend() noexcept {
         return {};
       }
@@ -2440,6 +2441,9 @@ namespace stdexec {
     struct __submit_t {
       template <receiver _Receiver, sender_to<_Receiver> _Sender>
       void operator()(_Sender&& __sndr, _Receiver __rcvr) const noexcept(false) {
+        // __submit implements start_detached and execute
+        stdexec::__trace_allocation(
+          "start_detached", sizeof(__operation<__id<_Sender>, __id<_Receiver>>));
         start((new __operation<__id<_Sender>, __id<_Receiver>>{
                  (_Sender&&) __sndr, (_Receiver&&) __rcvr})
                 ->__op_state_);
@@ -3211,13 +3215,60 @@ namespace stdexec {
       }
     };
 
+    template <class _Fun1, class _Fun2, class... _As>
+    using __composed_result_t = //
+      __minvoke<
+        __remove<void, __mbind_front_q<std::invoke_result_t, _Fun2>>,
+        std::invoke_result_t<_Fun1, _As...>>;
+
+    template <class _Fun, class... _As>
+    using __nothrow_invocable_t = __mbool<__nothrow_invocable<_Fun, _As...>>;
+
+    template <class _Fun1, class _Fun2, class... _As>
+    concept __nothrow_composable = //
+      __nothrow_invocable<_Fun1, _As...>
+      && __v<__minvoke<
+        __remove<void, __mbind_front_q<__nothrow_invocable_t, _Fun2>>,
+        std::invoke_result_t<_Fun1, _As...>>>;
+
+    // then(then(s, f), g) is built as then(s, __compose{f, g}), so a chain of
+    // thens connects to a single receiver and operation state. When f returns
+    // void, g is invoked with no arguments, as the second then would do.
+    template <class _Fun1, class _Fun2>
+    struct __compose {
+      STDEXEC_NO_UNIQUE_ADDRESS _Fun1 __fun1_;
+      STDEXEC_NO_UNIQUE_ADDRESS _Fun2 __fun2_;
+
+      template <class... _As>
+        requires __mvalid<__composed_result_t, _Fun1, _Fun2, _As...>
+      auto operator()(_As&&... __as) && noexcept(__nothrow_composable<_Fun1, _Fun2, _As...>)
+        -> __composed_result_t<_Fun1, _Fun2, _As...> {
+        if constexpr (same_as<void, std::invoke_result_t<_Fun1, _As...>>) {
+          std::invoke((_Fun1&&) __fun1_, (_As&&) __as...);
+          return std::invoke((_Fun2&&) __fun2_);
+        } else {
+          return std::invoke((_Fun2&&) __fun2_, std::invoke((_Fun1&&) __fun1_, (_As&&) __as...));
+        }
+      }
+    };
+
     ////////////////////////////////////////////////////////////////////////////////////////////////
     struct then_t : __default_get_env<then_t> {
       template <sender _Sender, __movable_value _Fun>
       auto operator()(_Sender&& __sndr, _Fun __fun) const {
-        auto __domain = __get_sender_domain((_Sender&&) __sndr);
-        return transform_sender(
-          __domain, make_sender_expr<then_t>((_Fun&&) __fun, (_Sender&&) __sndr));
+        if constexpr (sender_expr_for<_Sender, then_t>) {
+          return apply_sender(
+            (_Sender&&) __sndr,
+            [&]<class _Fun1, class _Child>(then_t, _Fun1&& __fun1, _Child&& __child) {
+              return (*this)(
+                (_Child&&) __child,
+                __compose<__decay_t<_Fun1>, _Fun>{(_Fun1&&) __fun1, (_Fun&&) __fun});
+            });
+        } else {
+          auto __domain = __get_sender_domain((_Sender&&) __sndr);
+          return transform_sender(
+            __domain, make_sender_expr<then_t>((_Fun&&) __fun, (_Sender&&) __sndr));
+        }
       }
 
       template <__movable_value _Fun>
@@ -3499,9 +3550,15 @@ namespace stdexec {
       template <sender _Sender, __movable_value _Fun>
         requires __callable<_Fun>
       auto operator()(_Sender&& __sndr, _Fun __fun) const {
-        auto __domain = __get_sender_domain((_Sender&&) __sndr, set_stopped);
-        return transform_sender(
-          __domain, make_sender_expr<upon_stopped_t>((_Fun&&) __fun, (_Sender&&) __sndr));
+        if constexpr (sender_expr_for<_Sender, upon_stopped_t>) {
+          // The inner upon_stopped turns set_stopped into set_value, so __fun
+          // would never be called. Drop it along with its operation state.
+          return __decay_t<_Sender>((_Sender&&) __sndr);
+        } else {
+          auto __domain = __get_sender_domain((_Sender&&) __sndr, set_stopped);
+          return transform_sender(
+            __domain, make_sender_expr<upon_stopped_t>((_Fun&&) __fun, (_Sender&&) __sndr));
+        }
       }
 
       template <__movable_value _Fun>
@@ -4048,6 +4105,7 @@ namespace stdexec {
         return apply_sender(
           (_Sender&&) __sndr, [&]<class _Child>(__ignore, __ignore, _Child&& __child) {
             using __sh_state_t = __t<__sh_state<__cvref_id<_Child>, __id<_Env>...>>;
+            stdexec::__trace_allocation("split", sizeof(__sh_state_t));
             auto __sh_state = std::make_shared<__sh_state_t>(
               (_Child&&) __child, std::move(__env)...);
             return make_sender_expr<__split_t>(std::move(__sh_state));
@@ -4071,28 +4129,42 @@ namespace stdexec {
         _BaseEnv, // NOT TO SPEC
         __with<get_stop_token_t, in_place_stop_token>>;
 
-    template <class _CvrefSenderId, class _EnvId>
+    // Where the shared state lives, and how it is reference counted. By
+    // default, it is allocated on the heap and owned by __intrusive_ptr.
+    struct __heap_storage {
+      template <class _Ty>
+      using __pointer_t = __intrusive_ptr<_Ty>;
+
+      template <class _Ty>
+      using __enable_from_this_t = __enable_intrusive_from_this<_Ty>;
+    };
+
+    template <class _CvrefSenderId, class _EnvId, class _Storage>
     struct __sh_state;
 
-    template <class _CvrefSenderId, class _EnvId>
+    template <class _CvrefSenderId, class _EnvId, class _Storage>
+    using __sh_state_t = stdexec::__t<__sh_state<_CvrefSenderId, _EnvId, _Storage>>;
+
+    template <class _CvrefSenderId, class _EnvId, class _Storage>
     struct __receiver {
       using _CvrefSender = stdexec::__cvref_t<_CvrefSenderId>;
       using _Env = stdexec::__t<_EnvId>;
+      using __sh_state_t = __ensure_started::__sh_state_t<_CvrefSenderId, _EnvId, _Storage>;
 
       class __t {
-        __intrusive_ptr<stdexec::__t<__sh_state<_CvrefSenderId, _EnvId>>> __shared_state_;
+        typename _Storage::template __pointer_t<__sh_state_t> __shared_state_;
 
        public:
         using is_receiver = void;
         using __id = __receiver;
 
-        explicit __t(stdexec::__t<__sh_state<_CvrefSenderId, _EnvId>>& __shared_state) noexcept
+        explicit __t(__sh_state_t& __shared_state) noexcept
           : __shared_state_(__shared_state.__intrusive_from_this()) {
         }
 
         template <__completion_tag _Tag, class... _As>
         friend void tag_invoke(_Tag __tag, __t&& __self, _As&&... __as) noexcept {
-          stdexec::__t<__sh_state<_CvrefSenderId, _EnvId>>& __state = *__self.__shared_state_;
+          __sh_state_t& __state = *__self.__shared_state_;
 
           try {
             using __tuple_t = __decayed_tuple<_Tag, _As...>;
@@ -4117,13 +4189,17 @@ namespace stdexec {
       __notify_fn* __notify_{};
     };
 
-    template <class _CvrefSenderId, class _EnvId = __id<empty_env>>
+    template <
+      class _CvrefSenderId,
+      class _EnvId = __id<empty_env>,
+      class _Storage = __heap_storage>
     struct __sh_state {
       using _CvrefSender = stdexec::__cvref_t<_CvrefSenderId>;
       using _Env = stdexec::__t<_EnvId>;
 
-      struct __t : __enable_intrusive_from_this<__t> {
+      struct __t : _Storage::template __enable_from_this_t<__t> {
         using __id = __sh_state;
+        using __pointer_t = typename _Storage::template __pointer_t<__t>;
 
         template <class... _Ts>
         using __bind_tuples = //
@@ -4146,7 +4222,7 @@ namespace stdexec {
             __env_t<_Env>,
             __transform< __mbind_front_q<__decayed_tuple, set_error_t>, __bound_values_t>>;
 
-        using __receiver_t = stdexec::__t<__receiver<_CvrefSenderId, _EnvId>>;
+        using __receiver_t = stdexec::__t<__receiver<_CvrefSenderId, _EnvId, _Storage>>;
 
         __variant_t __data_;
         in_place_stop_source __stop_source_{};
@@ -4176,11 +4252,12 @@ namespace stdexec {
       };
     };
 
-    template <class _CvrefSenderId, class _EnvId, class _ReceiverId>
+    template <class _CvrefSenderId, class _EnvId, class _Storage, class _ReceiverId>
     struct __operation {
       using _CvrefSender = stdexec::__cvref_t<_CvrefSenderId>;
       using _Env = stdexec::__t<_EnvId>;
       using _Receiver = stdexec::__t<_ReceiverId>;
+      using __sh_state_t = __ensure_started::__sh_state_t<_CvrefSenderId, _EnvId, _Storage>;
 
       class __t : public __operation_base {
         struct __on_stop_requested {
@@ -4197,14 +4274,12 @@ namespace stdexec {
 
         _Receiver __rcvr_;
         __on_stop __on_stop_{};
-        __intrusive_ptr<stdexec::__t<__sh_state<_CvrefSenderId, _EnvId>>> __shared_state_;
+        typename __sh_state_t::__pointer_t __shared_state_;
 
        public:
         using __id = __operation;
 
-        __t(                                                                                //
-          _Receiver __rcvr,                                                                 //
-          __intrusive_ptr<stdexec::__t<__sh_state<_CvrefSenderId, _EnvId>>> __shared_state) //
+        __t(_Receiver __rcvr, typename __sh_state_t::__pointer_t __shared_state) //
           noexcept(std::is_nothrow_move_constructible_v<_Receiver>)
           : __operation_base{__notify}
           , __rcvr_((_Receiver&&) __rcvr)
@@ -4237,8 +4312,7 @@ namespace stdexec {
         }
 
         friend void tag_invoke(start_t, __t& __self) noexcept {
-          stdexec::__t<__sh_state<_CvrefSenderId, _EnvId>>* __shared_state =
-            __self.__shared_state_.get();
+          __sh_state_t* __shared_state = __self.__shared_state_.get();
           std::atomic<void*>& __op_state1 = __shared_state->__op_state1_;
           void* const __completion_state = static_cast<void*>(__shared_state);
           void* const __old = __op_state1.load(std::memory_order_acquire);
@@ -4273,7 +4347,7 @@ namespace stdexec {
 
     template <class _ShState>
     struct __data {
-      __data(__intrusive_ptr<_ShState> __sh_state) noexcept
+      __data(typename _ShState::__pointer_t __sh_state) noexcept
         : __sh_state_(std::move(__sh_state)) {
       }
 
@@ -4288,7 +4362,7 @@ namespace stdexec {
         }
       }
 
-      __intrusive_ptr<_ShState> __sh_state_;
+      typename _ShState::__pointer_t __sh_state_;
     };
 
     struct __ensure_started_t {
@@ -4305,7 +4379,7 @@ namespace stdexec {
       template <class _Ty>
       using __set_error_t = completion_signatures<set_error_t(__decay_t<_Ty>&&)>;
 
-      template <class _CvrefSenderId, class _EnvId>
+      template <class _CvrefSenderId, class _EnvId, class _Storage>
       using __completions_t = //
         __try_make_completion_signatures<
           // NOT TO SPEC:
@@ -4396,9 +4470,11 @@ namespace stdexec {
         return apply_sender(
           (_Sender&&) __sndr, [&]<class _Child>(__ignore, __ignore, _Child&& __child) {
             using __sh_state_t = __t<__sh_state<__cvref_id<_Child>, __id<_Env>...>>;
+            stdexec::__trace_allocation("ensure_started", sizeof(__sh_state_t));
             auto __sh_state = __make_intrusive<__sh_state_t>(
               (_Child&&) __child, std::move(__env)...);
-            return make_sender_expr<__ensure_started_t>(__data{std::move(__sh_state)});
+            return make_sender_expr<__ensure_started_t>(
+              __data<__sh_state_t>{std::move(__sh_state)});
           });
       }
     };
@@ -4467,26 +4543,40 @@ namespace stdexec {
     template <class _Env, class _Fun, class _Set, class _Sig>
     using __tfx_signal_t = __minvoke<__tfx_signal_<_Set, _Sig>, _Env, _Fun>;
 
-    template <class _ReceiverId, class _Fun, class _Set, class... _Tuples>
+    template <class _CvrefSenderId, class _ReceiverId, class _Fun, class _Set, class... _Tuples>
+    struct __receiver_;
+
+    template <class _CvrefSenderId, class _ReceiverId, class _Fun, class _Set, class... _Tuples>
     struct __operation_base_ {
+      using _Sender = stdexec::__cvref_t<_CvrefSenderId>;
       using _Receiver = stdexec::__t<_ReceiverId>;
 
       struct __t : __immovable {
         using __id = __operation_base_;
+        using __receiver_t =
+          stdexec::__t<__receiver_<_CvrefSenderId, _ReceiverId, _Fun, _Set, _Tuples...>>;
+        using __child_op_t = connect_result_t<_Sender, __receiver_t>;
         using __results_variant_t = std::variant<std::monostate, _Tuples...>;
-        using __op_state_variant_t = //
+        // The operation state of the predecessor and those of the possible
+        // successors share one variant. The predecessor's results are moved
+        // into __args_ before its operation state is destroyed to make room
+        // for the successor's. __args_ must outlive the successor, since the
+        // successor sender was made from references to the results.
+        using __ops_variant_t = //
           __minvoke<
-            __transform< __uncurry<__op_state_for<_Receiver, _Fun, _Set>>, __nullable_variant_t>,
+            __transform<
+              __uncurry<__op_state_for<_Receiver, _Fun, _Set>>,
+              __mbind_front<__nullable_variant_t, __child_op_t>>,
             _Tuples...>;
 
         _Receiver __rcvr_;
         _Fun __fun_;
         __results_variant_t __args_;
-        __op_state_variant_t __op_state3_;
+        __ops_variant_t __ops_;
       };
     };
 
-    template <class _ReceiverId, class _Fun, class _Set, class... _Tuples>
+    template <class _CvrefSenderId, class _ReceiverId, class _Fun, class _Set, class... _Tuples>
     struct __receiver_ {
       using _Receiver = stdexec::__t<_ReceiverId>;
       using _Env = env_of_t<_Receiver>;
@@ -4500,19 +4590,20 @@ namespace stdexec {
                && __minvocable<__result_sender<_Fun, _Set>, _As...>
                && sender_to<__minvoke<__result_sender<_Fun, _Set>, _As...>, _Receiver>
         friend void tag_invoke(_Tag, __t&& __self, _As&&... __as) noexcept {
+          // __self lives in the predecessor's operation state, which is
+          // destroyed when the successor's is emplaced.
+          __operation_base_t* __op_state = __self.__op_state_;
           try {
             using __tuple_t = __decayed_tuple<_As...>;
             using __op_state_t = __minvoke<__op_state_for<_Receiver, _Fun, _Set>, _As...>;
-            auto& __args = __self.__op_state_->__args_.template emplace<__tuple_t>((_As&&) __as...);
-            auto& __op = __self.__op_state_->__op_state3_.template emplace<__op_state_t>(
-              __conv{[&] {
-                return connect(
-                  std::apply(std::move(__self.__op_state_->__fun_), __args),
-                  std::move(__self.__op_state_->__rcvr_));
-              }});
+            auto& __args = __op_state->__args_.template emplace<__tuple_t>((_As&&) __as...);
+            auto& __op = __op_state->__ops_.template emplace<__op_state_t>(__conv{[&] {
+              return connect(
+                std::apply(std::move(__op_state->__fun_), __args), std::move(__op_state->__rcvr_));
+            }});
             start(__op);
           } catch (...) {
-            set_error(std::move(__self.__op_state_->__rcvr_), std::current_exception());
+            set_error(std::move(__op_state->__rcvr_), std::current_exception());
           }
         }
 
@@ -4527,7 +4618,7 @@ namespace stdexec {
         }
 
         using __operation_base_t =
-          stdexec::__t<__operation_base_<_ReceiverId, _Fun, _Set, _Tuples...>>;
+          stdexec::__t<__operation_base_<_CvrefSenderId, _ReceiverId, _Fun, _Set, _Tuples...>>;
         __operation_base_t* __op_state_;
       };
     };
@@ -4539,7 +4630,7 @@ namespace stdexec {
         __cvref_t<_CvrefSenderId>,
         env_of_t<__t<_ReceiverId>>,
         __q<__decayed_tuple>,
-        __munique<__mbind_front_q<__receiver_, _ReceiverId, _Fun, _Set>>>>;
+        __munique<__mbind_front_q<__receiver_, _CvrefSenderId, _ReceiverId, _Fun, _Set>>>>;
 
     template <class _CvrefSenderId, class _ReceiverId, class _Fun, class _Set>
     using __operation_base =
@@ -4553,18 +4644,18 @@ namespace stdexec {
         using __id = __operation;
         using __op_base_t = __operation_base<_CvrefSenderId, _ReceiverId, _Fun, _Set>;
         using __receiver_t = __receiver<_CvrefSenderId, _ReceiverId, _Fun, _Set>;
+        using __child_op_t = typename __op_base_t::__child_op_t;
 
         friend void tag_invoke(start_t, __t& __self) noexcept {
-          start(__self.__op_state2_);
+          start(std::get<__child_op_t>(__self.__ops_));
         }
 
         template <class _Receiver2>
         __t(_Sender&& __sndr, _Receiver2&& __rcvr, _Fun __fun)
-          : __op_base_t{{}, (_Receiver2&&) __rcvr, (_Fun&&) __fun}
-          , __op_state2_(connect((_Sender&&) __sndr, __receiver_t{this})) {
+          : __op_base_t{{}, (_Receiver2&&) __rcvr, (_Fun&&) __fun} {
+          this->__ops_.template emplace<__child_op_t>(
+            __conv{[&] { return connect((_Sender&&) __sndr, __receiver_t{this}); }});
         }
-
-        connect_result_t<_Sender, __receiver_t> __op_state2_;
       };
     };
 
@@ -6012,9 +6103,34 @@ namespace stdexec {
         __values);
     }
 
+    // Children that complete on different threads write their values and
+    // decrement the count of the operation concurrently. When that can happen,
+    // each of these is followed by a cache line of padding so that the writes
+    // do not contend for the same line. Padding is used rather than
+    // over-alignment, which not every allocator or coroutine frame honors.
+    template <bool _Padded>
+    struct __cache_line_pad { };
+
+    template <>
+    struct __cache_line_pad<true> {
+      char __pad_[STDEXEC_DESTRUCTIVE_INTERFERENCE_SIZE];
+    };
+
+    template <class _Ty>
+    struct __padded
+      : _Ty
+      , __cache_line_pad<true> { };
+
+    template <class _ValuesTuple>
+    inline constexpr bool __is_padded = false;
+
+    template <class... _Ts>
+    inline constexpr bool __is_padded<std::tuple<__padded<_Ts>...>> = sizeof...(_Ts) != 0;
+
     template <class _ReceiverId, class _ValuesTuple, class _ErrorsVariant>
     struct __operation_base : __immovable {
       using _Receiver = stdexec::__t<_ReceiverId>;
+      static constexpr bool __padded_ = __is_padded<_ValuesTuple>;
 
       void __arrive() noexcept {
         if (0 == --__count_) {
@@ -6047,7 +6163,9 @@ namespace stdexec {
       }
 
       _Receiver __rcvr_;
+      STDEXEC_NO_UNIQUE_ADDRESS __cache_line_pad<__padded_> __count_pad_front_;
       std::atomic<std::size_t> __count_;
+      STDEXEC_NO_UNIQUE_ADDRESS __cache_line_pad<__padded_> __count_pad_back_;
       in_place_stop_source __stop_source_{};
       // Could be non-atomic here and atomic_ref everywhere except __completion_fn
       std::atomic<__state_t> __state_{__started};
@@ -6152,14 +6270,28 @@ namespace stdexec {
         __mcompose<__q<std::optional>, __q<__decayed_tuple>>,
         __q<__msingle>>;
 
+    template <class _Sender>
+    concept __completes_on_scheduler =
+      __callable<get_completion_scheduler_t<set_value_t>, env_of_t<_Sender>>;
+
     template <class _Env, __max1_sender<__env_t<_Env>>... _Senders>
     struct __traits_ {
-      // tuple<optional<tuple<Vs1...>>, optional<tuple<Vs2...>>, ...>
+      // A child that completes on a scheduler can complete on another thread
+      // while its siblings complete, so then the values are padded.
+      static constexpr bool __padded =
+        sizeof...(_Senders) > 1 && (__completes_on_scheduler<_Senders> || ...);
+
+      using __value_slot_fn = //
+        __if_c<
+          __padded,
+          __mcompose<__q<__when_all::__padded>, __mbind_front_q<__values_opt_tuple_t, _Env>>,
+          __mbind_front_q<__values_opt_tuple_t, _Env>>;
+
+      // tuple<optional<tuple<Vs1...>>, optional<tuple<Vs2...>>, ...>, with
+      // each optional wrapped in __padded if __padded is true.
       using __values_tuple = //
         __minvoke<
-          __with_default<
-            __transform< __mbind_front_q<__values_opt_tuple_t, _Env>, __q<std::tuple>>,
-            __ignore>,
+          __with_default< __transform< __value_slot_fn, __q<std::tuple>>, __ignore>,
           _Senders...>;
 
       using __nullable_variant_t_ = __munique<__mbind_front_q<std::variant, __not_an_error>>;
@@ -6224,7 +6356,7 @@ namespace stdexec {
 
         template <std::size_t... _Is, class... _Senders>
         __t(_Receiver __rcvr, __indices<_Is...>, _Senders&&... __sndrs)
-          : __operation_base_t{{}, (_Receiver&&) __rcvr, {sizeof...(_Is)}}
+          : __operation_base_t{{}, (_Receiver&&) __rcvr, {}, {sizeof...(_Is)}}
           , __op_states_{__conv{[&, this]() {
             return stdexec::connect((_Senders&&) __sndrs, __receiver_t<_Is>{this});
           }}...} {
@@ -67,6 +67,9 @@ namespace stdexec {
       __in_place_stop_callback_base** __prev_ptr_ = nullptr;
       bool* __removed_during_callback_ = nullptr;
       std::atomic<bool> __callback_completed_{false};
+      // Link of the source's lock-free registration stack. It is written only
+      // before the callback is pushed, so it can be read without the lock.
+      __in_place_stop_callback_base* __queue_next_ = nullptr;
     };
 
     struct __spin_wait {
@@ -137,19 +140,35 @@ namespace stdexec {
     template <class>
     friend class in_place_stop_callback;
 
-    uint8_t __lock_() const noexcept;
-    void __unlock_(uint8_t) const noexcept;
+    // The low bits of __state_ hold the flags below; the remaining bits hold
+    // the head of a lock-free stack of newly registered callbacks. Registering
+    // a callback pushes onto that stack without taking the lock, and a
+    // callback that is still on top of the stack when it is destroyed pops
+    // itself without taking the lock either. Taking the lock detaches the
+    // stack and moves its callbacks into the doubly-linked __callbacks_ list,
+    // which out-of-order removal and request_stop then work on.
+    using __state_t = std::uintptr_t;
 
-    bool __try_lock_unless_stop_requested_(bool) const noexcept;
+    __state_t __lock_() const noexcept;
+    void __unlock_() const noexcept;
+
+    void __splice_queued_callbacks_(__state_t) const noexcept;
 
     bool __try_add_callback_(__stok::__in_place_stop_callback_base*) const noexcept;
 
     void __remove_callback_(__stok::__in_place_stop_callback_base*) const noexcept;
 
-    static constexpr uint8_t __stop_requested_flag_ = 1;
-    static constexpr uint8_t __locked_flag_ = 2;
+    static constexpr __state_t __stop_requested_flag_ = 1;
+    static constexpr __state_t __locked_flag_ = 2;
+    static constexpr __state_t __flags_mask_ = __stop_requested_flag_ | __locked_flag_;
+
+    static_assert(alignof(__stok::__in_place_stop_callback_base) > __flags_mask_);
+
+    static __stok::__in_place_stop_callback_base* __queue_head_(__state_t __state) noexcept {
+      return reinterpret_cast<__stok::__in_place_stop_callback_base*>(__state & ~__flags_mask_);
+    }
 
-    mutable std::atomic<uint8_t> __state_{0};
+    mutable std::atomic<__state_t> __state_{0};
     mutable __stok::__in_place_stop_callback_base* __callbacks_ = nullptr;
     std::thread::id __notifying_thread_;
   };
@@ -251,14 +270,34 @@ namespace stdexec {
   }
 
   inline in_place_stop_source::~in_place_stop_source() {
-    STDEXEC_ASSERT((__state_.load(std::memory_order_relaxed) & __locked_flag_) == 0);
+    STDEXEC_ASSERT((__state_.load(std::memory_order_relaxed) & ~__stop_requested_flag_) == 0);
     STDEXEC_ASSERT(__callbacks_ == nullptr);
   }
 
   inline bool in_place_stop_source::request_stop() noexcept {
-    if (!__try_lock_unless_stop_requested_(true))
-      return true;
+    __stok::__spin_wait __spin;
+    auto __old_state = __state_.load(std::memory_order_relaxed);
+    do {
+      while (true) {
+        if ((__old_state & __stop_requested_flag_) != 0) {
+          // Stop already requested.
+          return true;
+        } else if ((__old_state & __locked_flag_) == 0) {
+          break;
+        } else {
+          __spin.__wait();
+          __old_state = __state_.load(std::memory_order_relaxed);
+        }
+      }
+      // Setting the stop-requested flag closes the registration stack, so
+      // taking its contents here leaves it empty for good.
+    } while (!__state_.compare_exchange_weak(
+      __old_state,
+      __locked_flag_ | __stop_requested_flag_,
+      std::memory_order_acq_rel,
+      std::memory_order_relaxed));
 
+    __splice_queued_callbacks_(__old_state);
     __notifying_thread_ = std::this_thread::get_id();
 
     // We are responsible for executing callbacks.
@@ -288,7 +327,7 @@ namespace stdexec {
     return false;
   }
 
-  inline uint8_t in_place_stop_source::__lock_() const noexcept {
+  inline in_place_stop_source::__state_t in_place_stop_source::__lock_() const noexcept {
     __stok::__spin_wait __spin;
     auto __old_state = __state_.load(std::memory_order_relaxed);
     do {
@@ -298,64 +337,73 @@ namespace stdexec {
       }
     } while (!__state_.compare_exchange_weak(
       __old_state,
-      __old_state | __locked_flag_,
+      (__old_state & __stop_requested_flag_) | __locked_flag_,
       std::memory_order_acquire,
       std::memory_order_relaxed));
 
+    __splice_queued_callbacks_(__old_state);
     return __old_state;
   }
 
-  inline void in_place_stop_source::__unlock_(uint8_t __old_state) const noexcept {
-    (void) __state_.store(__old_state, std::memory_order_release);
+  inline void in_place_stop_source::__unlock_() const noexcept {
+    // Registrations may have pushed onto the stack while the lock was held, so
+    // only the lock bit is cleared.
+    (void) __state_.fetch_and(~__locked_flag_, std::memory_order_release);
   }
 
-  inline bool in_place_stop_source::__try_lock_unless_stop_requested_(
-    bool __set_stop_requested) const noexcept {
-    __stok::__spin_wait __spin;
+  // Moves the callbacks of the registration stack whose head is encoded in
+  // __state into the locked list. Must be called with the lock held, after the
+  // stack has been detached from __state_.
+  inline void in_place_stop_source::__splice_queued_callbacks_(__state_t __state) const noexcept {
+    auto* __callbk = __queue_head_(__state);
+    while (__callbk != nullptr) {
+      auto* __next = __callbk->__queue_next_;
+      __callbk->__next_ = __callbacks_;
+      __callbk->__prev_ptr_ = &__callbacks_;
+      if (__callbacks_ != nullptr) {
+        __callbacks_->__prev_ptr_ = &__callbk->__next_;
+      }
+      __callbacks_ = __callbk;
+      __callbk = __next;
+    }
+  }
+
+  inline bool in_place_stop_source::__try_add_callback_(
+    __stok::__in_place_stop_callback_base* __callbk) const noexcept {
     auto __old_state = __state_.load(std::memory_order_relaxed);
     do {
-      while (true) {
-        if ((__old_state & __stop_requested_flag_) != 0) {
-          // Stop already requested.
-          return false;
-        } else if (__old_state == 0) {
-          break;
-        } else {
-          __spin.__wait();
-          __old_state = __state_.load(std::memory_order_relaxed);
-        }
+      if ((__old_state & __stop_requested_flag_) != 0) {
+        return false;
       }
+      __callbk->__queue_next_ = __queue_head_(__old_state);
     } while (!__state_.compare_exchange_weak(
       __old_state,
-      __set_stop_requested ? (__locked_flag_ | __stop_requested_flag_) : __locked_flag_,
+      reinterpret_cast<__state_t>(__callbk) | (__old_state & __flags_mask_),
       std::memory_order_acq_rel,
       std::memory_order_relaxed));
 
-    // Lock acquired successfully
     return true;
   }
 
-  inline bool in_place_stop_source::__try_add_callback_(
+  inline void in_place_stop_source::__remove_callback_(
     __stok::__in_place_stop_callback_base* __callbk) const noexcept {
-    if (!__try_lock_unless_stop_requested_(false)) {
-      return false;
+    // Fast path: the callback is still on top of the registration stack and
+    // nobody holds the lock. Only this thread can push or pop __callbk, so the
+    // stack cannot return to this exact state with a different link.
+    auto __expected = reinterpret_cast<__state_t>(__callbk);
+    if (
+      __state_.load(std::memory_order_relaxed) == __expected
+      && __state_.compare_exchange_strong(
+          __expected,
+          reinterpret_cast<__state_t>(__callbk->__queue_next_),
+          std::memory_order_acq_rel,
+          std::memory_order_relaxed)) {
+      return;
     }
 
-    __callbk->__next_ = __callbacks_;
-    __callbk->__prev_ptr_ = &__callbacks_;
-    if (__callbacks_ != nullptr) {
-      __callbacks_->__prev_ptr_ = &__callbk->__next_;
-    }
-    __callbacks_ = __callbk;
-
-    __unlock_(0);
-
-    return true;
-  }
-
-  inline void in_place_stop_source::__remove_callback_(
-    __stok::__in_place_stop_callback_base* __callbk) const noexcept {
-    auto __old_state = __lock_();
+    // Otherwise the callback is further down the registration stack or
+    // already in the locked list, where taking the lock will have moved it.
+    __lock_();
 
     if (__callbk->__prev_ptr_ != nullptr) {
       // Callback has not been executed yet.
@@ -364,10 +412,10 @@ namespace stdexec {
       if (__callbk->__next_ != nullptr) {
         __callbk->__next_->__prev_ptr_ = __callbk->__prev_ptr_;
       }
-      __unlock_(__old_state);
+      __unlock_();
     } else {
       auto __notifying_thread = __notifying_thread_;
-      __unlock_(__old_state);
+      __unlock_();
 
       // Callback has either already been executed or is
       // currently executing on another thread.
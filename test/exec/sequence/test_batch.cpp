@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "exec/sequence/batch.hpp"
+#include "exec/sequence/transform_each.hpp"
+#include "exec/sequence/ignore_all_values.hpp"
+#include "exec/sequence/iterate.hpp"
+#include "stdexec/execution.hpp"
+
+#if STDEXEC_HAS_STD_RANGES()
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <test_common/schedulers.hpp>
+
+namespace ex = stdexec;
+
+namespace {
+  // A timed scheduler whose timers only expire when start_next() is called.
+  // Its clock only advances when the test sets it, and it records the
+  // deadlines of the timers.
+  struct impulse_timed_scheduler {
+    using clock = std::chrono::steady_clock;
+
+    struct timeline {
+      clock::time_point now{};
+      std::vector<clock::time_point> deadlines{};
+    };
+
+    struct timer_sender {
+      using is_sender = void;
+      using completion_signatures =
+        ex::completion_signatures<ex::set_value_t(), ex::set_stopped_t()>;
+
+      impulse_scheduler sched_;
+
+      template <class R>
+      friend auto tag_invoke(ex::connect_t, timer_sender self, R&& r) {
+        return ex::connect(ex::schedule(self.sched_), (R&&) r);
+      }
+
+      friend scheduler_env<impulse_timed_scheduler>
+        tag_invoke(ex::get_env_t, const timer_sender&) noexcept {
+        return {};
+      }
+    };
+
+    impulse_scheduler sched_;
+    std::shared_ptr<timeline> timeline_ = std::make_shared<timeline>();
+
+    void start_next() {
+      sched_.start_next();
+    }
+
+    void advance(clock::duration d) {
+      timeline_->now += d;
+    }
+
+    const std::vector<clock::time_point>& deadlines() const {
+      return timeline_->deadlines;
+    }
+
+    friend timer_sender tag_invoke(ex::schedule_t, const impulse_timed_scheduler& self) {
+      return {self.sched_};
+    }
+
+    friend clock::time_point
+      tag_invoke(exec::now_t, const impulse_timed_scheduler& self) noexcept {
+      return self.timeline_->now;
+    }
+
+    friend timer_sender tag_invoke(
+      exec::schedule_after_t,
+      const impulse_timed_scheduler& self,
+      clock::duration d) {
+      self.timeline_->deadlines.push_back(self.timeline_->now + d);
+      return {self.sched_};
+    }
+
+    friend timer_sender tag_invoke(
+      exec::schedule_at_t,
+      const impulse_timed_scheduler& self,
+      clock::time_point t) {
+      self.timeline_->deadlines.push_back(t);
+      return {self.sched_};
+    }
+
+    bool operator==(const impulse_timed_scheduler&) const noexcept = default;
+  };
+
+  auto collect(std::vector<std::vector<int>>& batches) {
+    return exec::transform_each(ex::then([&](std::span<int> batch) {
+      batches.emplace_back(batch.begin(), batch.end());
+    }));
+  }
+}
+
+TEST_CASE("batch - coalesce items into batches", "[sequence_senders][batch]") {
+  std::array<int, 5> array{1, 2, 3, 4, 5};
+  std::vector<std::vector<int>> batches;
+  auto sndr = exec::iterate(std::views::all(array)) | exec::batch(2);
+  STATIC_REQUIRE(exec::sequence_sender_in<decltype(sndr), ex::empty_env>);
+  ex::sync_wait(exec::ignore_all_values(std::move(sndr) | collect(batches)));
+  CHECK(batches == std::vector<std::vector<int>>{{1, 2}, {3, 4}, {5}});
+}
+
+TEST_CASE("batch - batches reuse the same buffer", "[sequence_senders][batch]") {
+  std::array<int, 4> array{1, 2, 3, 4};
+  std::vector<const int*> buffers;
+  auto sndr = exec::iterate(std::views::all(array)) | exec::batch(2)
+            | exec::transform_each(ex::then([&](std::span<int> batch) {
+                buffers.push_back(batch.data());
+              }))
+            | exec::ignore_all_values();
+  ex::sync_wait(std::move(sndr));
+  REQUIRE(buffers.size() == 2);
+  CHECK(buffers[0] == buffers[1]);
+}
+
+TEST_CASE("batch - errors of items are forwarded", "[sequence_senders][batch]") {
+  std::array<int, 3> array{1, 2, 3};
+  auto sndr = exec::iterate(std::views::all(array)) //
+            | exec::transform_each(ex::then([](int x) {
+                if (x == 3) {
+                  throw x;
+                }
+                return x;
+              }))
+            | exec::batch(8) | exec::ignore_all_values();
+  CHECK_THROWS_AS(ex::sync_wait(std::move(sndr)), int);
+}
+
+TEST_CASE("batch_for - flush a partial batch on the deadline", "[sequence_senders][batch]") {
+  using namespace std::chrono_literals;
+  impulse_scheduler items;
+  impulse_timed_scheduler timer;
+  STATIC_REQUIRE(exec::timed_scheduler<impulse_timed_scheduler>);
+
+  std::array<int, 4> array{1, 2, 3, 4};
+  std::vector<std::vector<int>> batches;
+  bool done = false;
+  auto sndr = exec::iterate(std::views::all(array))
+            | exec::transform_each(ex::let_value([&](int x) { return ex::on(items, ex::just(x)); }))
+            | exec::batch_for(timer, 3, 1ms) | collect(batches) | exec::ignore_all_values()
+            | ex::then([&] { done = true; });
+  ex::start_detached(std::move(sndr));
+
+  items.start_next();
+  CHECK(batches.empty());
+  timer.start_next();
+  CHECK(batches == std::vector<std::vector<int>>{{1}});
+
+  items.start_next();
+  items.start_next();
+  CHECK(batches.size() == 1);
+  items.start_next();
+  CHECK(batches == std::vector<std::vector<int>>{{1}, {2, 3, 4}});
+
+  // The sequence completes once the pending timer has been cancelled.
+  CHECK_FALSE(done);
+  timer.start_next();
+  CHECK(done);
+}
+
+TEST_CASE(
+  "batch_for - the deadline of a partial batch after a full one counts from its first value",
+  "[sequence_senders][batch]") {
+  using namespace std::chrono_literals;
+  using time_point = impulse_timed_scheduler::clock::time_point;
+  impulse_scheduler items;
+  impulse_timed_scheduler timer;
+
+  std::array<int, 5> array{1, 2, 3, 4, 5};
+  std::vector<std::vector<int>> batches;
+  auto sndr = exec::iterate(std::views::all(array))
+            | exec::transform_each(ex::let_value([&](int x) { return ex::on(items, ex::just(x)); }))
+            | exec::batch_for(timer, 3, 10ms) | collect(batches) | exec::ignore_all_values();
+  ex::start_detached(std::move(sndr));
+
+  // The first batch fills up before its deadline at 10ms.
+  items.start_next();
+  timer.advance(5ms);
+  items.start_next();
+  items.start_next();
+  CHECK(batches == std::vector<std::vector<int>>{{1, 2, 3}});
+  CHECK(timer.deadlines() == std::vector<time_point>{time_point{10ms}});
+
+  // The next batch starts at 6ms, while the timer of the full batch is
+  // still running. Once that one expires, the timer of the partial batch is
+  // due at 16ms, not a full duration after the expiry.
+  timer.advance(1ms);
+  items.start_next();
+  timer.advance(4ms);
+  timer.start_next();
+  CHECK(batches.size() == 1);
+  CHECK(timer.deadlines() == std::vector<time_point>{time_point{10ms}, time_point{16ms}});
+
+  timer.advance(6ms);
+  timer.start_next();
+  CHECK(batches == std::vector<std::vector<int>>{{1, 2, 3}, {4}});
+
+  items.start_next();
+  CHECK(batches == std::vector<std::vector<int>>{{1, 2, 3}, {4}, {5}});
+  timer.start_next();
+}
+
+#endif // STDEXEC_HAS_STD_RANGES()
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "exec/sequence/buffered_map.hpp"
+#include "exec/sequence/transform_each.hpp"
+#include "exec/sequence/ignore_all_values.hpp"
+#include "exec/sequence/iterate.hpp"
+#include "exec/static_thread_pool.hpp"
+#include "stdexec/execution.hpp"
+
+#if STDEXEC_HAS_STD_RANGES()
+
+#include <array>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <test_common/schedulers.hpp>
+
+TEST_CASE("buffered_map - on an inline scheduler", "[sequence_senders][buffered_map]") {
+  std::array<int, 4> array{1, 2, 3, 4};
+  std::vector<int> results;
+  auto sndr = exec::iterate(std::views::all(array))
+            | exec::buffered_map(inline_scheduler{}, 2, [](int x) { return x * x; })
+            | exec::transform_each(stdexec::then([&](int x) { results.push_back(x); }));
+  STATIC_REQUIRE(exec::sequence_sender_in<decltype(sndr), stdexec::empty_env>);
+  stdexec::sync_wait(exec::ignore_all_values(std::move(sndr)));
+  CHECK(results == std::vector<int>{1, 4, 9, 16});
+}
+
+TEST_CASE("buffered_map - preserves the input order", "[sequence_senders][buffered_map]") {
+  exec::static_thread_pool pool{4};
+  std::array<int, 64> array{};
+  for (int i = 0; i < 64; ++i) {
+    array[i] = i;
+  }
+  std::vector<int> results;
+  auto sndr = exec::iterate(std::views::all(array))
+            | exec::buffered_map(pool.get_scheduler(), 8, [](int x) { return x + 1; })
+            | exec::transform_each(stdexec::then([&](int x) { results.push_back(x); }))
+            | exec::ignore_all_values();
+  stdexec::sync_wait(std::move(sndr));
+  REQUIRE(results.size() == 64);
+  for (int i = 0; i < 64; ++i) {
+    CHECK(results[i] == i + 1);
+  }
+}
+
+TEST_CASE("buffered_map_unordered - delivers every result", "[sequence_senders][buffered_map]") {
+  exec::static_thread_pool pool{4};
+  std::array<int, 64> array{};
+  for (int i = 0; i < 64; ++i) {
+    array[i] = i;
+  }
+  int sum = 0;
+  auto sndr = exec::iterate(std::views::all(array))
+            | exec::buffered_map_unordered(pool.get_scheduler(), 8, [](int x) { return x; })
+            | exec::transform_each(stdexec::then([&](int x) { sum += x; }))
+            | exec::ignore_all_values();
+  stdexec::sync_wait(std::move(sndr));
+  CHECK(sum == 63 * 64 / 2);
+}
+
+TEST_CASE("buffered_map - a throwing function sends an error", "[sequence_senders][buffered_map]") {
+  std::array<int, 3> array{1, 2, 3};
+  auto sndr = exec::iterate(std::views::all(array))
+            | exec::buffered_map(inline_scheduler{}, 1, [](int x) -> int {
+                if (x == 2) {
+                  throw x;
+                }
+                return x;
+              })
+            | exec::ignore_all_values();
+  CHECK_THROWS_AS(stdexec::sync_wait(std::move(sndr)), int);
+}
+
+#endif // STDEXEC_HAS_STD_RANGES()
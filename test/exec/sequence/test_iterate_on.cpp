@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "exec/sequence/iterate_on.hpp"
+#include "exec/sequence/transform_each.hpp"
+#include "exec/sequence/ignore_all_values.hpp"
+#include "exec/static_thread_pool.hpp"
+#include "stdexec/execution.hpp"
+
+#if STDEXEC_HAS_STD_RANGES()
+
+#include <atomic>
+#include <numeric>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <test_common/schedulers.hpp>
+
+namespace ex = stdexec;
+
+TEST_CASE("iterate_on - emits chunks of the range", "[sequence_senders][iterate_on]") {
+  std::vector<int> values(10);
+  std::iota(values.begin(), values.end(), 0);
+  std::vector<std::size_t> sizes;
+  int sum = 0;
+  auto sndr = exec::iterate_on(inline_scheduler{}, std::views::all(values), 4)
+            | exec::transform_each(ex::then([&](auto chunk) {
+                sizes.push_back(chunk.size());
+                for (int x: chunk) {
+                  sum += x;
+                }
+              }));
+  STATIC_REQUIRE(exec::sequence_sender_in<decltype(sndr), ex::empty_env>);
+  ex::sync_wait(exec::ignore_all_values(std::move(sndr)));
+  CHECK(sizes == std::vector<std::size_t>{4, 4, 2});
+  CHECK(sum == 45);
+}
+
+TEST_CASE("iterate_on - an empty range completes immediately", "[sequence_senders][iterate_on]") {
+  std::vector<int> values;
+  int count = 0;
+  auto sndr = exec::iterate_on(inline_scheduler{}, std::views::all(values), 4)
+            | exec::transform_each(ex::then([&](auto) { ++count; })) | exec::ignore_all_values();
+  ex::sync_wait(std::move(sndr));
+  CHECK(count == 0);
+}
+
+TEST_CASE(
+  "iterate_on - an lvalue range is referenced, not copied",
+  "[sequence_senders][iterate_on]") {
+  std::vector<int> values(10);
+  std::iota(values.begin(), values.end(), 0);
+  std::vector<const int*> firsts;
+  auto sndr = exec::iterate_on(inline_scheduler{}, values, 4)
+            | exec::transform_each(ex::then([&](auto chunk) { //
+                firsts.push_back(&*chunk.begin());
+              }));
+  // Subscribing an lvalue sender does not copy the elements either.
+  ex::sync_wait(exec::ignore_all_values(sndr));
+  ex::sync_wait(exec::ignore_all_values(sndr));
+  const int* data = values.data();
+  CHECK(
+    firsts == std::vector<const int*>{data, data + 4, data + 8, data, data + 4, data + 8});
+}
+
+TEST_CASE("iterate_on - an rvalue range is owned by the sender", "[sequence_senders][iterate_on]") {
+  int sum = 0;
+  auto sndr = exec::iterate_on(inline_scheduler{}, std::vector<int>{1, 2, 3, 4, 5}, 2)
+            | exec::transform_each(ex::then([&](auto chunk) {
+                for (int x: chunk) {
+                  sum += x;
+                }
+              }))
+            | exec::ignore_all_values();
+  ex::sync_wait(std::move(sndr));
+  CHECK(sum == 15);
+}
+
+TEST_CASE("iterate_on - chunks run on a thread pool", "[sequence_senders][iterate_on]") {
+  exec::static_thread_pool pool{4};
+  std::vector<long> values(100'000);
+  std::iota(values.begin(), values.end(), 0L);
+  std::atomic<long> sum{0};
+  auto sndr = exec::iterate_on(pool.get_scheduler(), std::views::all(values), 1024)
+            | exec::transform_each(ex::then([&](auto chunk) {
+                sum += std::accumulate(chunk.begin(), chunk.end(), 0L);
+              }))
+            | exec::ignore_all_values();
+  ex::sync_wait(std::move(sndr));
+  CHECK(sum.load() == 99'999L * 100'000L / 2);
+}
+
+#endif // STDEXEC_HAS_STD_RANGES()
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "exec/sequence/transform_each.hpp"
+#include "exec/sequence/ignore_all_values.hpp"
+#include "exec/sequence/iterate.hpp"
+#include "stdexec/execution.hpp"
+
+#if STDEXEC_HAS_STD_RANGES()
+
+#include <array>
+#include <catch2/catch.hpp>
+
+TEST_CASE("transform_each - sum up an array", "[sequence_senders][transform_each]") {
+  std::array<int, 3> array{42, 43, 44};
+  int sum = 0;
+  auto sndr = exec::iterate(std::views::all(array))
+            | exec::transform_each(stdexec::then([&](int x) noexcept { sum += x; }));
+  STATIC_REQUIRE(exec::sequence_sender_in<decltype(sndr), stdexec::empty_env>);
+  stdexec::sync_wait(exec::ignore_all_values(std::move(sndr)));
+  CHECK(sum == (42 + 43 + 44));
+}
+
+TEST_CASE("transform_each - adaptors can be chained", "[sequence_senders][transform_each]") {
+  std::array<int, 3> array{1, 2, 3};
+  int sum = 0;
+  auto sndr = exec::iterate(std::views::all(array))
+            | exec::transform_each(stdexec::then([](int x) noexcept { return 2 * x; }))
+            | exec::transform_each(stdexec::then([&](int x) noexcept { sum += x; }))
+            | exec::ignore_all_values();
+  stdexec::sync_wait(std::move(sndr));
+  CHECK(sum == 12);
+}
+
+TEST_CASE("transform_each - item errors are forwarded", "[sequence_senders][transform_each]") {
+  std::array<int, 3> array{1, 2, 3};
+  auto sndr = exec::iterate(std::views::all(array))
+            | exec::transform_each(stdexec::let_value([](int x) {
+                return stdexec::just_error(x);
+              }))
+            | exec::ignore_all_values();
+  CHECK_THROWS_AS(stdexec::sync_wait(std::move(sndr)), int);
+}
+
+#endif // STDEXEC_HAS_STD_RANGES()
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+#include <stdexec/execution.hpp>
+#include <exec/any_sender_of.hpp>
+#include <exec/async_scope.hpp>
+#include <exec/recycling_allocator.hpp>
+#include <exec/sort.hpp>
+#include <exec/static_thread_pool.hpp>
+#include <exec/task.hpp>
+#include <test_common/allocations.hpp>
+#include <test_common/receivers.hpp>
+
+#include <array>
+#include <vector>
+
+namespace ex = stdexec;
+
+TEST_CASE("inline pipelines do not allocate", "[allocation_hooks]") {
+  allocation_counter allocations;
+  auto snd = ex::when_all(
+    ex::just(1) | ex::then([](int i) { return i + 1; }),
+    ex::just(2) | ex::let_value([](int i) { return ex::just(i * 2); }));
+  auto op = ex::connect(
+    std::move(snd), expect_no_allocations_receiver{allocations, expect_value_receiver{2, 4}});
+  ex::start(op);
+}
+
+TEST_CASE("split and ensure_started report their shared state", "[allocation_hooks]") {
+  {
+    allocation_counter allocations;
+    auto snd = ex::split(ex::just(1));
+    CHECK(allocations.count() == 1);
+    CHECK(allocations.last_algorithm() == "split");
+  }
+  {
+    allocation_counter allocations;
+    auto snd = ex::ensure_started(ex::just(1));
+    CHECK(allocations.count() == 1);
+    CHECK(allocations.last_algorithm() == "ensure_started");
+  }
+}
+
+TEST_CASE("static_thread_pool bulk reports its tasks", "[allocation_hooks]") {
+  exec::static_thread_pool pool{2};
+  allocation_counter allocations;
+  ex::sync_wait(ex::schedule(pool.get_scheduler()) | ex::bulk(4, [](int) noexcept {}));
+  CHECK(allocations.count() == 1);
+  CHECK(allocations.last_algorithm() == "static_thread_pool::bulk");
+}
+
+TEST_CASE("sort and stable_partition report their scratch buffer", "[allocation_hooks]") {
+  exec::static_thread_pool pool{2};
+  std::vector<int> v(10'000);
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    v[i] = static_cast<int>((i * 7919) % v.size());
+  }
+  // The bulk operations of the pool report their own tasks.
+  {
+    allocation_counter allocations{"sort"};
+    ex::sync_wait(exec::sort(pool.get_scheduler(), v));
+    CHECK(allocations.count() == 1);
+  }
+  {
+    allocation_counter allocations{"stable_partition"};
+    ex::sync_wait(exec::stable_partition(pool.get_scheduler(), v, [](int i) { return i < 10; }));
+    CHECK(allocations.count() == 1);
+  }
+}
+
+TEST_CASE("async_scope::spawn reports the spawned operation", "[allocation_hooks]") {
+  exec::async_scope scope;
+  {
+    allocation_counter allocations;
+    scope.spawn(ex::just());
+    CHECK(allocations.count() == 1);
+    CHECK(allocations.last_algorithm() == "async_scope::spawn");
+  }
+  ex::sync_wait(scope.on_empty());
+}
+
+TEST_CASE("any_sender reports senders that do not fit inline", "[allocation_hooks]") {
+  using any_sender_t = exec::any_receiver_ref<
+    ex::completion_signatures<ex::set_value_t(int)>>::any_sender<>;
+  {
+    allocation_counter allocations;
+    any_sender_t snd = ex::just(42);
+    CHECK(allocations.count() == 0);
+  }
+  {
+    std::array<char, 256> large{};
+    allocation_counter allocations;
+    any_sender_t snd = ex::just(large) | ex::then([](auto a) noexcept { return (int) a.size(); });
+    CHECK(allocations.count() == 1);
+    CHECK(allocations.last_algorithm() == "any_sender");
+  }
+}
+
+TEST_CASE(
+  "any_sender with a recycling_allocator does not allocate once warmed up",
+  "[allocation_hooks]") {
+  using any_sender_t = exec::any_receiver_ref<ex::completion_signatures<ex::set_value_t(int)>>::
+    any_sender<>::with_storage<exec::any_storage<16, exec::recycling_allocator<std::byte>>>;
+  std::array<char, 256> large{};
+  auto make = [&]() -> any_sender_t {
+    return ex::just(large) | ex::then([](auto a) noexcept { return (int) a.size(); });
+  };
+  {
+    allocation_counter allocations;
+    auto op = ex::connect(make(), expect_value_receiver{256});
+    ex::start(op);
+    // The sender and its operation state, each reported once.
+    CHECK(allocations.count() == 2);
+    CHECK(allocations.last_algorithm() == "recycling_allocator");
+  }
+  for (int i = 0; i < 3; ++i) {
+    allocation_counter allocations;
+    auto op = ex::connect(
+      make(), expect_no_allocations_receiver{allocations, expect_value_receiver{256}});
+    ex::start(op);
+  }
+}
+
+namespace {
+  exec::task<int> answer() {
+    co_return 42;
+  }
+}
+
+TEST_CASE("exec::task reports its coroutine frame", "[allocation_hooks]") {
+  allocation_counter allocations;
+  auto task = answer();
+  CHECK(allocations.count() == 1);
+  CHECK(allocations.last_algorithm() == "task");
+  auto [value] = ex::sync_wait(std::move(task)).value();
+  CHECK(value == 42);
+}
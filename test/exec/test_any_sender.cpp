@@ -18,9 +18,11 @@
 #include <exec/inline_scheduler.hpp>
 #include <exec/when_any.hpp>
 #include <exec/static_thread_pool.hpp>
+#include <exec/recycling_allocator.hpp>
 
 #include <test_common/schedulers.hpp>
 #include <test_common/receivers.hpp>
+#include <test_common/global_new.hpp>
 
 #include <catch2/catch.hpp>
 
@@ -715,4 +717,224 @@ TEST_CASE(
     }
   }
   CHECK(counting_scheduler::count == 0);
-}
\ No newline at end of file
+}
+///////////////////////////////////////////////////////////////////////////////
+//                                                                  any_storage
+
+namespace {
+  int default_allocations = 0;
+
+  template <class T>
+  struct counting_allocator {
+    using value_type = T;
+    int* count_ = &default_allocations;
+
+    counting_allocator() = default;
+
+    explicit counting_allocator(int* count) noexcept
+      : count_(count) {
+    }
+
+    template <class U>
+    counting_allocator(const counting_allocator<U>& other) noexcept
+      : count_(other.count_) {
+    }
+
+    T* allocate(std::size_t n) {
+      ++*count_;
+      return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+      std::allocator<T>{}.deallocate(p, n);
+    }
+
+    friend bool operator==(const counting_allocator&, const counting_allocator&) = default;
+  };
+
+  struct alloc_env {
+    int* count_;
+
+    friend counting_allocator<int> tag_invoke(get_allocator_t, const alloc_env& e) noexcept {
+      return counting_allocator<int>{e.count_};
+    }
+  };
+
+  struct alloc_receiver {
+    using is_receiver = void;
+    int* count_;
+    int* value_;
+
+    friend void tag_invoke(set_value_t, alloc_receiver&& r, int v) noexcept {
+      *r.value_ = v;
+    }
+
+    friend void tag_invoke(set_error_t, alloc_receiver&&, std::exception_ptr) noexcept {
+    }
+
+    friend void tag_invoke(set_stopped_t, alloc_receiver&&) noexcept {
+    }
+
+    friend alloc_env tag_invoke(get_env_t, const alloc_receiver& r) noexcept {
+      return {r.count_};
+    }
+  };
+
+  auto big_sender() {
+    std::array<int, 32> values{};
+    values[0] = 42;
+    return just(values) | then([](const std::array<int, 32>& a) { return a[0]; });
+  }
+
+  using big_sigs =
+    completion_signatures<set_value_t(int), set_error_t(std::exception_ptr), set_stopped_t()>;
+  using big_sender_t = any_receiver_ref<big_sigs>::any_sender<>;
+}
+
+TEST_CASE("any_sender inline size is configurable", "[types][any_sender][any_storage]") {
+  using small_t =
+    big_sender_t::with_storage<any_storage<3 * sizeof(void*), counting_allocator<std::byte>>>;
+  using large_t = big_sender_t::with_storage<any_storage<512, counting_allocator<std::byte>, 512>>;
+  default_allocations = 0;
+  {
+    small_t sndr = big_sender();
+    CHECK(default_allocations == 1);
+    auto [v] = *sync_wait(std::move(sndr));
+    CHECK(v == 42);
+    CHECK(default_allocations == 2);
+  }
+  default_allocations = 0;
+  {
+    large_t sndr = big_sender();
+    auto [v] = *sync_wait(std::move(sndr));
+    CHECK(v == 42);
+    CHECK(default_allocations == 0);
+  }
+}
+
+TEST_CASE(
+  "any_sender allocates operation states with the receiver's allocator",
+  "[types][any_sender][any_storage]") {
+  using sender_t = big_sender_t::with_storage<any_storage<512, counting_allocator<std::byte>, 0>>;
+  default_allocations = 0;
+  int receiver_allocations = 0;
+  int value = 0;
+  int sender_allocations = 0;
+  sender_t sndr{
+    std::allocator_arg, counting_allocator<std::byte>{&sender_allocations}, big_sender()};
+  CHECK(sender_allocations == 0);
+  auto op = connect(std::move(sndr), alloc_receiver{&receiver_allocations, &value});
+  CHECK(receiver_allocations == 1);
+  CHECK(default_allocations == 0);
+  start(op);
+  CHECK(value == 42);
+}
+
+TEST_CASE("recycling_allocator reuses freed blocks", "[types][any_sender][any_storage]") {
+  struct block {
+    char data[100];
+  };
+
+  recycling_allocator<block> alloc;
+  block* p1 = alloc.allocate(1);
+  alloc.deallocate(p1, 1);
+  block* p2 = alloc.allocate(1);
+  CHECK(p1 == p2);
+  block* p3 = alloc.allocate(1);
+  CHECK(p3 != p2);
+  alloc.deallocate(p3, 1);
+  alloc.deallocate(p2, 1);
+
+  using sender_t =
+    big_sender_t::with_storage<any_storage<3 * sizeof(void*), recycling_allocator<std::byte>>>;
+  auto run = [] {
+    sender_t sndr = big_sender();
+    auto [v] = *sync_wait(std::move(sndr));
+    CHECK(v == 42);
+  };
+  // The first round allocates the blocks of the sender and its operation
+  // state, every later round reuses them.
+  run();
+  global_new_counter allocations;
+  for (int i = 0; i < 3; ++i) {
+    run();
+  }
+  CHECK(allocations.count() == 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//                                                           any_sender hints
+
+namespace {
+  struct probe_receiver {
+    using is_receiver = void;
+    int* value_;
+
+    friend void tag_invoke(set_value_t, probe_receiver&& r, int v) noexcept {
+      *r.value_ = v;
+    }
+
+    friend void tag_invoke(set_stopped_t, probe_receiver&&) noexcept {
+    }
+
+    friend empty_env tag_invoke(get_env_t, const probe_receiver&) noexcept {
+      return {};
+    }
+  };
+
+  // Remembers whether it was connected to a probe_receiver directly or to a
+  // type-erased receiver reference.
+  struct probe_sender {
+    using is_sender = void;
+    using completion_signatures = stdexec::completion_signatures<set_value_t(int)>;
+
+    int value_;
+    bool* direct_;
+
+    template <class R>
+    struct operation : immovable {
+      R rcvr_;
+      int value_;
+
+      friend void tag_invoke(start_t, operation& self) noexcept {
+        set_value((R&&) self.rcvr_, (int&&) self.value_);
+      }
+    };
+
+    template <receiver R>
+    friend operation<R> tag_invoke(connect_t, probe_sender self, R r) {
+      *self.direct_ = std::same_as<R, probe_receiver>;
+      return {{}, (R&&) r, self.value_};
+    }
+  };
+
+  using probe_sigs = completion_signatures<set_value_t(int), set_stopped_t()>;
+  using probe_any_sender = any_receiver_ref<probe_sigs>::any_sender<>;
+}
+
+TEST_CASE("any_sender with_hint connects hinted types directly", "[types][any_sender][with_hint]") {
+  using hinted_t = probe_any_sender::with_hint<probe_sender>;
+  STATIC_REQUIRE(sender<hinted_t>);
+  bool direct = false;
+  int value = 0;
+  hinted_t sndr = probe_sender{42, &direct};
+  auto op = connect(std::move(sndr), probe_receiver{&value});
+  CHECK(direct);
+  start(op);
+  CHECK(value == 42);
+}
+
+TEST_CASE("any_sender with_hint falls back to type erasure", "[types][any_sender][with_hint]") {
+  using hinted_t = probe_any_sender::with_hint<decltype(just(0))>;
+  bool direct = true;
+  int value = 0;
+  hinted_t sndr = probe_sender{42, &direct};
+  auto op = connect(std::move(sndr), probe_receiver{&value});
+  CHECK(!direct);
+  start(op);
+  CHECK(value == 42);
+
+  hinted_t sndr2 = just(7);
+  auto [v] = *sync_wait(std::move(sndr2));
+  CHECK(v == 7);
+}
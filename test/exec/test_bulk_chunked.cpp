@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+#include <stdexec/execution.hpp>
+#include <exec/bulk_chunked.hpp>
+#include <exec/on.hpp>
+#include <exec/static_thread_pool.hpp>
+#include <test_common/receivers.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ex = stdexec;
+
+namespace {
+  // Records the ranges a bulk_chunked function is called with.
+  struct range_log {
+    std::mutex mutex_;
+    std::vector<std::pair<int, int>> ranges_;
+
+    void add(int begin, int end) {
+      std::lock_guard lock{mutex_};
+      ranges_.emplace_back(begin, end);
+    }
+
+    // Whether the ranges are non-empty and cover [0, shape) exactly once.
+    bool partitions(int shape) {
+      std::sort(ranges_.begin(), ranges_.end());
+      int next = 0;
+      for (auto [begin, end]: ranges_) {
+        if (begin != next || end <= begin) {
+          return false;
+        }
+        next = end;
+      }
+      return next == shape;
+    }
+  };
+}
+
+TEST_CASE("bulk_chunked returns a sender", "[adaptors][bulk_chunked]") {
+  auto snd = exec::bulk_chunked(ex::just(19), 8, [](int, int, int) {});
+  static_assert(ex::sender_in<decltype(snd), ex::empty_env>);
+  (void) snd;
+}
+
+TEST_CASE("bulk_chunked forwards values and covers the shape", "[adaptors][bulk_chunked]") {
+  range_log log;
+  auto snd = ex::just(42) //
+           | exec::bulk_chunked(10, [&](int begin, int end, int& value) {
+               CHECK(value == 42);
+               log.add(begin, end);
+             });
+  auto op = ex::connect(std::move(snd), expect_value_receiver{42});
+  ex::start(op);
+  CHECK(log.partitions(10));
+}
+
+TEST_CASE("bulk_chunked forwards exceptions", "[adaptors][bulk_chunked]") {
+  auto snd = ex::just() | exec::bulk_chunked(4, [](int, int) { throw std::logic_error("chunk"); });
+  CHECK_THROWS_AS(ex::sync_wait(std::move(snd)), std::logic_error);
+}
+
+TEST_CASE(
+  "static_thread_pool passes a range per task to bulk_chunked",
+  "[adaptors][bulk_chunked]") {
+  exec::static_thread_pool pool{4};
+  for (int shape: {0, 3, 4, 1000}) {
+    range_log log;
+    std::vector<int> v(static_cast<std::size_t>(shape), 0);
+    ex::sync_wait(
+      ex::schedule(pool.get_scheduler()) //
+      | exec::bulk_chunked(shape, [&](int begin, int end) noexcept {
+          log.add(begin, end);
+          for (int i = begin; i < end; ++i) {
+            ++v[i];
+          }
+        }));
+    CHECK(log.ranges_.size() == static_cast<std::size_t>(std::min(shape, 4)));
+    CHECK(log.partitions(shape));
+    CHECK(std::count(v.begin(), v.end(), 1) == shape);
+  }
+}
+
+TEST_CASE(
+  "bulk_chunked is fused with other bulks on static_thread_pool",
+  "[adaptors][bulk_chunked]") {
+  exec::static_thread_pool pool{2};
+  range_log log;
+  std::vector<int> v(100, 0);
+  auto snd = ex::just(1) //
+           | ex::bulk(100, [&](int i, int k) { v[i] = k; })
+           | exec::bulk_chunked(100, [&](int begin, int end, int k) {
+               log.add(begin, end);
+               for (int i = begin; i < end; ++i) {
+                 v[i] += k;
+               }
+             });
+  auto [k] = ex::sync_wait(exec::on(pool.get_scheduler(), std::move(snd))).value();
+  CHECK(k == 1);
+  CHECK(log.ranges_.size() == 2);
+  CHECK(log.partitions(100));
+  CHECK(std::count(v.begin(), v.end(), 2) == 100);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+#include <stdexec/execution.hpp>
+#include <exec/bulk_tiled.hpp>
+#include <exec/on.hpp>
+#include <exec/static_thread_pool.hpp>
+#include <test_common/receivers.hpp>
+
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+namespace ex = stdexec;
+
+TEST_CASE("bulk_tiled returns a sender", "[adaptors][bulk_tiled]") {
+  auto snd = exec::bulk_tiled(
+    ex::just(19), std::array{4, 4}, std::array{2, 2}, [](int, int, int) {});
+  static_assert(ex::sender_in<decltype(snd), ex::empty_env>);
+  (void) snd;
+}
+
+TEST_CASE("bulk_tiled visits every point once", "[adaptors][bulk_tiled]") {
+  for (exec::tile_order order: {exec::tile_order::row_major, exec::tile_order::morton}) {
+    std::vector<int> visits(7 * 5, 0);
+    std::vector<std::array<int, 2>> points;
+    auto snd = ex::just(42)
+             | exec::bulk_tiled(
+                 std::array{7, 5},
+                 std::array{3, 2},
+                 [&](int y, int x, int& value) {
+                   CHECK(value == 42);
+                   ++visits[y * 5 + x];
+                   points.push_back({y, x});
+                 },
+                 order);
+    auto op = ex::connect(std::move(snd), expect_value_receiver{42});
+    ex::start(op);
+    for (int count: visits) {
+      CHECK(count == 1);
+    }
+    // The first tile is visited first, row by row.
+    REQUIRE(points.size() == 35);
+    CHECK(points[0] == std::array{0, 0});
+    CHECK(points[1] == std::array{0, 1});
+    CHECK(points[2] == std::array{1, 0});
+  }
+}
+
+TEST_CASE("bulk_tiled numbers the tiles in Z-order", "[adaptors][bulk_tiled]") {
+  std::vector<std::array<int, 2>> corners;
+  ex::sync_wait(
+    ex::just()
+    | exec::bulk_tiled(
+      std::array{4, 4},
+      std::array{2, 2},
+      [&](int y, int x) {
+        if (y % 2 == 0 && x % 2 == 0) {
+          corners.push_back({y, x});
+        }
+      },
+      exec::tile_order::morton));
+  CHECK(corners == std::vector<std::array<int, 2>>{{0, 0}, {0, 2}, {2, 0}, {2, 2}});
+}
+
+TEST_CASE("bulk_tiled supports three dimensions and whole extents", "[adaptors][bulk_tiled]") {
+  int sum = 0;
+  int calls = 0;
+  auto visit = [&](int z, int y, int x) {
+    sum += z * 100 + y * 10 + x;
+    ++calls;
+  };
+  ex::sync_wait(ex::just() | exec::bulk_tiled(std::array{2, 3, 4}, std::array{0, 2, 0}, visit));
+  CHECK(calls == 24);
+  CHECK(sum == 12 * 100 + 24 * 10 + 6 * 6);
+}
+
+TEST_CASE("bulk_tiled with an empty extent does nothing", "[adaptors][bulk_tiled]") {
+  int calls = 0;
+  ex::sync_wait(
+    ex::just() | exec::bulk_tiled(std::array{0, 8}, std::array{4, 4}, [&](int, int) { ++calls; }));
+  CHECK(calls == 0);
+}
+
+TEST_CASE("bulk_tiled forwards exceptions", "[adaptors][bulk_tiled]") {
+  auto snd = ex::just() | exec::bulk_tiled(std::array{4}, std::array{2}, [](int i) {
+               if (i == 3) {
+                 throw std::logic_error("tile");
+               }
+             });
+  CHECK_THROWS_AS(ex::sync_wait(std::move(snd)), std::logic_error);
+}
+
+TEST_CASE("bulk_tiled runs on static_thread_pool", "[adaptors][bulk_tiled]") {
+  exec::static_thread_pool pool{4};
+  constexpr int ny = 100;
+  constexpr int nx = 70;
+  std::vector<int> grid(ny * nx, 0);
+  auto snd = ex::just(1)
+           | exec::bulk_tiled(
+               std::array{ny, nx},
+               std::array{16, 16},
+               [&](int y, int x, int k) noexcept { grid[y * nx + x] += k; },
+               exec::tile_order::morton)
+           | ex::bulk(ny * nx, [&](int i, int k) noexcept { grid[i] += k; });
+  ex::sync_wait(exec::on(pool.get_scheduler(), std::move(snd)));
+  for (int value: grid) {
+    CHECK(value == 2);
+  }
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+#include <exec/channel.hpp>
+#include <exec/sequence/ignore_all_values.hpp>
+#include <exec/sequence/transform_each.hpp>
+#include <exec/static_thread_pool.hpp>
+#include <test_common/schedulers.hpp>
+#include <test_common/receivers.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace ex = stdexec;
+
+namespace {
+  template <class T>
+  auto consume(exec::channel<T>& ch, std::vector<T>& values) {
+    return ch.receive() //
+         | exec::transform_each(ex::then([&values](T value) { values.push_back(value); }))
+         | exec::ignore_all_values();
+  }
+}
+
+TEST_CASE("channel send and receive return senders", "[channel]") {
+  exec::channel<int> ch{1};
+  STATIC_REQUIRE(ex::sender<decltype(ch.send(1))>);
+  STATIC_REQUIRE(exec::sequence_sender<decltype(ch.receive())>);
+}
+
+TEST_CASE("channel delivers buffered values after close", "[channel]") {
+  exec::channel<int> ch{3};
+  ex::sync_wait(ch.send(1));
+  ex::sync_wait(ch.send(2));
+  ex::sync_wait(ch.send(3));
+  ch.close();
+  std::vector<int> values;
+  ex::sync_wait(consume(ch, values));
+  CHECK(values == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("channel send suspends while the channel is full", "[channel]") {
+  exec::channel<int> ch{1};
+  ex::sync_wait(ch.send(1));
+  bool sent = false;
+  auto op = ex::connect(ch.send(2) | ex::then([&] { sent = true; }), expect_void_receiver{});
+  ex::start(op);
+  CHECK_FALSE(sent);
+
+  std::vector<int> values;
+  auto consumer = ex::connect(consume(ch, values), expect_void_receiver{});
+  ex::start(consumer);
+  CHECK(sent);
+  CHECK(values == std::vector<int>{1, 2});
+  ch.close();
+}
+
+TEST_CASE("channel send after close is stopped", "[channel]") {
+  exec::channel<int> ch{1};
+  ch.close();
+  auto op = ex::connect(ch.send(1), expect_stopped_receiver{});
+  ex::start(op);
+}
+
+TEST_CASE("channel wakes a waiting consumer", "[channel]") {
+  exec::channel<int> ch{0};
+  std::vector<int> values;
+  auto consumer = ex::connect(consume(ch, values), expect_void_receiver{});
+  ex::start(consumer);
+  ex::sync_wait(ch.send(42));
+  CHECK(values == std::vector<int>{42});
+  ch.close();
+}
+
+TEST_CASE("channel bridges producers on a thread pool", "[channel]") {
+  exec::static_thread_pool pool{2};
+  exec::channel<int> ch{4};
+  constexpr int n = 1000;
+  auto produce = [&](int first) {
+    return ex::schedule(pool.get_scheduler()) | ex::then([&ch, first] {
+             for (int i = first; i < first + n; ++i) {
+               ex::sync_wait(ch.send(i));
+             }
+           });
+  };
+  std::vector<int> values;
+  ex::sync_wait(ex::when_all(
+    ex::when_all(produce(0), produce(n)) | ex::then([&] { ch.close(); }), consume(ch, values)));
+  REQUIRE(values.size() == 2 * n);
+  long sum = 0;
+  for (int v: values) {
+    sum += v;
+  }
+  CHECK(sum == (2L * n - 1) * (2L * n) / 2);
+}
+
+TEST_CASE("channel hands every value to one of several consumers", "[channel]") {
+  exec::static_thread_pool pool{4};
+  exec::channel<int> ch{1};
+  constexpr int n = 1000;
+  auto produce = [&](int first) {
+    return ex::schedule(pool.get_scheduler()) | ex::then([&ch, first] {
+             for (int i = first; i < first + n; ++i) {
+               ex::sync_wait(ch.send(i));
+             }
+           });
+  };
+  std::vector<int> first;
+  std::vector<int> second;
+  auto receive = [&](std::vector<int>& values) {
+    return ex::schedule(pool.get_scheduler())
+         | ex::then([&] { ex::sync_wait(consume(ch, values)); });
+  };
+  ex::sync_wait(ex::when_all(
+    ex::when_all(produce(0), produce(n)) | ex::then([&] { ch.close(); }),
+    receive(first),
+    receive(second)));
+  std::vector<int> values = first;
+  values.insert(values.end(), second.begin(), second.end());
+  std::sort(values.begin(), values.end());
+  std::vector<int> expected(2 * n);
+  std::iota(expected.begin(), expected.end(), 0);
+  CHECK(values == expected);
+}
+
+TEST_CASE("channel consumers can be cancelled", "[channel]") {
+  exec::channel<int> ch{1};
+  std::vector<int> values;
+  auto op = ex::connect(
+    ex::when_all(consume(ch, values), ex::just_stopped()), expect_stopped_receiver{});
+  ex::start(op);
+  CHECK(values.empty());
+}
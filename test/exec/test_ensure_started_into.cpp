@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+#include <exec/ensure_started_into.hpp>
+#include <exec/env.hpp>
+#include <test_common/schedulers.hpp>
+#include <test_common/receivers.hpp>
+#include <test_common/type_helpers.hpp>
+
+namespace ex = stdexec;
+
+TEST_CASE("ensure_started_into returns a sender", "[adaptors][ensure_started_into]") {
+  using just_t = decltype(ex::just(19));
+  exec::eager_storage<just_t> storage;
+  {
+    auto snd = exec::ensure_started_into(ex::just(19), storage);
+    static_assert(ex::sender<decltype(snd)>);
+    CHECK(storage.in_use());
+  }
+  CHECK_FALSE(storage.in_use());
+}
+
+TEST_CASE("eager_storage reports the size of the shared state", "[adaptors][ensure_started_into]") {
+  using just_t = decltype(ex::just(19));
+  STATIC_REQUIRE(exec::eager_storage<just_t>::size == exec::eager_state_size_v<just_t>);
+  STATIC_REQUIRE(sizeof(exec::eager_storage<just_t>) >= exec::eager_state_size_v<just_t>);
+}
+
+TEST_CASE("ensure_started_into single value early", "[adaptors][ensure_started_into]") {
+  bool called{false};
+  auto snd1 = ex::just() //
+            | ex::then([&] {
+                called = true;
+                return 42;
+              });
+  exec::eager_storage<decltype(snd1)> storage;
+  CHECK_FALSE(called);
+  {
+    auto snd = exec::ensure_started_into(std::move(snd1), storage);
+    CHECK(called);
+    auto op = ex::connect(std::move(snd), expect_value_receiver{42});
+    ex::start(op);
+  }
+  CHECK_FALSE(storage.in_use());
+}
+
+TEST_CASE("ensure_started_into single value late", "[adaptors][ensure_started_into]") {
+  impulse_scheduler sch;
+  bool called{false};
+  auto snd1 = ex::on(sch, ex::just()) //
+            | ex::then([&] {
+                called = true;
+                return 42;
+              });
+  exec::eager_storage<decltype(snd1)> storage;
+  {
+    auto snd = std::move(snd1) | exec::ensure_started_into(storage);
+    CHECK_FALSE(called);
+    auto op = ex::connect(std::move(snd), expect_value_receiver{42});
+    ex::start(op);
+    CHECK(storage.in_use());
+    // execute the next scheduled item
+    sch.start_next();
+    CHECK(called);
+  }
+  CHECK_FALSE(storage.in_use());
+}
+
+TEST_CASE("ensure_started_into error early", "[adaptors][ensure_started_into]") {
+  auto snd1 = ex::just_error(42);
+  exec::eager_storage<decltype(snd1)> storage;
+  {
+    auto snd = exec::ensure_started_into(std::move(snd1), storage);
+    auto op = ex::connect(std::move(snd), expect_error_receiver{42});
+    ex::start(op);
+  }
+  CHECK_FALSE(storage.in_use());
+}
+
+TEST_CASE(
+  "ensure_started_into requests stop when the sender is discarded",
+  "[adaptors][ensure_started_into]") {
+  impulse_scheduler sch;
+  bool called{false};
+  auto snd1 = ex::on(sch, ex::just()) | ex::then([&] { called = true; });
+  exec::eager_storage<decltype(snd1)> storage;
+  {
+    auto snd = exec::ensure_started_into(std::move(snd1), storage);
+    (void) snd;
+  }
+  // The child operation is still running and keeps the storage alive.
+  CHECK(storage.in_use());
+  sch.start_next();
+  CHECK_FALSE(called);
+  CHECK_FALSE(storage.in_use());
+}
+
+TEST_CASE("eager_storage can be reused", "[adaptors][ensure_started_into]") {
+  using just_t = decltype(ex::just(0));
+  exec::eager_storage<just_t> storage;
+  for (int i = 0; i < 3; ++i) {
+    auto snd = exec::ensure_started_into(ex::just(i), storage);
+    auto op = ex::connect(std::move(snd), expect_value_receiver{i});
+    ex::start(op);
+  }
+  CHECK_FALSE(storage.in_use());
+}
+
+TEST_CASE("ensure_started_into with environment", "[adaptors][ensure_started_into]") {
+  auto env = exec::make_env(exec::with(ex::get_scheduler, inline_scheduler{}));
+  auto snd1 = ex::get_scheduler() | ex::then([](auto) { return 7; });
+  exec::eager_storage<decltype(snd1), decltype(env)> storage;
+  {
+    auto snd = exec::ensure_started_into(std::move(snd1), storage, env);
+    auto op = ex::connect(std::move(snd), expect_value_receiver{7});
+    ex::start(op);
+  }
+  CHECK_FALSE(storage.in_use());
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+#include <stdexec/execution.hpp>
+#include <exec/multi_pool_context.hpp>
+#include <exec/on.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace ex = stdexec;
+
+TEST_CASE("multi_pool_context creates a pool per NUMA node", "[types][multi_pool_context]") {
+  exec::multi_pool_context context;
+  CHECK(context.pool_count() >= 1);
+  CHECK(context.available_parallelism() >= context.pool_count());
+  for (const std::vector<int>& cpus: exec::multi_pool_context::numa_cpu_sets()) {
+    CHECK(!cpus.empty());
+  }
+}
+
+TEST_CASE(
+  "multi_pool_context uses every hardware thread without a CPU topology",
+  "[types][multi_pool_context]") {
+  // This is what the default constructor gets where numa_cpu_sets() finds no CPUs.
+  exec::multi_pool_context context{std::vector<std::vector<int>>{}};
+  const std::uint32_t expected = std::max(1u, std::thread::hardware_concurrency());
+  REQUIRE(context.pool_count() == 1);
+  CHECK(context.available_parallelism() == expected);
+
+  exec::multi_pool_context fallback;
+  CHECK(fallback.available_parallelism() >= 1);
+  if (exec::multi_pool_context::numa_cpu_sets().empty()) {
+    CHECK(fallback.available_parallelism() == expected);
+  }
+}
+
+TEST_CASE("multi_pool_context schedules on its pools", "[types][multi_pool_context]") {
+  exec::multi_pool_context context{std::vector<std::uint32_t>{2, 1}};
+  REQUIRE(context.pool_count() == 2);
+  CHECK(context.available_parallelism() == 3);
+
+  auto sched = context.get_scheduler();
+  CHECK(ex::get_forward_progress_guarantee(sched) == ex::forward_progress_guarantee::parallel);
+  CHECK(ex::get_completion_scheduler<ex::set_value_t>(ex::get_env(ex::schedule(sched))) == sched);
+
+  const std::thread::id main_id = std::this_thread::get_id();
+  for (int i = 0; i < 4; ++i) {
+    auto [id] = ex::sync_wait(ex::schedule(sched) | ex::then([] {
+                                return std::this_thread::get_id();
+                              }))
+                  .value();
+    CHECK(id != main_id);
+  }
+}
+
+TEST_CASE("multi_pool_context binds pools to CPU sets", "[types][multi_pool_context]") {
+  exec::multi_pool_context context{std::vector<std::vector<int>>{{0}, {0}}};
+  REQUIRE(context.pool_count() == 2);
+  CHECK(context.available_parallelism() == 2);
+  int value = 0;
+  ex::sync_wait(ex::schedule(context.get_scheduler()) | ex::then([&] { value = 42; }));
+  CHECK(value == 42);
+}
+
+TEST_CASE("multi_pool_context splits bulk across its pools", "[types][multi_pool_context]") {
+  exec::multi_pool_context context{std::vector<std::uint32_t>{2, 1}};
+  for (int shape: {0, 1, 2, 7, 1000}) {
+    std::vector<std::atomic<int>> visits(static_cast<std::size_t>(shape));
+    auto snd = ex::schedule(context.get_scheduler()) //
+             | ex::then([] { return 7; })
+             | ex::bulk(shape, [&](int i, int k) { visits[i] += k; });
+    auto [k] = ex::sync_wait(std::move(snd)).value();
+    CHECK(k == 7);
+    CHECK(std::all_of(visits.begin(), visits.end(), [](const auto& v) { return v == 7; }));
+  }
+}
+
+TEST_CASE(
+  "multi_pool_context runs a contiguous part of the shape per pool",
+  "[types][multi_pool_context]") {
+  exec::multi_pool_context context{std::vector<std::uint32_t>{2, 1}};
+  std::vector<std::thread::id> owner(30);
+  ex::sync_wait(
+    ex::schedule(context.get_scheduler())
+    | ex::bulk(30, [&](int i) { owner[i] = std::this_thread::get_id(); }));
+  // The first pool has two of the three threads, so it runs the first 20 indices.
+  for (int i = 0; i < 20; ++i) {
+    CHECK(owner[i] != owner[29]);
+  }
+  for (int i = 20; i < 30; ++i) {
+    CHECK(owner[i] == owner[29]);
+  }
+}
+
+TEST_CASE("multi_pool_context forwards bulk exceptions", "[types][multi_pool_context]") {
+  exec::multi_pool_context context{std::vector<std::uint32_t>{1, 1}};
+  auto snd = ex::schedule(context.get_scheduler()) | ex::bulk(10, [](int i) {
+               if (i == 9) {
+                 throw std::logic_error("bulk");
+               }
+             });
+  CHECK_THROWS_AS(ex::sync_wait(std::move(snd)), std::logic_error);
+}
+
+TEST_CASE("multi_pool_context customizes bulk lazily", "[types][multi_pool_context]") {
+  exec::multi_pool_context context{std::vector<std::uint32_t>{1, 2}};
+  std::vector<int> v(64, 0);
+  auto snd = ex::just(2) //
+           | ex::bulk(64, [&](int i, int k) { v[i] = k; })
+           | ex::bulk(64, [&](int i, int k) { v[i] *= k; });
+  auto [k] = ex::sync_wait(exec::on(context.get_scheduler(), std::move(snd))).value();
+  CHECK(k == 2);
+  CHECK(std::count(v.begin(), v.end(), 4) == 64);
+}
@@ -162,3 +162,28 @@ TEST_CASE("repeat_effect_until works when changing threads", "[adaptors][repeat_
 
   REQUIRE(called);
 }
+
+TEST_CASE(
+  "repeat_effect_until repeats a source that completes on another thread",
+  "[adaptors][repeat_effect_until]") {
+  exec::static_thread_pool pool{2};
+  int n = 0;
+  sender auto snd = exec::repeat_effect_until(
+    ex::schedule(pool.get_scheduler()) | ex::then([&n] { return ++n == 1000; }));
+  stdexec::sync_wait(std::move(snd));
+  CHECK(n == 1000);
+}
+
+TEST_CASE(
+  "repeat_effect_until forwards an error from a later iteration",
+  "[adaptors][repeat_effect_until]") {
+  int n = 0;
+  sender auto snd = exec::repeat_effect_until(just() | then([&n] {
+                                                if (++n == 5) {
+                                                  throw std::logic_error("fifth");
+                                                }
+                                                return false;
+                                              }));
+  CHECK_THROWS_AS(stdexec::sync_wait(std::move(snd)), std::logic_error);
+  CHECK(n == 5);
+}
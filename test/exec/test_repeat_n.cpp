@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+#include <stdexec/execution.hpp>
+#include <exec/multi_pool_context.hpp>
+#include <exec/on.hpp>
+#include <exec/repeat_n.hpp>
+#include <exec/static_thread_pool.hpp>
+#include <test_common/receivers.hpp>
+#include <test_common/schedulers.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ex = stdexec;
+
+TEST_CASE("repeat_n returns a sender", "[adaptors][repeat_n]") {
+  auto snd = exec::repeat_n(ex::just(), 3, ex::then([] {}));
+  static_assert(ex::sender_in<decltype(snd), ex::empty_env>);
+  (void) snd;
+}
+
+TEST_CASE("repeat_n runs the closure n times", "[adaptors][repeat_n]") {
+  int n = 0;
+  auto snd = ex::just(42) | exec::repeat_n(5, ex::then([&n] { ++n; }));
+  auto op = ex::connect(std::move(snd), expect_void_receiver{});
+  ex::start(op);
+  CHECK(n == 5);
+}
+
+TEST_CASE("repeat_n with zero iterations completes with no values", "[adaptors][repeat_n]") {
+  int n = 0;
+  auto snd = ex::just() | exec::repeat_n(0, ex::then([&n] { ++n; }));
+  auto op = ex::connect(std::move(snd), expect_void_receiver{});
+  ex::start(op);
+  CHECK(n == 0);
+}
+
+TEST_CASE("repeat_n forwards the completions of its predecessor", "[adaptors][repeat_n]") {
+  int n = 0;
+  {
+    auto snd = ex::just_error(std::string("error")) | exec::repeat_n(2, ex::then([&n] { ++n; }));
+    auto op = ex::connect(std::move(snd), expect_error_receiver{std::string("error")});
+    ex::start(op);
+  }
+  {
+    auto snd = ex::just_stopped() | exec::repeat_n(2, ex::then([&n] { ++n; }));
+    auto op = ex::connect(std::move(snd), expect_stopped_receiver{});
+    ex::start(op);
+  }
+  CHECK(n == 0);
+}
+
+TEST_CASE("repeat_n stops at the first iteration that fails", "[adaptors][repeat_n]") {
+  int n = 0;
+  auto snd = ex::just() | exec::repeat_n(10, ex::then([&n] {
+                                           if (++n == 3) {
+                                             throw std::logic_error("third");
+                                           }
+                                         }));
+  CHECK_THROWS_AS(ex::sync_wait(std::move(snd)), std::logic_error);
+  CHECK(n == 3);
+}
+
+TEST_CASE("repeat_n doesn't blow the stack", "[adaptors][repeat_n]") {
+  int n = 0;
+  ex::sync_wait(ex::just() | exec::repeat_n(1'000'000, ex::then([&n] { ++n; })));
+  CHECK(n == 1'000'000);
+}
+
+TEST_CASE("repeat_n resumes iterations that complete later", "[adaptors][repeat_n]") {
+  impulse_scheduler sched;
+  int n = 0;
+  auto snd = ex::just()
+           | exec::repeat_n(3, ex::let_value([&] {
+                              return ex::schedule(sched) | ex::then([&n] { ++n; });
+                            }));
+  bool done = false;
+  auto op = ex::connect(std::move(snd), expect_void_receiver_ex{done});
+  ex::start(op);
+  for (int i = 0; i < 3; ++i) {
+    CHECK(n == i);
+    CHECK_FALSE(done);
+    sched.start_next();
+  }
+  CHECK(n == 3);
+  CHECK(done);
+}
+
+TEST_CASE("repeat_n of bulk runs every iteration on static_thread_pool", "[adaptors][repeat_n]") {
+  exec::static_thread_pool pool{4};
+  constexpr int n = 9;
+  constexpr int iterations = 100;
+  std::vector<int> a(n, 0);
+  std::vector<int> b(n, 0);
+
+  // Each stage reads what the other stage wrote for all indices in the
+  // previous step, so the iterations and stages must not overlap.
+  auto step = ex::bulk(n, [&](int i) { a[i] = b[(i + 1) % n] + 1; })
+            | ex::bulk(n, [&](int i) { b[i] = a[(i + 1) % n]; });
+  ex::sync_wait(exec::on(pool.get_scheduler(), ex::just() | exec::repeat_n(iterations, step)));
+
+  for (int i = 0; i < n; ++i) {
+    CHECK(a[i] == iterations);
+    CHECK(b[i] == iterations);
+  }
+}
+
+TEST_CASE("repeat_n of bulk on static_thread_pool forwards exceptions", "[adaptors][repeat_n]") {
+  exec::static_thread_pool pool{2};
+  std::atomic<int> calls{0};
+  auto snd = ex::schedule(pool.get_scheduler()) //
+           | exec::repeat_n(10, ex::bulk(4, [&](int i) {
+                              if (calls.fetch_add(1) == 5) {
+                                throw std::logic_error("sixth");
+                              }
+                            }));
+  CHECK_THROWS_AS(ex::sync_wait(std::move(snd)), std::logic_error);
+  // The iteration that failed is finished, but no further one is started.
+  CHECK(calls.load() <= 8);
+}
+
+TEST_CASE("repeat_n of other closures on static_thread_pool is generic", "[adaptors][repeat_n]") {
+  exec::static_thread_pool pool{2};
+  int n = 0;
+  ex::sync_wait(
+    ex::schedule(pool.get_scheduler())
+    | exec::repeat_n(4, ex::bulk(2, [](int) noexcept {}) | ex::then([&n] { ++n; })));
+  CHECK(n == 4);
+}
+
+namespace {
+  // The threads that ran a bulk function, which takes long enough for every
+  // thread of a pool to pick up its part.
+  struct thread_recorder {
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+
+    auto record() {
+      return [this](int) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::lock_guard lock{mutex};
+        threads.insert(std::this_thread::get_id());
+      };
+    }
+  };
+}
+
+TEST_CASE(
+  "repeat_n runs a bulk of the closure on the scheduler of its predecessor",
+  "[adaptors][repeat_n]") {
+  SECTION("multi_pool_context") {
+    exec::multi_pool_context context{std::vector<std::uint32_t>{2, 2}};
+    thread_recorder recorder;
+    ex::sync_wait(
+      ex::schedule(context.get_scheduler()) | exec::repeat_n(3, ex::bulk(16, recorder.record())));
+    CHECK(recorder.threads.size() > 1);
+  }
+  SECTION("static_thread_pool, with a closure that isn't only bulks") {
+    exec::static_thread_pool pool{4};
+    thread_recorder recorder;
+    int n = 0;
+    ex::sync_wait(
+      ex::schedule(pool.get_scheduler())
+      | exec::repeat_n(3, ex::bulk(16, recorder.record()) | ex::then([&n] { ++n; })));
+    CHECK(n == 3);
+    CHECK(recorder.threads.size() > 1);
+  }
+}
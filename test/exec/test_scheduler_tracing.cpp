@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+#include <stdexec/execution.hpp>
+#include <exec/repeat_n.hpp>
+#include <exec/scheduler_tracing.hpp>
+#include <exec/static_thread_pool.hpp>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+static_assert(
+  STDEXEC_SCHEDULER_TRACING,
+  "The scheduler tracing tests need the tasks to be recorded; "
+  "build them with STDEXEC_SCHEDULER_TRACING defined to 1.");
+
+namespace ex = stdexec;
+using namespace std::chrono_literals;
+
+TEST_CASE("latency_histogram reports percentiles within its precision", "[scheduler_tracing]") {
+  exec::latency_histogram histogram;
+  CHECK(histogram.percentile(0.5) == 0);
+  for (std::uint64_t i = 1; i <= 1000; ++i) {
+    histogram.record(i * 1000);
+  }
+  CHECK(histogram.count() == 1000);
+  CHECK(histogram.max() == 1'000'000);
+  CHECK(histogram.mean() == Approx(500'500.0));
+  CHECK(histogram.percentile(1.0) == 1'000'000);
+  for (double fraction: {0.1, 0.5, 0.9, 0.99}) {
+    const double expected = fraction * 1'000'000.0;
+    const double actual = static_cast<double>(histogram.percentile(fraction));
+    CHECK(actual >= expected);
+    CHECK(actual <= expected * (1.0 + 1.0 / 16.0));
+  }
+
+  exec::latency_histogram small;
+  small.record(3);
+  histogram.merge(small);
+  CHECK(histogram.count() == 1001);
+  CHECK(histogram.percentile(0.0) == 3);
+}
+
+TEST_CASE("static_thread_pool records the tasks it runs", "[scheduler_tracing]") {
+  exec::reset_scheduler_tracing();
+  {
+    exec::static_thread_pool pool{2};
+    ex::sync_wait(ex::schedule(pool.get_scheduler()) | ex::then([] {
+                    std::this_thread::sleep_for(1ms);
+                  }));
+    ex::sync_wait(ex::schedule(pool.get_scheduler()) | ex::bulk(4, [](int) noexcept {}));
+    // A task is recorded after it completes; joining the pool waits for that.
+  }
+
+  // One task for each schedule and one for each thread that runs the bulk.
+  std::vector<exec::scheduler_latency> latencies = exec::get_scheduler_latencies();
+  REQUIRE(latencies.size() == 1);
+  CHECK(latencies[0].scheduler == "static_thread_pool");
+  CHECK(latencies[0].queue_delay.count() == 4);
+  CHECK(latencies[0].execution.count() == 4);
+  CHECK(latencies[0].execution.max() >= 1'000'000);
+
+  std::vector<exec::scheduler_trace_event> events = exec::get_scheduler_trace_events();
+  REQUIRE(events.size() == 4);
+  for (const exec::scheduler_trace_event& event: events) {
+    CHECK(event.enqueued <= event.started);
+    CHECK(event.started <= event.finished);
+  }
+
+  std::ostringstream trace;
+  exec::write_chrome_trace(trace);
+  CHECK(trace.str().find("\"traceEvents\"") != std::string::npos);
+  CHECK(trace.str().find("\"cat\":\"static_thread_pool\",\"ph\":\"X\"") != std::string::npos);
+}
+
+TEST_CASE("the number of logged tasks per thread is bounded", "[scheduler_tracing]") {
+  exec::reset_scheduler_tracing();
+  const std::size_t limit = exec::get_scheduler_trace_event_limit();
+  exec::set_scheduler_trace_event_limit(2);
+  {
+    exec::static_thread_pool pool{1};
+    for (int i = 0; i < 5; ++i) {
+      ex::sync_wait(ex::schedule(pool.get_scheduler()));
+    }
+  }
+  exec::set_scheduler_trace_event_limit(limit);
+
+  CHECK(exec::get_scheduler_trace_events().size() == 2);
+  CHECK(exec::get_scheduler_trace_dropped_events() == 3);
+  CHECK(exec::get_scheduler_latencies().at(0).queue_delay.count() == 5);
+}
+
+TEST_CASE(
+  "repeat_n of bulk dispatches once on static_thread_pool",
+  "[scheduler_tracing][repeat_n]") {
+  std::vector<int> v(8, 0);
+  exec::reset_scheduler_tracing();
+  {
+    exec::static_thread_pool pool{2};
+    auto snd = ex::schedule(pool.get_scheduler())
+             | exec::repeat_n(50, ex::bulk(8, [&](int i) noexcept { ++v[i]; }));
+    ex::sync_wait(std::move(snd));
+  }
+  for (int x: v) {
+    CHECK(x == 50);
+  }
+  // One task for the schedule and one for each thread that runs the bulk.
+  std::vector<exec::scheduler_latency> latencies = exec::get_scheduler_latencies();
+  REQUIRE(latencies.size() == 1);
+  CHECK(latencies[0].execution.count() == 3);
+}
+
+// io_uring_context is only tested where the kernel lets us set up a ring.
+#if STDEXEC_ENABLE_IO_URING_TESTS
+#include <exec/linux/io_uring_context.hpp>
+#include <exec/when_any.hpp>
+
+TEST_CASE("io_uring_context - traces scheduled operations", "[scheduler_tracing][io_uring]") {
+  exec::io_uring_context context;
+  exec::io_uring_scheduler scheduler = context.get_scheduler();
+  exec::reset_scheduler_tracing();
+  ex::sync_wait(exec::when_any(
+    ex::when_all(ex::schedule(scheduler), exec::schedule_after(scheduler, 1ms)) | ex::then([] {}),
+    context.run()));
+  std::vector<exec::scheduler_latency> latencies = exec::get_scheduler_latencies();
+  REQUIRE(latencies.size() == 1);
+  CHECK(latencies[0].scheduler == "io_uring_context");
+  CHECK(latencies[0].queue_delay.count() >= 2);
+  // The timer is waited on in the kernel, which counts as queue delay.
+  CHECK(latencies[0].queue_delay.max() >= 1'000'000);
+}
+#endif
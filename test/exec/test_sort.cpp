@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+#include <stdexec/execution.hpp>
+#include <exec/env.hpp>
+#include <exec/inline_scheduler.hpp>
+#include <exec/sort.hpp>
+#include <exec/static_thread_pool.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace ex = stdexec;
+
+namespace {
+  std::vector<int> random_values(std::size_t n, int max) {
+    std::mt19937 gen{static_cast<std::uint32_t>(n)};
+    std::uniform_int_distribution<int> dist{0, max};
+    std::vector<int> v(n);
+    std::generate(v.begin(), v.end(), [&] { return dist(gen); });
+    return v;
+  }
+
+  // Neither copyable nor default constructible, so the algorithms may only
+  // move the values around.
+  struct move_only_key {
+    std::unique_ptr<int> key_;
+
+    explicit move_only_key(int key)
+      : key_(std::make_unique<int>(key)) {
+    }
+
+    friend bool operator<(const move_only_key& a, const move_only_key& b) noexcept {
+      return *a.key_ < *b.key_;
+    }
+  };
+
+  std::vector<move_only_key> move_only_keys(const std::vector<int>& keys) {
+    std::vector<move_only_key> v;
+    v.reserve(keys.size());
+    for (int key: keys) {
+      v.emplace_back(key);
+    }
+    return v;
+  }
+
+  std::vector<int> keys_of(const std::vector<move_only_key>& v) {
+    std::vector<int> keys;
+    keys.reserve(v.size());
+    for (const move_only_key& k: v) {
+      keys.push_back(*k.key_);
+    }
+    return keys;
+  }
+
+  template <class T>
+  struct counting_allocator {
+    using value_type = T;
+    int* count_;
+
+    explicit counting_allocator(int* count) noexcept
+      : count_(count) {
+    }
+
+    template <class U>
+    counting_allocator(const counting_allocator<U>& other) noexcept
+      : count_(other.count_) {
+    }
+
+    T* allocate(std::size_t n) {
+      ++*count_;
+      return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+      std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <class U>
+    friend bool operator==(const counting_allocator& a, const counting_allocator<U>& b) noexcept {
+      return a.count_ == b.count_;
+    }
+  };
+}
+
+TEST_CASE("sort on static_thread_pool sorts like std::sort", "[adaptors][sort]") {
+  exec::static_thread_pool pool{4};
+  for (std::size_t n: {0, 1, 2, 100, 4097, 100'000}) {
+    std::vector<int> v = random_values(n, 1 << 20);
+    std::vector<int> expected = v;
+    std::sort(expected.begin(), expected.end());
+    ex::sync_wait(exec::sort(pool.get_scheduler(), v));
+    CHECK(v == expected);
+  }
+}
+
+TEST_CASE("sort on static_thread_pool takes a comparator", "[adaptors][sort]") {
+  exec::static_thread_pool pool{3};
+  std::vector<int> v = random_values(50'000, 1 << 20);
+  std::vector<int> expected = v;
+  std::sort(expected.begin(), expected.end(), std::greater<>{});
+  ex::sync_wait(exec::sort(pool.get_scheduler(), v, std::greater<>{}));
+  CHECK(v == expected);
+}
+
+TEST_CASE("sort on static_thread_pool handles many equal values", "[adaptors][sort]") {
+  exec::static_thread_pool pool{4};
+  for (int max: {0, 1, 7}) {
+    std::vector<int> v = random_values(60'000, max);
+    std::vector<int> expected = v;
+    std::sort(expected.begin(), expected.end());
+    ex::sync_wait(exec::sort(pool.get_scheduler(), v));
+    CHECK(v == expected);
+  }
+}
+
+TEST_CASE("sort sorts a subrange", "[adaptors][sort]") {
+  exec::static_thread_pool pool{2};
+  std::vector<int> v = random_values(30'000, 1000);
+  std::vector<int> expected = v;
+  std::sort(expected.begin() + 10, expected.end() - 10);
+  ex::sync_wait(
+    exec::sort(pool.get_scheduler(), std::ranges::subrange(v.begin() + 10, v.end() - 10)));
+  CHECK(v == expected);
+}
+
+TEST_CASE("sort runs std::sort on other schedulers", "[adaptors][sort]") {
+  std::vector<int> v = random_values(1000, 100);
+  std::vector<int> expected = v;
+  std::sort(expected.begin(), expected.end());
+  ex::sync_wait(exec::sort(exec::inline_scheduler{}, v));
+  CHECK(v == expected);
+}
+
+TEST_CASE(
+  "sort and stable_partition allocate once with the receiver's allocator",
+  "[adaptors][sort]") {
+  exec::static_thread_pool pool{4};
+  std::vector<int> v = random_values(100'000, 1 << 20);
+  std::vector<int> expected = v;
+  std::sort(expected.begin(), expected.end());
+  int allocations = 0;
+  ex::sync_wait(
+    exec::sort(pool.get_scheduler(), v)
+    | exec::write(exec::with(ex::get_allocator, counting_allocator<std::byte>{&allocations})));
+  CHECK(v == expected);
+  // The buffer, its slices, the samples, the bounds and the runs, all at once.
+  CHECK(allocations == 1);
+
+  allocations = 0;
+  auto is_odd = [](int i) {
+    return i % 2 != 0;
+  };
+  ex::sync_wait(
+    exec::stable_partition(pool.get_scheduler(), v, is_odd)
+    | exec::write(exec::with(ex::get_allocator, counting_allocator<std::byte>{&allocations})));
+  CHECK(allocations == 1);
+}
+
+TEST_CASE("sort and stable_partition move values that cannot be copied", "[adaptors][sort]") {
+  exec::static_thread_pool pool{4};
+  std::vector<int> keys = random_values(50'000, 1 << 20);
+
+  std::vector<move_only_key> v = move_only_keys(keys);
+  std::vector<int> expected = keys;
+  std::sort(expected.begin(), expected.end());
+  ex::sync_wait(exec::sort(pool.get_scheduler(), v));
+  CHECK(keys_of(v) == expected);
+
+  auto is_even = [](const move_only_key& k) {
+    return *k.key_ % 2 == 0;
+  };
+  v = move_only_keys(keys);
+  expected = keys;
+  auto expected_mid = std::stable_partition(expected.begin(), expected.end(), [](int key) {
+    return key % 2 == 0;
+  });
+  auto [mid] = ex::sync_wait(exec::stable_partition(pool.get_scheduler(), v, is_even)).value();
+  CHECK(keys_of(v) == expected);
+  CHECK(mid - v.begin() == expected_mid - expected.begin());
+}
+
+TEST_CASE("stable_partition on static_thread_pool is stable", "[adaptors][sort]") {
+  exec::static_thread_pool pool{4};
+  auto is_even = [](const std::pair<int, int>& p) {
+    return p.first % 2 == 0;
+  };
+  for (std::size_t n: {0, 1, 3, 100, 50'000}) {
+    std::vector<std::pair<int, int>> v(n);
+    std::vector<int> keys = random_values(n, 1000);
+    for (std::size_t i = 0; i < n; ++i) {
+      v[i] = {keys[i], static_cast<int>(i)};
+    }
+    std::vector<std::pair<int, int>> expected = v;
+    auto expected_mid = std::stable_partition(expected.begin(), expected.end(), is_even);
+
+    auto [mid] = ex::sync_wait(exec::stable_partition(pool.get_scheduler(), v, is_even)).value();
+    CHECK(v == expected);
+    CHECK(mid - v.begin() == expected_mid - expected.begin());
+  }
+}
+
+TEST_CASE("stable_partition runs std::stable_partition on other schedulers", "[adaptors][sort]") {
+  std::vector<int> v = random_values(1000, 100);
+  std::vector<int> expected = v;
+  auto is_small = [](int i) {
+    return i < 50;
+  };
+  auto expected_mid = std::stable_partition(expected.begin(), expected.end(), is_small);
+  auto [mid] = ex::sync_wait(exec::stable_partition(exec::inline_scheduler{}, v, is_small)).value();
+  CHECK(v == expected);
+  CHECK(mid - v.begin() == expected_mid - expected.begin());
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+#include <exec/when_range.hpp>
+#include <exec/static_thread_pool.hpp>
+#include <test_common/schedulers.hpp>
+#include <test_common/receivers.hpp>
+#include <test_common/global_new.hpp>
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace ex = stdexec;
+
+TEST_CASE("when_all_range returns a sender", "[adaptors][when_all_range]") {
+  std::vector<decltype(ex::just(1))> senders{ex::just(1), ex::just(2)};
+  auto snd = exec::when_all_range(std::move(senders));
+  STATIC_REQUIRE(ex::sender<decltype(snd)>);
+  STATIC_REQUIRE(
+    ex::__v<ex::__mapply<
+      ex::__contains<ex::set_value_t(std::vector<int>)>,
+      ex::completion_signatures_of_t<decltype(snd), ex::empty_env>>>);
+}
+
+TEST_CASE("when_all_range collects the values in order", "[adaptors][when_all_range]") {
+  std::vector<decltype(ex::just(1))> senders;
+  for (int i = 0; i < 10; ++i) {
+    senders.push_back(ex::just(i));
+  }
+  auto [values] = ex::sync_wait(exec::when_all_range(std::move(senders))).value();
+  CHECK(values == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+}
+
+TEST_CASE("when_all_range of an empty range", "[adaptors][when_all_range]") {
+  std::vector<decltype(ex::just(1))> senders;
+  auto [values] = ex::sync_wait(exec::when_all_range(std::move(senders))).value();
+  CHECK(values.empty());
+}
+
+TEST_CASE("when_all_range of void senders", "[adaptors][when_all_range]") {
+  int count = 0;
+  auto make = [&] {
+    return ex::just() | ex::then([&] { ++count; });
+  };
+  std::vector<decltype(make())> senders{make(), make(), make()};
+  auto op = ex::connect(exec::when_all_range(std::move(senders)), expect_void_receiver{});
+  ex::start(op);
+  CHECK(count == 3);
+}
+
+TEST_CASE("when_all_range forwards the first error", "[adaptors][when_all_range]") {
+  auto make = [](int i) {
+    return ex::just(i) | ex::let_value([](int i) {
+             return ex::just(i) | ex::then([](int i) -> int {
+                      if (i == 2) {
+                        throw i;
+                      }
+                      return i;
+                    });
+           });
+  };
+  std::vector<decltype(make(0))> senders{make(0), make(1), make(2), make(3)};
+  CHECK_THROWS_AS(ex::sync_wait(exec::when_all_range(std::move(senders))), int);
+}
+
+TEST_CASE("when_all_range forwards stop requests to the children", "[adaptors][when_all_range]") {
+  impulse_scheduler sched;
+  std::vector<decltype(ex::on(sched, ex::just()))> senders{
+    ex::on(sched, ex::just()), ex::on(sched, ex::just())};
+  auto op = ex::connect(
+    ex::when_all(exec::when_all_range(std::move(senders)), ex::just_stopped()),
+    expect_stopped_receiver{});
+  ex::start(op);
+  // The children observe the stop request once they are scheduled.
+  sched.start_next();
+  sched.start_next();
+}
+
+namespace {
+  // Counts the allocations made through it.
+  class counting_resource : public std::pmr::memory_resource {
+    std::pmr::memory_resource* upstream_;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+      ++count;
+      return upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+      upstream_->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+
+   public:
+    std::size_t count = 0;
+
+    explicit counting_resource(std::pmr::memory_resource* upstream)
+      : upstream_(upstream) {
+    }
+  };
+}
+
+TEST_CASE("when_all_range uses the given allocator", "[adaptors][when_all_range]") {
+  alignas(std::max_align_t) std::byte buffer[4096];
+  std::pmr::monotonic_buffer_resource upstream{
+    buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+  counting_resource resource{&upstream};
+  std::pmr::polymorphic_allocator<std::byte> alloc{&resource};
+  std::vector<decltype(ex::just(1))> senders{ex::just(1), ex::just(2), ex::just(3)};
+  auto sndr = exec::when_all_range(std::move(senders), alloc);
+  STATIC_REQUIRE(
+    ex::__v<ex::__mapply<
+      ex::__contains<ex::set_value_t(std::pmr::vector<int>)>,
+      ex::completion_signatures_of_t<decltype(sndr), ex::empty_env>>>);
+
+  global_new_counter heap;
+  auto [values] = ex::sync_wait(std::move(sndr)).value();
+  // The children and the result vector come from the resource.
+  CHECK(resource.count == 2);
+  CHECK(heap.count() == 0);
+  CHECK(values.get_allocator().resource() == &resource);
+  CHECK(values == std::pmr::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("when_all_range runs the children on a thread pool", "[adaptors][when_all_range]") {
+  exec::static_thread_pool pool{2};
+  auto make = [&](int i) {
+    return ex::schedule(pool.get_scheduler()) | ex::then([i] { return i * i; });
+  };
+  std::vector<decltype(make(0))> senders;
+  for (int i = 0; i < 100; ++i) {
+    senders.push_back(make(i));
+  }
+  auto [values] = ex::sync_wait(exec::when_all_range(std::move(senders))).value();
+  REQUIRE(values.size() == 100);
+  for (int i = 0; i < 100; ++i) {
+    CHECK(values[i] == i * i);
+  }
+}
+
+TEST_CASE("when_any_range completes with the first value", "[adaptors][when_any_range]") {
+  impulse_scheduler sched;
+  auto make = [&](int i) {
+    return ex::on(sched, ex::just(i));
+  };
+  std::vector<decltype(make(0))> senders{make(1), make(2), make(3)};
+  auto op = ex::connect(exec::when_any_range(std::move(senders)), expect_value_receiver{1});
+  ex::start(op);
+  // The first child completes, the others observe the stop request.
+  sched.start_next();
+  sched.start_next();
+  sched.start_next();
+}
+
+TEST_CASE("when_any_range of an empty range is stopped", "[adaptors][when_any_range]") {
+  std::vector<decltype(ex::just(1))> senders;
+  auto op = ex::connect(exec::when_any_range(std::move(senders)), expect_stopped_receiver{});
+  ex::start(op);
+}
@@ -305,6 +305,76 @@ TEST_CASE("eager customization of bulk works with static thread pool", "[adaptor
   }
 }
 
+TEST_CASE("consecutive bulks are fused on static thread pool", "[adaptors][bulk]") {
+  exec::static_thread_pool pool{4};
+  ex::scheduler auto sch = pool.get_scheduler();
+
+  SECTION("Every bulk sees the results of the previous one") {
+    constexpr int n = 42;
+    std::vector<int> first(n, 0);
+    std::vector<int> second(n, 0);
+
+    auto snd = ex::schedule(sch) //
+             | ex::bulk(
+                 n,
+                 [&](int idx) {
+                   if (idx % 7 == 0) {
+                     std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                   }
+                   first[idx] = idx;
+                 })
+             | ex::bulk(n, [&](int idx) { second[idx] = first[n - 1 - idx] + 1; })
+             | ex::bulk(3, [&](int idx) { second[idx] *= 2; });
+    STATIC_REQUIRE(std::tuple_size_v<decltype(snd.stages_)> == 3);
+    stdexec::sync_wait(std::move(snd));
+
+    for (int idx = 0; idx < n; ++idx) {
+      CHECK(second[idx] == (n - idx) * (idx < 3 ? 2 : 1));
+    }
+  }
+
+  SECTION("Bulks that are customized lazily are fused as well") {
+    constexpr int n = 42;
+    std::vector<int> first(n, 0);
+    std::vector<int> second(n, 0);
+
+    auto snd = ex::just() //
+             | ex::bulk(n, [&](int idx) { first[idx] = idx; })
+             | ex::bulk(n, [&](int idx) { second[idx] = idx + first[n - 1 - idx]; });
+    stdexec::sync_wait(stdexec::on(sch, std::move(snd)));
+
+    CHECK(std::count(second.begin(), second.end(), n - 1) == n);
+  }
+
+  SECTION("An exception skips the following bulks") {
+    bool called = false;
+    auto snd = ex::transfer_just(sch, 42)
+             | ex::bulk(4, [](int idx, int) { throw std::runtime_error("bulk"); })
+             | ex::bulk(4, [&](int, int) { called = true; });
+
+    CHECK_THROWS_AS(stdexec::sync_wait(std::move(snd)), std::runtime_error);
+    CHECK_FALSE(called);
+  }
+
+  SECTION("Concurrent chains do not wait for each other") {
+    constexpr int n = 4;
+    std::vector<int> counters_1(n, 0);
+    std::vector<int> counters_2(n, 0);
+
+    auto chain = [&](std::vector<int>& counters) {
+      return ex::schedule(sch)                                  //
+           | ex::bulk(n, [&](int id) { counters[id]++; })       //
+           | ex::bulk(n, [&](int id) { counters[id]++; });
+    };
+    for (int i = 0; i < 100; ++i) {
+      stdexec::sync_wait(stdexec::when_all(chain(counters_1), chain(counters_2)));
+    }
+
+    CHECK(std::count(counters_1.begin(), counters_1.end(), 200) == n);
+    CHECK(std::count(counters_2.begin(), counters_2.end(), 200) == n);
+  }
+}
+
 TEST_CASE("lazy customization of bulk works with static thread pool", "[adaptors][bulk]") {
   exec::static_thread_pool pool{4};
   ex::scheduler auto sch = pool.get_scheduler();
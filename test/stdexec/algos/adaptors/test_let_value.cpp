@@ -21,6 +21,7 @@
 #include <test_common/type_helpers.hpp>
 #include <exec/static_thread_pool.hpp>
 
+#include <array>
 #include <chrono>
 
 namespace ex = stdexec;
@@ -298,6 +299,22 @@ TEST_CASE("let_value keeps sends_stopped from input sender", "[adaptors][let_val
     ex::transfer_just(sched3) | ex::let_value([] { return ex::just(); }));
 }
 
+TEST_CASE(
+  "let_value reuses the predecessor's operation state for the successor",
+  "[adaptors][let_value]") {
+  using payload_t = std::array<char, 256>;
+  auto pred = ex::just(payload_t{}) | ex::then([](const payload_t& p) { return (int) p.size(); });
+  auto make_succ = [](int n) {
+    return ex::just(payload_t{}) | ex::then([n](const payload_t&) { return n; });
+  };
+  auto snd = ex::let_value(pred, make_succ);
+  using op_t = ex::connect_result_t<decltype(snd), expect_value_receiver<int>>;
+  using pred_op_t = ex::connect_result_t<decltype(pred), expect_value_receiver<int>>;
+  using succ_op_t = ex::connect_result_t<decltype(make_succ(0)), expect_value_receiver<int>>;
+  static_assert(sizeof(op_t) < sizeof(pred_op_t) + sizeof(succ_op_t));
+  wait_for_value(std::move(snd), 256);
+}
+
 // Return a different sender when we invoke this custom defined on implementation
 using my_string_sender_t = decltype(ex::transfer_just(inline_scheduler{}, std::string{}));
 
@@ -180,6 +180,40 @@ TEST_CASE("then keeps sends_stopped from input sender", "[adaptors][then]") {
     ex::transfer_just(sched3) | ex::then([] {}));
 }
 
+TEST_CASE("adjacent thens are fused into a single operation", "[adaptors][then]") {
+  auto f = [](int x) { return x + 1; };
+  auto g = [](int x) { return x * 2; };
+  auto h = [](int x) { return x - 3; };
+  auto fused = ex::just(3) | ex::then(f) | ex::then(g) | ex::then(h);
+  auto single = ex::just(3) | ex::then(f);
+  using fused_op_t = ex::connect_result_t<decltype(fused), expect_value_receiver<int>>;
+  using single_op_t = ex::connect_result_t<decltype(single), expect_value_receiver<int>>;
+  static_assert(sizeof(fused_op_t) == sizeof(single_op_t));
+  wait_for_value(std::move(fused), 5);
+}
+
+TEST_CASE("fused thens pass void results and exceptions along", "[adaptors][then]") {
+  int calls = 0;
+  auto snd = ex::just(1)                      //
+           | ex::then([&](int) { ++calls; })  //
+           | ex::then([&] { return ++calls; }) //
+           | ex::then([](int x) noexcept { return x * 10; });
+  wait_for_value(std::move(snd), 20);
+  CHECK(calls == 2);
+
+  bool called = false;
+  auto throwing = ex::just(1) //
+                | ex::then([](int x) -> int { throw std::logic_error{"err"}; })
+                | ex::then([&](int x) noexcept {
+                    called = true;
+                    return x;
+                  });
+  check_err_types<type_array<std::exception_ptr>>(throwing);
+  auto op = ex::connect(std::move(throwing), expect_error_receiver{});
+  ex::start(op);
+  CHECK(!called);
+}
+
 // Return a different sender when we invoke this custom defined on implementation
 using my_string_sender_t = decltype(ex::transfer_just(inline_scheduler{}, std::string{}));
 
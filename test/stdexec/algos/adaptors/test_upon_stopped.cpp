@@ -47,3 +47,21 @@ TEST_CASE("upon_stopped simple example", "[adaptors][upon_stopped]") {
   // we also check that the function was invoked
   CHECK(called);
 }
+
+TEST_CASE(
+  "upon_stopped of upon_stopped is collapsed to the inner one",
+  "[adaptors][upon_stopped]") {
+  bool outer_called{false};
+  auto snd = ex::just_stopped()                 //
+           | ex::upon_stopped([] { return 1; }) //
+           | ex::upon_stopped([&] {
+               outer_called = true;
+               return 2;
+             });
+  auto single = ex::just_stopped() | ex::upon_stopped([] { return 1; });
+  using op_t = ex::connect_result_t<decltype(snd), expect_value_receiver<int>>;
+  using single_op_t = ex::connect_result_t<decltype(single), expect_value_receiver<int>>;
+  static_assert(sizeof(op_t) == sizeof(single_op_t));
+  wait_for_value(std::move(snd), 1);
+  CHECK(!outer_called);
+}
@@ -20,6 +20,13 @@
 #include <test_common/receivers.hpp>
 #include <test_common/type_helpers.hpp>
 
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
 namespace ex = stdexec;
 
 // For testing `when_all_with_variant`, we just check a couple of examples, check customization, and
@@ -138,6 +145,61 @@ TEST_CASE("when_all completes when children complete", "[adaptors][when_all]") {
   CHECK(called);
 }
 
+TEST_CASE(
+  "when_all keeps the values of children that complete on schedulers",
+  "[adaptors][when_all]") {
+  // Children that complete on a scheduler get padded result storage.
+  impulse_scheduler sched;
+  std::string result;
+  ex::sender auto snd =                                  //
+    ex::when_all(                                        //
+      ex::transfer_just(sched, std::string("padded")),   //
+      ex::just(std::vector<int>{1, 2, 3}),               //
+      ex::transfer_just(sched, 4, std::string("slots"))) //
+    | ex::then([&](std::string a, std::vector<int> b, int c, std::string d) {
+        result = a + std::to_string(b.size()) + std::to_string(c) + d;
+      });
+  auto op = ex::connect(std::move(snd), expect_void_receiver{});
+  ex::start(op);
+  sched.start_next();
+  CHECK(result.empty());
+  sched.start_next();
+  CHECK(result == "padded34slots");
+}
+
+TEST_CASE(
+  "when_all pads its storage only when children complete on schedulers",
+  "[adaptors][when_all]") {
+  constexpr std::size_t pad = STDEXEC_DESTRUCTIVE_INTERFERENCE_SIZE;
+  using on_sched_t = decltype(ex::transfer_just(std::declval<impulse_scheduler>(), 1));
+  using inline_t = decltype(ex::just(2));
+  using slot_t = std::optional<std::tuple<int>>;
+
+  // With a child that completes on a scheduler, every slot is followed by
+  // a cache line of padding.
+  using padded_t = ex::__when_all::__traits_<ex::empty_env, on_sched_t, inline_t>;
+  using padded_values_t = padded_t::__values_tuple;
+  STATIC_REQUIRE(padded_t::__padded);
+  STATIC_REQUIRE(sizeof(std::tuple_element_t<0, padded_values_t>) >= sizeof(slot_t) + pad);
+  STATIC_REQUIRE(sizeof(std::tuple_element_t<1, padded_values_t>) >= sizeof(slot_t) + pad);
+
+  // Without such a child, or with a single child, the slots are not padded.
+  using packed_t = ex::__when_all::__traits_<ex::empty_env, inline_t, inline_t>;
+  STATIC_REQUIRE(!packed_t::__padded);
+  STATIC_REQUIRE(std::same_as<packed_t::__values_tuple, std::tuple<slot_t, slot_t>>);
+  using single_t = ex::__when_all::__traits_<ex::empty_env, on_sched_t>;
+  STATIC_REQUIRE(!single_t::__padded);
+  STATIC_REQUIRE(std::same_as<single_t::__values_tuple, std::tuple<slot_t>>);
+
+  // The count is padded on both sides along with the slots.
+  using receiver_id = ex::__id<expect_void_receiver<>>;
+  using errors_t = std::variant<std::monostate>;
+  using padded_op_t = ex::__when_all::__operation_base<receiver_id, padded_values_t, errors_t>;
+  using packed_op_t =
+    ex::__when_all::__operation_base<receiver_id, packed_t::__values_tuple, errors_t>;
+  STATIC_REQUIRE(sizeof(padded_op_t) >= sizeof(packed_op_t) + 4 * pad);
+}
+
 TEST_CASE("when_all can be used with just_*", "[adaptors][when_all]") {
   ex::sender auto snd = ex::when_all(     //
     ex::just(2),                          //
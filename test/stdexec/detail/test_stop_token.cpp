@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+#include <stdexec/stop_token.hpp>
+
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace stdexec;
+
+namespace {
+  struct count_fn {
+    int* count_;
+
+    void operator()() const noexcept {
+      ++*count_;
+    }
+  };
+
+  using count_callback = in_place_stop_callback<count_fn>;
+}
+
+TEST_CASE("in_place_stop_callback runs on request_stop", "[stop_token][in_place_stop_source]") {
+  in_place_stop_source source;
+  int count = 0;
+  {
+    count_callback cb1{source.get_token(), count_fn{&count}};
+    count_callback cb2{source.get_token(), count_fn{&count}};
+    CHECK(count == 0);
+    source.request_stop();
+    CHECK(count == 2);
+    CHECK(source.stop_requested());
+  }
+  CHECK(count == 2);
+}
+
+TEST_CASE(
+  "in_place_stop_callback registered after stop runs inline",
+  "[stop_token][in_place_stop_source]") {
+  in_place_stop_source source;
+  source.request_stop();
+  int count = 0;
+  count_callback cb{source.get_token(), count_fn{&count}};
+  CHECK(count == 1);
+}
+
+TEST_CASE(
+  "in_place_stop_callback can be removed in any order",
+  "[stop_token][in_place_stop_source]") {
+  in_place_stop_source source;
+  int count = 0;
+  std::optional<count_callback> cbs[4];
+  for (auto& cb: cbs) {
+    cb.emplace(source.get_token(), count_fn{&count});
+  }
+  // Not in reverse registration order
+  cbs[1].reset();
+  cbs[3].reset();
+  count_callback late{source.get_token(), count_fn{&count}};
+  cbs[0].reset();
+  source.request_stop();
+  CHECK(count == 2);
+  cbs[2].reset();
+}
+
+TEST_CASE(
+  "in_place_stop_callback can be removed from within its callback",
+  "[stop_token][in_place_stop_source]") {
+  in_place_stop_source source;
+  int count = 0;
+  struct fn {
+    std::optional<in_place_stop_callback<fn>>* self_;
+    int* count_;
+
+    void operator()() const noexcept {
+      ++*count_;
+      self_->reset();
+    }
+  };
+
+  std::optional<in_place_stop_callback<fn>> cb;
+  cb.emplace(source.get_token(), fn{&cb, &count});
+  source.request_stop();
+  CHECK(count == 1);
+  CHECK(!cb.has_value());
+}
+
+TEST_CASE(
+  "in_place_stop_source handles concurrent registration and stop",
+  "[stop_token][in_place_stop_source]") {
+  for (int iteration = 0; iteration < 20; ++iteration) {
+    in_place_stop_source source;
+    std::atomic<int> fired{0};
+    std::atomic<bool> go{false};
+    auto fire = [&]() noexcept {
+      fired.fetch_add(1, std::memory_order_relaxed);
+    };
+    using callback_t = in_place_stop_callback<decltype(fire)>;
+
+    const int num_threads = 4;
+    std::vector<std::thread> threads;
+    std::atomic<int> leftover{0};
+    for (int t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&] {
+        while (!go.load()) {
+          std::this_thread::yield();
+        }
+        for (int i = 0; i < 200; ++i) {
+          std::optional<callback_t> a, b;
+          a.emplace(source.get_token(), fire);
+          b.emplace(source.get_token(), fire);
+          // Alternate between in-order and out-of-order removal
+          if (i % 2) {
+            a.reset();
+          }
+        }
+        callback_t last{source.get_token(), fire};
+        leftover.fetch_add(1);
+        while (!source.stop_requested()) {
+          std::this_thread::yield();
+        }
+      });
+    }
+    go.store(true);
+    while (leftover.load() != num_threads) {
+      std::this_thread::yield();
+    }
+    source.request_stop();
+    for (auto& t: threads) {
+      t.join();
+    }
+    // Each thread's last callback was registered before the stop request.
+    CHECK(fired.load() >= num_threads);
+  }
+}
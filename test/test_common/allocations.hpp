@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <catch2/catch.hpp>
+#include <stdexec/execution.hpp>
+#include <exec/allocation_hooks.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <utility>
+
+static_assert(
+  STDEXEC_ALLOCATION_HOOKS,
+  "The allocation tests need the library allocations to be reported; "
+  "build them with STDEXEC_ALLOCATION_HOOKS defined to 1.");
+
+namespace ex = stdexec;
+
+// Counts the allocations that stdexec and exec report while it is alive, or
+// only those of the given algorithm. Only one allocation_counter may exist at
+// a time.
+class allocation_counter {
+  static inline std::atomic<std::size_t> count_{0};
+  static inline std::atomic<const char*> last_algorithm_{nullptr};
+  static inline std::atomic<const char*> algorithm_{nullptr};
+
+  static void hook(const char* algorithm, std::size_t) noexcept {
+    const char* only = algorithm_.load();
+    if (only == nullptr || std::strcmp(algorithm, only) == 0) {
+      last_algorithm_.store(algorithm);
+      count_.fetch_add(1);
+    }
+  }
+
+  exec::allocation_hook_t previous_;
+  std::size_t start_;
+
+ public:
+  explicit allocation_counter(const char* algorithm = nullptr) {
+    algorithm_.store(algorithm);
+    previous_ = exec::set_allocation_hook(&hook);
+    start_ = count_.load();
+  }
+
+  ~allocation_counter() {
+    exec::set_allocation_hook(previous_);
+    algorithm_.store(nullptr);
+  }
+
+  allocation_counter(allocation_counter&&) = delete;
+
+  std::size_t count() const noexcept {
+    return count_.load() - start_;
+  }
+
+  // The algorithm that made the most recent allocation, or "" if none did.
+  std::string last_algorithm() const {
+    const char* algorithm = count() == 0 ? nullptr : last_algorithm_.load();
+    return algorithm == nullptr ? "" : algorithm;
+  }
+};
+
+// Wraps another receiver and checks, when the operation completes, that no
+// allocations were reported since the given counter was created. Create the
+// counter before the senders, since some of them allocate on construction.
+//
+//   allocation_counter allocations;
+//   auto op = ex::connect(
+//     ex::just(1) | ex::then(f),
+//     expect_no_allocations_receiver{allocations, expect_value_receiver{2}});
+template <class Receiver>
+class expect_no_allocations_receiver {
+  const allocation_counter* counter_;
+  Receiver rcvr_;
+
+  void check() const {
+    INFO("allocated by " << counter_->last_algorithm());
+    CHECK(counter_->count() == 0);
+  }
+
+ public:
+  using is_receiver = void;
+
+  expect_no_allocations_receiver(const allocation_counter& counter, Receiver rcvr)
+    : counter_(&counter)
+    , rcvr_(std::move(rcvr)) {
+  }
+
+  template <ex::__completion_tag Tag, class... Args>
+    requires ex::__callable<Tag, Receiver, Args...>
+  friend void tag_invoke(Tag tag, expect_no_allocations_receiver&& self, Args&&... args) noexcept {
+    self.check();
+    tag(std::move(self.rcvr_), (Args&&) args...);
+  }
+
+  friend ex::env_of_t<Receiver>
+    tag_invoke(ex::get_env_t, const expect_no_allocations_receiver& self) noexcept {
+    return ex::get_env(self.rcvr_);
+  }
+};
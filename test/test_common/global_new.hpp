@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2023 NVIDIA Corporation
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+// The number of calls of the global operator new on the current thread. The
+// replacement operators are defined in global_new.cpp, which has to be part
+// of the test executable.
+std::size_t global_new_count() noexcept;
+
+// Counts the calls of the global operator new on the current thread while it
+// is alive.
+//
+//   global_new_counter allocations;
+//   ex::sync_wait(sndr);
+//   CHECK(allocations.count() == 0);
+class global_new_counter {
+  std::size_t start_ = global_new_count();
+
+ public:
+  std::size_t count() const noexcept {
+    return global_new_count() - start_;
+  }
+};